@@ -100,4 +100,9 @@ struct KeyPair {
 
 using BinaryArray = std::vector<uint8_t>;
 
+struct RawBlock {
+  BinaryArray block; //Block
+  std::vector<BinaryArray> transactions;
+};
+
 }
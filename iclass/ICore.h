@@ -59,6 +59,8 @@ public:
   virtual void pause_mining() = 0;
   virtual void update_block_template_and_resume_mining() = 0;
   virtual bool handle_incoming_block_blob(const CryptoNote::BinaryArray& block_blob, CryptoNote::block_verification_context& bvc, bool control_miner, bool relay_block) = 0;
+  virtual bool handle_incoming_block(const Block& b, CryptoNote::block_verification_context& bvc, bool control_miner, bool relay_block) = 0;
+  virtual void precomputeProofOfWork(const std::vector<const Block*>& blocks) = 0;
   virtual bool handle_get_objects(NOTIFY_REQUEST_GET_OBJECTS_request& arg, NOTIFY_RESPONSE_GET_OBJECTS_request& rsp) = 0; //Deprecated. Should be removed with CryptoNoteProtocolHandler.
   virtual void on_synchronized() = 0;
   virtual size_t addChain(const std::vector<const IBlock*>& chain) = 0;
@@ -71,7 +73,11 @@ public:
   virtual bool getOutByMSigGIndex(uint64_t amount, uint64_t gindex, MultisignatureOutput& out) = 0;
   virtual i_cryptonote_protocol* get_protocol() = 0;
   virtual bool handle_incoming_tx(const BinaryArray& tx_blob, tx_verification_context& tvc, bool keeped_by_block) = 0; //Deprecated. Should be removed with CryptoNoteProtocolHandler.
+  virtual bool handle_incoming_tx(const Transaction& tx, const Crypto::Hash& txHash, size_t blobSize, tx_verification_context& tvc, bool keeped_by_block) = 0;
+  // Relayed transactions, checked in parallel and added to the pool one by one. tvcs[i] is the result of tx_blobs[i].
+  virtual void handle_incoming_txs(const std::vector<BinaryArray>& tx_blobs, std::vector<tx_verification_context>& tvcs) = 0;
   virtual std::vector<Transaction> getPoolTransactions() = 0;
+  virtual void getTransactionsMissingFromPool(const std::vector<Crypto::Hash>& txIds, std::vector<Crypto::Hash>& missedTxIds) = 0;
   virtual bool getPoolChanges(const Crypto::Hash& tailBlockId, const std::vector<Crypto::Hash>& knownTxsIds,
                               std::vector<Transaction>& addedTxs, std::vector<Crypto::Hash>& deletedTxsIds) = 0;
   virtual bool getPoolChangesLite(const Crypto::Hash& tailBlockId, const std::vector<Crypto::Hash>& knownTxsIds,
@@ -70,6 +70,7 @@ namespace parameters {
 #define CRYPTONOTE_MEMPOOL_TX_LIVETIME                                (60 * 60 * 14) // seconds, 14 hours
 #define CRYPTONOTE_MEMPOOL_TX_FROM_ALT_BLOCK_LIVETIME                 (60 * 60 * 24) // seconds, one day
 #define CRYPTONOTE_NUMBER_OF_PERIODS_TO_FORGET_TX_DELETED_FROM_POOL   7 // CRYPTONOTE_NUMBER_OF_PERIODS_TO_FORGET_TX_DELETED_FROM_POOL * CRYPTONOTE_MEMPOOL_TX_LIVETIME = time to forget tx
+#define CRYPTONOTE_MEMPOOL_FEE_RATE_HALF_LIFE                        (60 * 60 * 12) // seconds, the fee rate raised by a full pool halves every 12 hours
 
 #define FUSION_TX_MAX_SIZE                              CRYPTONOTE_BLOCK_GRANTED_FULL_REWARD_ZONE_CURRENT * 30 / 100
 #define FUSION_TX_MIN_INPUT_COUNT                       12
@@ -89,6 +90,9 @@ namespace parameters {
 #define CRYPTONOTE_POOLDATA_FILENAME                    "poolstate.bin"
 #define P2P_NET_DATA_FILENAME                           "p2pstate.bin"
 #define CRYPTONOTE_BLOCKCHAIN_INDICES_FILENAME          "blockchainindices.dat"
+#define CRYPTONOTE_BLOCKCHAIN_DB_FILENAME               "blockchain.mdb"
+#define CRYPTONOTE_MAPPED_BLOCKS_FILENAME               "blocks.map"
+#define CRYPTONOTE_MAPPED_BLOCK_OFFSETS_FILENAME        "blockoffsets.map"
 #define MINER_CONFIG_FILE_NAME                          "miner_conf.json"
 
 } // parameters
@@ -125,6 +129,13 @@ namespace parameters {
 #define P2P_DEFAULT_PING_CONNECTION_TIMEOUT             2000 // 2 seconds
 #define P2P_DEFAULT_INVOKE_TIMEOUT                      60 * 2 * 1000 // 2 minutes
 #define P2P_DEFAULT_HANDSHAKE_INVOKE_TIMEOUT            5000 // 5 seconds
+#define P2P_TX_ANNOUNCE_INTERVAL                        2 // seconds, announcements to a peer are batched over it
+#define P2P_TX_INVENTORY_MAX_COUNT                      10000 // transaction hashes in one announcement or request
+#define P2P_TX_KNOWN_INVENTORY_SIZE                     16384 // transactions remembered per peer as known to it
+#define P2P_TX_REQUEST_TIMEOUT                          10 // seconds before an announced transaction is asked from another peer
+#define P2P_TX_REQUEST_MAX_IN_FLIGHT                    256 // transactions asked from one peer and not delivered yet
+#define P2P_TX_REQUEST_MAX_PENDING                      10000 // transactions announced by one peer and still being fetched
+#define P2P_TX_REJECTED_FILTER_SIZE                     16384 // transactions rejected by the pool and not asked for again
 #define P2P_STAT_TRUSTED_PUB_KEY                        "FF9507CA55455F37A3B783EE2C5123B8B6A34A0C5CAAE050922C6254161480C1"
 
 const std::initializer_list<const char*> SEED_NODES = {
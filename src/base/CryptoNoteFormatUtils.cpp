@@ -1,5 +1,6 @@
 #include "CryptoNoteFormatUtils.h"
 
+#include <algorithm>
 #include <set>
 #include <log/LoggerRef.h>
 #include <int-util.h>
@@ -498,6 +499,29 @@ bool get_block_longhash(cn_context &context, const Block& b, Hash& res) {
   return true;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool get_block_longhash(cn_context &context, const Block* const* blocks, size_t count, Hash* res) {
+  for (size_t first = 0; first < count; first += SLOW_HASH_MAX_LANES) {
+    size_t lanes = std::min<size_t>(SLOW_HASH_MAX_LANES, count - first);
+    BinaryArray bd[SLOW_HASH_MAX_LANES];
+    const void* data[SLOW_HASH_MAX_LANES];
+    size_t length[SLOW_HASH_MAX_LANES];
+    int variants[SLOW_HASH_MAX_LANES];
+    for (size_t i = 0; i < lanes; ++i) {
+      if (!get_block_hashing_blob(*blocks[first + i], bd[i])) {
+        return false;
+      }
+
+      data[i] = bd[i].data();
+      length[i] = bd[i].size();
+      variants[i] = blocks[first + i]->majorVersion;
+    }
+
+    cn_slow_hash_multi(context, data, length, variants, lanes, res + first);
+  }
+
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 std::vector<uint32_t> relative_output_offsets_to_absolute(const std::vector<uint32_t>& off) {
   std::vector<uint32_t> res = off;
   for (size_t i = 1; i < res.size(); i++)
@@ -70,6 +70,8 @@ bool get_aux_block_header_hash(const Block& b, Crypto::Hash& res);
 bool get_block_hash(const Block& b, Crypto::Hash& res);
 Crypto::Hash get_block_hash(const Block& b);
 bool get_block_longhash(Crypto::cn_context &context, const Block& b, Crypto::Hash& res);
+// Proofs of work of several blocks, interleaved Crypto::SLOW_HASH_MAX_LANES at a time.
+bool get_block_longhash(Crypto::cn_context &context, const Block* const* blocks, size_t count, Crypto::Hash* res);
 bool get_inputs_money_amount(const Transaction& tx, uint64_t& money);
 uint64_t get_outs_money_amount(const Transaction& tx);
 bool check_inputs_types_supported(const TransactionPrefix& tx);
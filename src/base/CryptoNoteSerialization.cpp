@@ -393,6 +393,22 @@ void serialize(Block& block, ISerializer& serializer) {
   serializer(block.transactionHashes, "tx_hashes");
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void serialize(RawBlock& rawBlock, ISerializer& serializer) {
+  serializeAsBinary(rawBlock.block, "block", serializer);
+
+  size_t count = rawBlock.transactions.size();
+  serializer.beginArray(count, "transactions");
+  if (serializer.type() == ISerializer::INPUT) {
+    rawBlock.transactions.resize(count);
+  }
+
+  for (auto& transaction : rawBlock.transactions) {
+    serializeAsBinary(transaction, "", serializer);
+  }
+
+  serializer.endArray();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 void serialize(AccountPublicAddress& address, ISerializer& serializer) {
   serializer(address.spendPublicKey, "m_spend_public_key");
   serializer(address.viewPublicKey, "m_view_public_key");
@@ -0,0 +1,191 @@
+#include "NonceScheduler.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "crypto/crypto.h"
+#include "CryptoNoteFormatUtils.h"
+
+namespace CryptoNote
+{
+
+namespace {
+
+const uint64_t NONCE_SPACE = uint64_t(1) << 32;
+
+}
+
+MiningJob::MiningJob(const Block& block, difficulty_type difficulty, uint32_t startNonce) :
+  m_block(block), m_difficulty(difficulty), m_nonceOffset(NO_NONCE), m_startNonce(startNonce), m_nextNonce(0) {
+}
+
+std::shared_ptr<MiningJob> MiningJob::create(const Block& block, difficulty_type difficulty, uint32_t startNonce) {
+  std::shared_ptr<MiningJob> job(new MiningJob(block, difficulty, startNonce));
+
+  // the nonce is where blobs of two nonces differing in every byte first differ
+  Block probe = block;
+  BinaryArray other;
+  probe.nonce = 0;
+  if (!get_block_hashing_blob(probe, job->m_blob)) {
+    return nullptr;
+  }
+
+  probe.nonce = ~uint32_t(0);
+  if (!get_block_hashing_blob(probe, other) || other.size() != job->m_blob.size()) {
+    return nullptr;
+  }
+
+  auto diff = std::mismatch(job->m_blob.begin(), job->m_blob.end(), other.begin());
+  if (diff.first != job->m_blob.end()) {
+    job->m_nonceOffset = diff.first - job->m_blob.begin();
+    if (job->m_nonceOffset + sizeof(uint32_t) > job->m_blob.size()) {
+      return nullptr;
+    }
+  }
+
+  return job;
+}
+
+const Block& MiningJob::block() const {
+  return m_block;
+}
+
+difficulty_type MiningJob::difficulty() const {
+  return m_difficulty;
+}
+
+const BinaryArray& MiningJob::hashingBlob() const {
+  return m_blob;
+}
+
+void MiningJob::setNonce(BinaryArray& blob, uint32_t nonce) const {
+  // serialized as raw bytes, see serializeBlockHeader()
+  if (m_nonceOffset != NO_NONCE) {
+    memcpy(blob.data() + m_nonceOffset, &nonce, sizeof(nonce));
+  }
+}
+
+Block MiningJob::makeBlock(uint32_t nonce) const {
+  Block block = m_block;
+  block.nonce = nonce;
+  return block;
+}
+
+bool MiningJob::takeRange(uint32_t rangeSize, uint32_t& first, uint32_t& count) const {
+  uint64_t offset = m_nextNonce.fetch_add(rangeSize);
+  if (offset >= NONCE_SPACE) {
+    return false;
+  }
+
+  first = m_startNonce + static_cast<uint32_t>(offset);
+  count = static_cast<uint32_t>(std::min<uint64_t>(rangeSize, NONCE_SPACE - offset));
+  return true;
+}
+
+NonceScheduler::NonceScheduler(uint32_t rangeSize) : m_rangeSize(std::max<uint32_t>(1, rangeSize)), m_jobNumber(0) {
+}
+
+bool NonceScheduler::setJob(const Block& block, difficulty_type difficulty) {
+  return setJob(block, difficulty, Crypto::rand<uint32_t>());
+}
+
+bool NonceScheduler::setJob(const Block& block, difficulty_type difficulty, uint32_t startNonce) {
+  std::shared_ptr<const MiningJob> job = MiningJob::create(block, difficulty, startNonce);
+  if (!job) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_job = std::move(job);
+  ++m_jobNumber;
+  return true;
+}
+
+void NonceScheduler::clearJob() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_job.reset();
+  ++m_jobNumber;
+}
+
+bool NonceScheduler::hasJob() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_job != nullptr;
+}
+
+uint64_t NonceScheduler::jobNumber() const {
+  return m_jobNumber;
+}
+
+std::shared_ptr<const MiningJob> NonceScheduler::job(uint64_t& jobNumber) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  jobNumber = m_jobNumber;
+  return m_job;
+}
+
+uint32_t NonceScheduler::rangeSize() const {
+  return m_rangeSize;
+}
+
+NonceWorker::NonceWorker(const NonceScheduler& scheduler, size_t lanes) :
+  m_scheduler(scheduler),
+  m_lanes(std::max<size_t>(1, std::min<size_t>(lanes, Crypto::SLOW_HASH_MAX_LANES))),
+  m_jobNumber(0),
+  m_count(0),
+  m_rangeNext(0),
+  m_rangeLeft(0) {
+}
+
+bool NonceWorker::next() {
+  if (m_scheduler.jobNumber() != m_jobNumber) {
+    m_job = m_scheduler.job(m_jobNumber);
+    m_rangeLeft = 0;
+    if (m_job) {
+      std::fill(m_blobs, m_blobs + m_lanes, m_job->hashingBlob());
+    }
+  }
+
+  m_count = 0;
+  if (!m_job) {
+    return false;
+  }
+
+  while (m_count < m_lanes) {
+    if (m_rangeLeft == 0 && !m_job->takeRange(m_scheduler.rangeSize(), m_rangeNext, m_rangeLeft)) {
+      break;
+    }
+
+    m_nonces[m_count] = m_rangeNext++;
+    --m_rangeLeft;
+    m_job->setNonce(m_blobs[m_count], m_nonces[m_count]);
+    ++m_count;
+  }
+
+  return m_count != 0;
+}
+
+void NonceWorker::hash(Crypto::cn_context& context, Crypto::Hash* hashes) {
+  const void* data[Crypto::SLOW_HASH_MAX_LANES];
+  size_t length[Crypto::SLOW_HASH_MAX_LANES];
+  int variants[Crypto::SLOW_HASH_MAX_LANES];
+  for (size_t i = 0; i < m_count; ++i) {
+    data[i] = m_blobs[i].data();
+    length[i] = m_blobs[i].size();
+    variants[i] = m_job->block().majorVersion;
+  }
+
+  Crypto::cn_slow_hash_multi(context, data, length, variants, m_count, hashes);
+}
+
+const MiningJob& NonceWorker::job() const {
+  return *m_job;
+}
+
+size_t NonceWorker::count() const {
+  return m_count;
+}
+
+uint32_t NonceWorker::nonce(size_t lane) const {
+  return m_nonces[lane];
+}
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "CryptoNote.h"
+#include "core/Difficulty.h"
+#include "crypto/hash.h"
+
+namespace CryptoNote
+{
+  // A block template ready for hashing. The hashing blob is serialized once and nonces are written straight into
+  // copies of it, so miners skip get_block_hashing_blob() and the transaction tree hash for every nonce.
+  class MiningJob {
+
+  public:
+
+    // Returns nullptr if the block can't be serialized.
+    static std::shared_ptr<MiningJob> create(const Block& block, difficulty_type difficulty, uint32_t startNonce);
+
+    const Block& block() const;
+    difficulty_type difficulty() const;
+    const BinaryArray& hashingBlob() const;
+
+    // Writes the nonce into a copy of hashingBlob(). Versions whose blob leaves the nonce out keep the blob unchanged.
+    void setNonce(BinaryArray& blob, uint32_t nonce) const;
+    Block makeBlock(uint32_t nonce) const;
+
+    // Takes the next nonces of this job, false once all 2^32 of them are handed out.
+    bool takeRange(uint32_t rangeSize, uint32_t& first, uint32_t& count) const;
+
+  private:
+
+    static const size_t NO_NONCE = static_cast<size_t>(-1);
+
+    MiningJob(const Block& block, difficulty_type difficulty, uint32_t startNonce);
+
+    Block m_block;
+    difficulty_type m_difficulty;
+    BinaryArray m_blob;
+    size_t m_nonceOffset;
+    uint32_t m_startNonce;
+    mutable std::atomic<uint64_t> m_nextNonce; // from m_startNonce
+  };
+
+  // Current job of a set of mining threads. Threads take nonce ranges as they go, so faster threads take more of
+  // them, and setJob() swaps the job without stopping anybody: NonceWorker checks the job number before every hash.
+  class NonceScheduler {
+
+  public:
+
+    static const uint32_t DEFAULT_RANGE_SIZE = 256;
+
+    explicit NonceScheduler(uint32_t rangeSize = DEFAULT_RANGE_SIZE);
+
+    // A random start nonce, so that several miners of the same template don't repeat each other. False if the
+    // block can't be serialized, the previous job is kept then.
+    bool setJob(const Block& block, difficulty_type difficulty);
+    bool setJob(const Block& block, difficulty_type difficulty, uint32_t startNonce);
+    void clearJob();
+
+    bool hasJob() const;
+    // Changes with every setJob() and clearJob(), cheap enough to poll before each hash.
+    uint64_t jobNumber() const;
+    std::shared_ptr<const MiningJob> job(uint64_t& jobNumber) const;
+    uint32_t rangeSize() const;
+
+  private:
+
+    const uint32_t m_rangeSize;
+    mutable std::mutex m_mutex;
+    std::shared_ptr<const MiningJob> m_job;
+    std::atomic<uint64_t> m_jobNumber;
+  };
+
+  // One mining thread's side of a NonceScheduler: the job it works on, hashing blobs with its nonces patched in and
+  // what is left of the range it took.
+  class NonceWorker {
+
+  public:
+
+    // lanes nonces are hashed together, see Crypto::cn_slow_hash_multi()
+    NonceWorker(const NonceScheduler& scheduler, size_t lanes);
+
+    // Moves to the scheduler's current job if it changed and prepares the next nonces. False if there is no job or
+    // its nonces ran out.
+    bool next();
+    void hash(Crypto::cn_context& context, Crypto::Hash* hashes);
+
+    const MiningJob& job() const;
+    size_t count() const;
+    uint32_t nonce(size_t lane) const;
+
+  private:
+
+    const NonceScheduler& m_scheduler;
+    const size_t m_lanes;
+    std::shared_ptr<const MiningJob> m_job;
+    uint64_t m_jobNumber;
+    BinaryArray m_blobs[Crypto::SLOW_HASH_MAX_LANES];
+    uint32_t m_nonces[Crypto::SLOW_HASH_MAX_LANES];
+    size_t m_count;
+    uint32_t m_rangeNext;
+    uint32_t m_rangeLeft;
+  };
+}
@@ -0,0 +1,213 @@
+#include "BlockCacheJournal.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace CryptoNote {
+
+namespace {
+
+const char JOURNAL_SIGNATURE[] = "BCJ1";
+const size_t JOURNAL_SIGNATURE_SIZE = 4;
+const uint32_t MAX_RECORD_SIZE = 256 * 1024 * 1024;
+
+bool writeUInt32(FILE* file, uint32_t value) {
+  unsigned char data[4];
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    data[i] = static_cast<unsigned char>((value >> (8 * i)) & 0xff);
+  }
+
+  return fwrite(data, 1, sizeof(data), file) == sizeof(data);
+}
+
+bool writeData(FILE* file, const void* data, size_t size) {
+  return size == 0 || fwrite(data, 1, size, file) == size;
+}
+
+// Pushes buffered data down to the disk, not just to the OS.
+bool syncFile(FILE* file) {
+  if (fflush(file) != 0) {
+    return false;
+  }
+
+#ifdef _WIN32
+  return _commit(_fileno(file)) == 0;
+#else
+  return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Makes a rename in the directory durable; Windows has no directory handles to sync.
+void syncDirectory(const std::string& path) {
+#ifndef _WIN32
+  int directory = open(path.empty() ? "." : path.c_str(), O_RDONLY);
+  if (directory != -1) {
+    fsync(directory);
+    close(directory);
+  }
+#endif
+}
+
+bool readUInt32(std::istream& stream, uint32_t& value) {
+  unsigned char data[4];
+  if (!stream.read(reinterpret_cast<char*>(data), sizeof(data))) {
+    return false;
+  }
+
+  value = 0;
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    value |= static_cast<uint32_t>(data[i]) << (8 * i);
+  }
+
+  return true;
+}
+
+uint32_t checksum(const BinaryArray& record) {
+  Crypto::Hash hash;
+  Crypto::cn_fast_hash(record.data(), record.size(), hash);
+  uint32_t value;
+  std::memcpy(&value, &hash, sizeof(value));
+  return value;
+}
+
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+BlockCacheJournal::BlockCacheJournal() : m_file(nullptr), m_recordCount(0) {
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+BlockCacheJournal::~BlockCacheJournal() {
+  close();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool BlockCacheJournal::create(const std::string& fileName, const Header& header) {
+  close();
+  m_file = fopen(fileName.c_str(), "wb");
+  if (m_file == nullptr) {
+    return false;
+  }
+
+  if (!writeData(m_file, JOURNAL_SIGNATURE, JOURNAL_SIGNATURE_SIZE) || !writeUInt32(m_file, header.height) ||
+    !writeData(m_file, &header.lastBlockHash, sizeof(header.lastBlockHash)) || !syncFile(m_file)) {
+    close();
+    return false;
+  }
+
+  syncDirectory(boost::filesystem::path(fileName).parent_path().string());
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool BlockCacheJournal::append(const BinaryArray& record) {
+  if (m_file == nullptr) {
+    return false;
+  }
+
+  if (!writeUInt32(m_file, static_cast<uint32_t>(record.size())) || !writeUInt32(m_file, checksum(record)) ||
+    !writeData(m_file, record.data(), record.size())) {
+    close();
+    return false;
+  }
+
+  ++m_recordCount;
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool BlockCacheJournal::sync() {
+  if (m_file == nullptr) {
+    return false;
+  }
+
+  if (!syncFile(m_file)) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void BlockCacheJournal::close() {
+  if (m_file != nullptr) {
+    syncFile(m_file);
+    fclose(m_file);
+    m_file = nullptr;
+  }
+
+  m_recordCount = 0;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool BlockCacheJournal::isOpened() const {
+  return m_file != nullptr;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+uint32_t BlockCacheJournal::recordCount() const {
+  return m_recordCount;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool BlockCacheJournal::replaceFile(const std::string& fileName, const BinaryArray& data) {
+  const std::string temporaryFileName = fileName + ".tmp";
+  FILE* file = fopen(temporaryFileName.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  bool written = writeData(file, data.data(), data.size()) && syncFile(file);
+  if (fclose(file) != 0 || !written) {
+    return false;
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(temporaryFileName, fileName, ec);
+  if (ec) {
+    return false;
+  }
+
+  syncDirectory(boost::filesystem::path(fileName).parent_path().string());
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool BlockCacheJournal::read(const std::string& fileName, Header& header, const std::function<bool(const BinaryArray&)>& visitor) {
+  std::ifstream file(fileName, std::ios::in | std::ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  char signature[JOURNAL_SIGNATURE_SIZE];
+  if (!file.read(signature, JOURNAL_SIGNATURE_SIZE) || std::memcmp(signature, JOURNAL_SIGNATURE, JOURNAL_SIGNATURE_SIZE) != 0) {
+    return false;
+  }
+
+  if (!readUInt32(file, header.height) || !file.read(reinterpret_cast<char*>(&header.lastBlockHash), sizeof(header.lastBlockHash))) {
+    return false;
+  }
+
+  BinaryArray record;
+  for (;;) {
+    uint32_t size;
+    uint32_t recordChecksum;
+    if (!readUInt32(file, size) || !readUInt32(file, recordChecksum) || size > MAX_RECORD_SIZE) {
+      break;
+    }
+
+    record.resize(size);
+    if (size != 0 && !file.read(reinterpret_cast<char*>(record.data()), size)) {
+      break;
+    }
+
+    if (checksum(record) != recordChecksum || !visitor(record)) {
+      break;
+    }
+  }
+
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+} //namespace CryptoNote
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "crypto/hash.h"
+#include "CryptoNote.h"
+
+namespace CryptoNote {
+
+// Append-only log of blockchain cache changes made after a snapshot. The header names the chain state the log
+// starts from; every record is length-prefixed and checksummed, so a torn tail written during a crash is ignored.
+class BlockCacheJournal {
+
+public:
+
+  struct Header {
+    uint32_t height;
+    Crypto::Hash lastBlockHash;
+  };
+
+  BlockCacheJournal();
+  BlockCacheJournal(const BlockCacheJournal&) = delete;
+  ~BlockCacheJournal();
+  BlockCacheJournal& operator=(const BlockCacheJournal&) = delete;
+
+  // Truncates the file and writes the header.
+  bool create(const std::string& fileName, const Header& header);
+  // Buffers the record, it is only durable after the next sync() or close().
+  bool append(const BinaryArray& record);
+  bool sync();
+  void close();
+  bool isOpened() const;
+  uint32_t recordCount() const;
+
+  // Reads the header and passes intact records to the visitor until it returns false.
+  static bool read(const std::string& fileName, Header& header, const std::function<bool(const BinaryArray&)>& visitor);
+  // Writes data to a temporary file, syncs it and renames it over fileName, so a crash leaves either file intact.
+  static bool replaceFile(const std::string& fileName, const BinaryArray& data);
+
+private:
+
+  FILE* m_file;
+  uint32_t m_recordCount;
+};
+
+} //namespace CryptoNote
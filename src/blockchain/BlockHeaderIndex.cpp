@@ -0,0 +1,28 @@
+#include "BlockHeaderIndex.h"
+
+#include <stdexcept>
+
+#include "Serialization/SerializationOverloads.h"
+
+namespace CryptoNote {
+  void BlockHeaderIndex::clear() {
+    m_timestamps.clear();
+    m_cumulativeDifficulties.clear();
+    m_cumulativeSizes.clear();
+    m_generatedCoins.clear();
+    m_majorVersions.clear();
+  }
+
+  void BlockHeaderIndex::serialize(ISerializer& s) {
+    s(m_timestamps, "timestamps");
+    s(m_cumulativeDifficulties, "cumulative_difficulties");
+    s(m_cumulativeSizes, "cumulative_sizes");
+    s(m_generatedCoins, "generated_coins");
+    s(m_majorVersions, "major_versions");
+
+    size_t count = m_timestamps.size();
+    if (m_cumulativeDifficulties.size() != count || m_cumulativeSizes.size() != count || m_generatedCoins.size() != count || m_majorVersions.size() != count) {
+      throw std::runtime_error("Invalid block header index");
+    }
+  }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/Difficulty.h"
+
+namespace CryptoNote
+{
+  class ISerializer;
+
+  // Scalars of main chain blocks kept in dense arrays, so that difficulty, size and emission queries do not load blocks.
+  class BlockHeaderIndex {
+
+  public:
+
+    void push(uint64_t timestamp, difficulty_type cumulativeDifficulty, uint64_t cumulativeSize, uint64_t generatedCoins, uint8_t majorVersion) {
+      m_timestamps.push_back(timestamp);
+      m_cumulativeDifficulties.push_back(cumulativeDifficulty);
+      m_cumulativeSizes.push_back(cumulativeSize);
+      m_generatedCoins.push_back(generatedCoins);
+      m_majorVersions.push_back(majorVersion);
+    }
+
+    void pop() {
+      m_timestamps.pop_back();
+      m_cumulativeDifficulties.pop_back();
+      m_cumulativeSizes.pop_back();
+      m_generatedCoins.pop_back();
+      m_majorVersions.pop_back();
+    }
+
+    uint32_t size() const {
+      return static_cast<uint32_t>(m_timestamps.size());
+    }
+
+    void clear();
+
+    uint64_t timestamp(uint32_t height) const {
+      return m_timestamps[height];
+    }
+
+    difficulty_type cumulativeDifficulty(uint32_t height) const {
+      return m_cumulativeDifficulties[height];
+    }
+
+    uint64_t cumulativeSize(uint32_t height) const {
+      return m_cumulativeSizes[height];
+    }
+
+    uint64_t generatedCoins(uint32_t height) const {
+      return m_generatedCoins[height];
+    }
+
+    uint8_t majorVersion(uint32_t height) const {
+      return m_majorVersions[height];
+    }
+
+    const std::vector<uint64_t>& timestamps() const {
+      return m_timestamps;
+    }
+
+    void serialize(ISerializer& s);
+
+  private:
+
+    std::vector<uint64_t> m_timestamps;
+    std::vector<difficulty_type> m_cumulativeDifficulties;
+    std::vector<uint64_t> m_cumulativeSizes;
+    std::vector<uint64_t> m_generatedCoins;
+    std::vector<uint8_t> m_majorVersions;
+
+  };
+}
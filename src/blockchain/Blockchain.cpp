@@ -1,7 +1,14 @@
 #include "Blockchain.h"
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <thread>
+#include <boost/filesystem.hpp>
 #include <boost/foreach.hpp>
 #include "common/Math.h"
 #include "ShuffleGenerator.h"
@@ -10,6 +17,7 @@
 #include "rpc/CoreRpcServerCommandsDefinitions.h"
 #include "Serialization/BinarySerializationTools.h"
 #include "base/CryptoNoteTools.h"
+#include "DataBaseBatch.h"
 
 using namespace Logging;
 using namespace Common;
@@ -26,6 +34,172 @@ std::string appendPath(const std::string& path, const std::string& fileName) {
   return result;
 }
 
+bool sameItem(CryptoNote::ISwappedVectorStorage& first, CryptoNote::ISwappedVectorStorage& second, uint64_t index) {
+  std::vector<uint8_t> item;
+  bool same = false;
+  try {
+    first.read(index, [&](const void* data, size_t size) {
+      item.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    });
+
+    second.read(index, [&](const void* data, size_t size) {
+      same = size == item.size() && (size == 0 || std::memcmp(data, item.data(), size) == 0);
+    });
+  } catch (std::exception&) {
+    return false;
+  }
+
+  return same;
+}
+
+// Blockchain whose m_readLock this thread holds, and whether it holds it exclusively; see Blockchain::ReadLock.
+thread_local const CryptoNote::Blockchain* readLockedBlockchain = nullptr;
+thread_local bool readLockedExclusively = false;
+
+// Cuts the wire blobs of a block and its transactions out of a stored Blockchain::BlockEntry, walking the layout
+// BlockEntry::serialize() writes; the block and transaction bytes in it are the ones toBinaryArray() produces.
+CryptoNote::RawBlock extractRawBlock(const std::vector<uint8_t>& blob) {
+  CryptoNote::RawBlock rawBlock;
+  Common::MemoryInputStream stream(blob.data(), blob.size());
+  CryptoNote::BinaryInputStreamSerializer s(stream);
+
+  CryptoNote::Block block;
+  s(block, "block");
+  rawBlock.block.assign(blob.begin(), blob.begin() + stream.getPosition());
+
+  uint32_t height;
+  uint64_t blockCumulativeSize;
+  CryptoNote::difficulty_type cumulativeDifficulty;
+  uint64_t alreadyGeneratedCoins;
+  s(height, "height");
+  s(blockCumulativeSize, "block_cumulative_size");
+  s(cumulativeDifficulty, "cumulative_difficulty");
+  s(alreadyGeneratedCoins, "already_generated_coins");
+
+  size_t transactionCount;
+  s.beginArray(transactionCount, "transactions");
+  rawBlock.transactions.reserve(transactionCount != 0 ? transactionCount - 1 : 0);
+  for (size_t i = 0; i < transactionCount; ++i) {
+    CryptoNote::Transaction transaction;
+    std::vector<uint32_t> globalOutputIndexes;
+    size_t transactionBegin = stream.getPosition();
+    s(transaction, "tx");
+    size_t transactionEnd = stream.getPosition();
+    s(globalOutputIndexes, "indexes");
+
+    // the base transaction is part of the block blob
+    if (i != 0) {
+      rawBlock.transactions.emplace_back(blob.begin() + transactionBegin, blob.begin() + transactionEnd);
+    }
+  }
+
+  s.endArray();
+  return rawBlock;
+}
+
+// Journal records after which the blockchain cache is checkpointed in the background.
+const uint32_t CACHE_CHECKPOINT_INTERVAL = 1000;
+
+// Journal records written between syncs; records lost in a crash are rebuilt from the stored blocks.
+const uint32_t CACHE_JOURNAL_SYNC_INTERVAL = 100;
+
+// Blocks added without a journal before a checkpoint tries to start a new one.
+const uint32_t CACHE_JOURNAL_RETRY_INTERVAL = 100;
+
+// Blocks in flight per worker thread while loading the chain at startup.
+const size_t LOAD_BLOCKS_PER_WORKER = 64;
+
+// Verified ring signatures remembered, enough for a full transaction pool and the blocks mined from it.
+const size_t RING_SIGNATURE_CACHE_SIZE = 65536;
+
+// Decompressed output keys remembered for ring signature checks, about 2.5 KB each.
+const size_t OUTPUT_KEY_CACHE_SIZE = 8192;
+
+// Precomputed proofs of work kept for blocks that never made it to pushBlock, e.g. ones already in the chain.
+const size_t PROOF_OF_WORK_CACHE_SIZE = 1024;
+
+// Keys of the indexes kept in the blockchain database; numbers in keys are big-endian so that LMDB orders them.
+const std::string INDEX_PREFIX = "idx/";
+const std::string INDEX_HEIGHT_KEY = "idx/height";
+const std::string INDEX_VERSION_KEY = "idx/version";
+const std::string INDEX_TRANSACTION_COUNT_KEY = "idx/txcount";
+const std::string INDEX_TRANSACTION_PREFIX = "idx/tx/";
+const std::string INDEX_KEY_IMAGE_PREFIX = "idx/ki/";
+const std::string INDEX_KEY_OUTPUT_PREFIX = "idx/ko/";
+const std::string INDEX_KEY_OUTPUT_COUNT_PREFIX = "idx/kc/";
+const std::string INDEX_MULTISIGNATURE_OUTPUT_PREFIX = "idx/mo/";
+const std::string INDEX_MULTISIGNATURE_OUTPUT_COUNT_PREFIX = "idx/mc/";
+
+// Layout of the index values; indexes written with another version are rebuilt.
+const uint32_t INDEX_STORAGE_VERSION = 2;
+
+template<class T> std::string podKey(const std::string& prefix, const T& pod) {
+  return prefix + std::string(reinterpret_cast<const char*>(&pod), sizeof(pod));
+}
+
+std::string amountKey(const std::string& prefix, uint64_t amount) {
+  return CryptoNote::makeIndexKey(prefix, amount);
+}
+
+std::string amountIndexKey(const std::string& prefix, uint64_t amount, uint32_t index) {
+  return CryptoNote::makeIndexKey(CryptoNote::makeIndexKey(prefix, amount), index);
+}
+
+void packUInt(std::string& data, uint64_t value, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    data.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+uint64_t unpackUInt(const std::string& data, size_t offset, size_t size) {
+  if (data.size() < offset + size) {
+    throw std::runtime_error("Corrupted blockchain index value");
+  }
+
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; ++i) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(data[offset + i])) << (8 * i);
+  }
+
+  return value;
+}
+
+uint64_t packOutputLocation(CryptoNote::Blockchain::TransactionIndex transactionIndex, uint16_t outputIndex) {
+  return (static_cast<uint64_t>(transactionIndex.block) << 32) | (static_cast<uint64_t>(transactionIndex.transaction) << 16) | outputIndex;
+}
+
+CryptoNote::Blockchain::KeyOutputEntry unpackOutputLocation(uint64_t location) {
+  CryptoNote::Blockchain::KeyOutputEntry entry;
+  entry.transactionIndex.block = static_cast<uint32_t>(location >> 32);
+  entry.transactionIndex.transaction = static_cast<uint16_t>(location >> 16);
+  entry.outputIndex = static_cast<uint16_t>(location);
+  return entry;
+}
+
+// Change of the deposited amount made by a transaction: new deposit outputs minus spent deposits.
+int64_t getDepositChange(const CryptoNote::Transaction& transaction) {
+  int64_t deposit = 0;
+  for (const auto& in : transaction.inputs) {
+    if (in.type() == typeid(CryptoNote::MultisignatureInput)) {
+      auto& multisign = boost::get<CryptoNote::MultisignatureInput>(in);
+      if (multisign.term > 0) {
+        deposit -= multisign.amount;
+      }
+    }
+  }
+
+  for (const auto& out : transaction.outputs) {
+    if (out.target.type() == typeid(CryptoNote::MultisignatureOutput)) {
+      auto& multisign = boost::get<CryptoNote::MultisignatureOutput>(out.target);
+      if (multisign.term > 0) {
+        deposit += out.amount;
+      }
+    }
+  }
+
+  return deposit;
+}
+
 }
 
 namespace std {
@@ -38,7 +212,7 @@ bool operator<(const Crypto::KeyImage& keyImage1, const Crypto::KeyImage& keyIma
 }
 }
 
-#define CURRENT_BLOCKCACHE_STORAGE_ARCHIVE_VER 3
+#define CURRENT_BLOCKCACHE_STORAGE_ARCHIVE_VER 6
 #define CURRENT_BLOCKCHAININDICES_STORAGE_ARCHIVE_VER 1
 
 namespace CryptoNote {
@@ -78,8 +252,9 @@ bool serialize(google::sparse_hash_set<K, Hash>& value, Common::StringView name,
 }
 
 // custom serialization to speedup cache loading
-bool serialize(std::vector<std::pair<Blockchain::TransactionIndex, uint16_t>>& value, Common::StringView name, CryptoNote::ISerializer& s) {
-  const size_t elementSize = sizeof(std::pair<Blockchain::TransactionIndex, uint16_t>);
+template<typename T>
+bool serializeColumn(std::vector<T>& value, Common::StringView name, CryptoNote::ISerializer& s) {
+  const size_t elementSize = sizeof(T);
   size_t size = value.size() * elementSize;
 
   if (!s.beginArray(size, name)) {
@@ -106,11 +281,28 @@ void serialize(Blockchain::TransactionIndex& value, ISerializer& s) {
   s(value.transaction, "tx");
 }
 
+void serialize(Blockchain::KeyOutputColumns& value, ISerializer& s) {
+  serializeColumn(value.locations, "locations", s);
+  serializeColumn(value.unlockTimes, "unlock_times", s);
+  serializeColumn(value.keys, "keys", s);
+  if (value.unlockTimes.size() != value.locations.size() || value.keys.size() != value.locations.size()) {
+    throw std::runtime_error("Invalid output index columns");
+  }
+}
+
 class BlockCacheSerializer {
 
 public:
   BlockCacheSerializer(Blockchain& bs, const Crypto::Hash lastBlockHash, ILogger& logger) :
-    m_bs(bs), m_lastBlockHash(lastBlockHash), m_loaded(false), logger(logger, "BlockCacheSerializer") {
+    m_bs(bs), m_blockIndex(bs.m_blockIndex), m_headerIndex(bs.m_headerIndex), m_transactionMap(bs.m_transactionMap),
+    m_spentKeys(bs.m_spent_keys), m_outputs(bs.m_outputs), m_multisignatureOutputs(bs.m_multisignatureOutputs),
+    m_depositIndex(bs.m_depositIndex), m_lastBlockHash(lastBlockHash), m_loaded(false), logger(logger, "BlockCacheSerializer") {
+  }
+
+  BlockCacheSerializer(Blockchain& bs, Blockchain::CacheSnapshot& snapshot, const Crypto::Hash lastBlockHash, ILogger& logger) :
+    m_bs(bs), m_blockIndex(snapshot.blockIndex), m_headerIndex(snapshot.headerIndex), m_transactionMap(snapshot.transactionMap),
+    m_spentKeys(snapshot.spentKeys), m_outputs(snapshot.outputs), m_multisignatureOutputs(snapshot.multisignatureOutputs),
+    m_depositIndex(snapshot.depositIndex), m_lastBlockHash(lastBlockHash), m_loaded(false), logger(logger, "BlockCacheSerializer") {
   }
 
   void load(const std::string& filename) {
@@ -128,14 +320,9 @@ public:
     }
   }
 
-  bool save(const std::string& filename) {
+  bool save(BinaryArray& data) {
     try {
-      std::ofstream file(filename, std::ios::binary);
-      if (!file) {
-        return false;
-      }
-
-      StdOutputStream stream(file);
+      VectorOutputStream stream(data);
       BinaryOutputStreamSerializer s(stream);
       CryptoNote::serialize(*this, s);
     } catch (std::exception&) {
@@ -156,44 +343,56 @@ public:
       return;
     }
 
+    // transaction, key image and output indexes are only cached when they are not kept in the database
+    bool indexesInDataBase = m_bs.m_indexStorage != nullptr;
+
     std::string operation;
     if (s.type() == ISerializer::INPUT) {
       operation = "- loading ";
-      Crypto::Hash blockHash;
-      s(blockHash, "last_block");
+      // a snapshot of any earlier chain state is usable, the journal and the stored blocks bring it up to date
+      s(m_lastBlockHash, "last_block");
 
-      if (blockHash != m_lastBlockHash) {
+      bool cachedIndexesInDataBase;
+      s(cachedIndexesInDataBase, "indexes_in_database");
+      if (cachedIndexesInDataBase != indexesInDataBase) {
         return;
       }
 
     } else {
       operation = "- saving ";
       s(m_lastBlockHash, "last_block");
+      s(indexesInDataBase, "indexes_in_database");
     }
 
     logger(INFO) << operation << "block index...";
-    s(m_bs.m_blockIndex, "block_index");
+    s(m_blockIndex, "block_index");
 
-    logger(INFO) << operation << "transaction map...";
-    s(m_bs.m_transactionMap, "transactions");
+    logger(INFO) << operation << "block header index...";
+    s(m_headerIndex, "header_index");
 
-    logger(INFO) << operation << "spent keys...";
-    s(m_bs.m_spent_keys, "spent_keys");
+    if (!indexesInDataBase) {
+      logger(INFO) << operation << "transaction map...";
+      s(m_transactionMap, "transactions");
 
-    logger(INFO) << operation << "outputs...";
-    s(m_bs.m_outputs, "outputs");
+      logger(INFO) << operation << "spent keys...";
+      s(m_spentKeys, "spent_keys");
 
-    logger(INFO) << operation << "multi-signature outputs...";
-    s(m_bs.m_multisignatureOutputs, "multisig_outputs");
+      logger(INFO) << operation << "outputs...";
+      s(m_outputs, "outputs");
+
+      logger(INFO) << operation << "multi-signature outputs...";
+      s(m_multisignatureOutputs, "multisig_outputs");
+    }
 
     logger(INFO) << operation << "deposit index...";
-    s(m_bs.m_depositIndex, "deposit_index");
+    s(m_depositIndex, "deposit_index");
 
     auto dur = std::chrono::steady_clock::now() - start;
 
     logger(INFO) << "Serialization time: " << std::chrono::duration_cast<std::chrono::milliseconds>(dur).count() << "ms";
 
-    m_loaded = true;
+    m_loaded = s.type() == ISerializer::OUTPUT || (m_blockIndex.size() != 0 && m_blockIndex.getTailId() == m_lastBlockHash &&
+      m_headerIndex.size() == m_blockIndex.size());
   }
 
   bool loaded() const {
@@ -204,6 +403,13 @@ private:
   LoggerRef logger;
   bool m_loaded;
   Blockchain& m_bs;
+  BlockIndex& m_blockIndex;
+  BlockHeaderIndex& m_headerIndex;
+  Blockchain::TransactionMap& m_transactionMap;
+  Blockchain::key_images_container& m_spentKeys;
+  Blockchain::outputs_container& m_outputs;
+  Blockchain::MultisignatureOutputsContainer& m_multisignatureOutputs;
+  DepositIndex& m_depositIndex;
   Crypto::Hash m_lastBlockHash;
 };
 
@@ -298,12 +504,21 @@ private:
 };
 
 
-Blockchain::Blockchain(const Currency& currency, tx_memory_pool& tx_pool, ILogger& logger, bool blockchainIndexesEnabled) :
+Blockchain::Blockchain(const Currency& currency, tx_memory_pool& tx_pool, Tools::WorkerPool& workerPool, ILogger& logger, bool blockchainIndexesEnabled) :
   logger(logger, "Blockchain"),
   m_currency(currency),
   m_tx_pool(tx_pool),
+  m_workerPool(workerPool),
+  m_ringSignatureCache(RING_SIGNATURE_CACHE_SIZE),
+  m_outputKeyCache(OUTPUT_KEY_CACHE_SIZE),
   m_current_block_cumul_sz_limit(0),
   m_is_in_checkpoint_zone(false),
+  m_difficultyState(currency),
+  m_nextDifficulty(0),
+  m_tip(std::make_shared<ChainTip>()),
+  m_cacheJournalIndex(0),
+  m_cacheJournalRetryBlocks(0),
+  m_cacheCheckpointRunning(false),
   m_upgradeDetectorv1(currency, m_blocks, CURRENT_BLOCK_MAJOR + 1, logger),
   m_upgradeDetectorv2(currency, m_blocks, CURRENT_BLOCK_MAJOR + 2, logger),
   m_upgradeDetectorv3(currency, m_blocks, CURRENT_BLOCK_MAJOR + 3, logger),
@@ -321,6 +536,56 @@ Blockchain::Blockchain(const Currency& currency, tx_memory_pool& tx_pool, ILogge
   m_spent_keys.set_deleted_key(nullImage);
 }
 
+Blockchain::~Blockchain() {
+  stopCacheCheckpoint();
+}
+
+Blockchain::ReadLock::ReadLock(const Blockchain& blockchain) :
+  m_blockchain(blockchain), m_outerBlockchain(readLockedBlockchain), m_outerExclusively(readLockedExclusively), m_locked(readLockedBlockchain != &blockchain) {
+  if (m_locked) {
+    m_blockchain.m_readLock.lock_shared();
+    readLockedBlockchain = &m_blockchain;
+    readLockedExclusively = false;
+  }
+}
+
+Blockchain::ReadLock::~ReadLock() {
+  if (m_locked) {
+    readLockedBlockchain = m_outerBlockchain;
+    readLockedExclusively = m_outerExclusively;
+    m_blockchain.m_readLock.unlock_shared();
+  }
+}
+
+Blockchain::WriteLock::WriteLock(const Blockchain& blockchain) :
+  m_blockchain(blockchain), m_outerBlockchain(readLockedBlockchain), m_outerExclusively(readLockedExclusively), m_owner(readLockedBlockchain != &blockchain), m_locked(false) {
+  // a reader can't upgrade, two of them doing so would wait for each other
+  assert(m_owner || readLockedExclusively);
+  lock();
+}
+
+Blockchain::WriteLock::~WriteLock() {
+  unlock();
+}
+
+void Blockchain::WriteLock::lock() {
+  if (m_owner && !m_locked) {
+    m_blockchain.m_readLock.lock();
+    readLockedBlockchain = &m_blockchain;
+    readLockedExclusively = true;
+    m_locked = true;
+  }
+}
+
+void Blockchain::WriteLock::unlock() {
+  if (m_locked) {
+    readLockedBlockchain = m_outerBlockchain;
+    readLockedExclusively = m_outerExclusively;
+    m_blockchain.m_readLock.unlock();
+    m_locked = false;
+  }
+}
+
 bool Blockchain::addObserver(IBlockchainStorageObserver* observer) {
   return m_observerManager.add(observer);
 }
@@ -341,7 +606,8 @@ bool Blockchain::checkTransactionInputs(const CryptoNote::Transaction& tx, Block
   //check is ring_signature already checked ?
   if (maxUsedBlock.empty()) {
     //not checked, lets try to check
-    if (!lastFailed.empty() && getCurrentBlockchainHeight() > lastFailed.height && getBlockIdByHeight(lastFailed.height) == lastFailed.id) {
+    // a failure is only cached for the tail it happened at, unlock times and new outputs can make the tx valid later
+    if (!lastFailed.empty() && getCurrentBlockchainHeight() == lastFailed.height + 1 && getTailId() == lastFailed.id) {
       return false; //we already sure that this tx is broken for this height
     }
 
@@ -391,21 +657,49 @@ bool Blockchain::checkTransactionSize(size_t blobSize) {
 
 bool Blockchain::haveTransaction(const Crypto::Hash &id) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  return m_transactionMap.find(id) != m_transactionMap.end();
+  TransactionIndex transactionIndex;
+  return findTransaction(id, transactionIndex);
 }
 
 bool Blockchain::have_tx_keyimg_as_spent(const Crypto::KeyImage &key_im) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  return  m_spent_keys.find(key_im) != m_spent_keys.end();
+  return isSpentKeyImage(key_im);
 }
 
 uint32_t Blockchain::getCurrentBlockchainHeight() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return static_cast<uint32_t>(m_blocks.size());
 }
 
+std::shared_ptr<const Blockchain::ChainTip> Blockchain::getTip() const {
+  return std::atomic_load(&m_tip);
+}
+
+void Blockchain::publishTip() {
+  std::shared_ptr<ChainTip> tip = std::make_shared<ChainTip>();
+  if (!m_blocks.empty()) {
+    uint32_t tailHeight = static_cast<uint32_t>(m_blocks.size() - 1);
+    tip->height = static_cast<uint32_t>(m_blocks.size());
+    tip->id = m_blockIndex.getTailId();
+    tip->nextDifficulty = getDifficultyForNextBlock();
+    tip->alreadyGeneratedCoins = m_headerIndex.generatedCoins(tailHeight);
+    tip->transactionCount = getTransactionCount();
+    tip->fullDepositAmount = m_depositIndex.fullDepositAmount();
+    tip->fullDepositInterest = m_depositIndex.fullInterestAmount();
+  }
+
+  std::atomic_store(&m_tip, std::shared_ptr<const ChainTip>(std::move(tip)));
+}
+
 bool Blockchain::init(const std::string& config_folder, bool load_existing) {
+  CoreConfig config;
+  config.configFolder = config_folder;
+  return init(config, load_existing);
+}
+
+bool Blockchain::init(const CoreConfig& config, bool load_existing) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  const std::string& config_folder = config.configFolder;
   if (!config_folder.empty() && !Tools::create_directories_if_necessary(config_folder)) {
     logger(ERROR, BRIGHT_RED) << "Failed to create data directory: " << m_config_folder;
     return false;
@@ -413,25 +707,30 @@ bool Blockchain::init(const std::string& config_folder, bool load_existing) {
 
   m_config_folder = config_folder;
 
-  if (!m_blocks.open(appendPath(config_folder, m_currency.blocksFileName()), appendPath(config_folder, m_currency.blockIndexesFileName()), 1024)) {
+  if (!openBlocks(config)) {
     return false;
   }
 
+  BlockCacheJournal::Header snapshot = BlockCacheJournal::Header();
+
   if (load_existing && !m_blocks.empty()) {
     logger(INFO, BRIGHT_WHITE) << "Loading blockchain...";
-    BlockCacheSerializer loader(*this, get_block_hash(m_blocks.back().bl), logger.getLogger());
-    loader.load(appendPath(config_folder, m_currency.blocksCacheFileName()));
-
-    if (!loader.loaded()) {
+    if (!loadCache(snapshot)) {
       logger(WARNING, BRIGHT_YELLOW) << "No actual blockchain cache found, rebuilding internal structures...";
+      snapshot = BlockCacheJournal::Header();
       rebuildCache();
     }
 
+    if (m_indexStorage) {
+      updateIndexStorage();
+    }
+
     if (m_blockchainIndexesEnabled) {
       loadBlockchainIndices();
     }
   } else {
     m_blocks.clear();
+    clearTransactionIndexes();
   }
 
   if (m_blocks.empty()) {
@@ -455,6 +754,8 @@ bool Blockchain::init(const std::string& config_folder, bool load_existing) {
     }
   }
 
+  startCacheJournal(snapshot);
+
   uint32_t lastValidCheckpointHeight = 0;
   if (!checkCheckpoints(lastValidCheckpointHeight)) {
     logger(WARNING, BRIGHT_YELLOW) << "Invalid checkpoint found. Rollback blockchain to height=" << lastValidCheckpointHeight;
@@ -467,9 +768,10 @@ bool Blockchain::init(const std::string& config_folder, bool load_existing) {
   }
 
   update_next_comulative_size_limit();
+  publishTip();
 
-  uint64_t timestamp_diff = time(NULL) - m_blocks.back().bl.timestamp;
-  if (!m_blocks.back().bl.timestamp) {
+  uint64_t timestamp_diff = time(NULL) - m_headerIndex.timestamp(m_headerIndex.size() - 1);
+  if (!m_headerIndex.timestamp(m_headerIndex.size() - 1)) {
     timestamp_diff = time(NULL) - 1341378000;
   }
 
@@ -486,118 +788,738 @@ void Blockchain::rebuildCache() {
 
   std::chrono::steady_clock::time_point timePoint = std::chrono::steady_clock::now();
   m_blockIndex.clear();
-  m_transactionMap.clear();
-  m_spent_keys.clear();
-  m_outputs.clear();
-  m_multisignatureOutputs.clear();
-  for (uint32_t b = 0; b < m_blocks.size(); ++b) {
-    if (b % 1000 == 0) {
-      logger(INFO, BRIGHT_WHITE) << "Height " << b << " of " << m_blocks.size();
-    }
-
-    const BlockEntry& block = m_blocks[b];
-    Crypto::Hash blockHash = get_block_hash(block.bl);
-    m_blockIndex.push(blockHash);
-    uint64_t interest = 0;
-    for (uint16_t t = 0; t < block.transactions.size(); ++t) {
-      const TransactionEntry& transaction = block.transactions[t];
-      Crypto::Hash transactionHash = getObjectHash(transaction.tx);
-      TransactionIndex transactionIndex = { b, t };
-      m_transactionMap.insert(std::make_pair(transactionHash, transactionIndex));
-
-      // process inputs
-      for (auto& i : transaction.tx.inputs) {
-        if (i.type() == typeid(KeyInput)) {
-          m_spent_keys.insert(::boost::get<KeyInput>(i).keyImage);
-        } else if (i.type() == typeid(MultisignatureInput)) {
-          auto out = ::boost::get<MultisignatureInput>(i);
-          m_multisignatureOutputs[out.amount][out.outputIndex].isUsed = true;
+  clearBlockHeaders();
+  m_depositIndex.popBlocks(0);
+  if (!m_indexStorage) {
+    clearTransactionIndexes();
+  }
+
+  loadBlocks(0, [this](uint32_t height, const LoadedBlock& loadedBlock) {
+    m_blockIndex.push(loadedBlock.hash);
+    pushBlockHeader(loadedBlock.block);
+
+    // persistent indexes are brought up to date by updateIndexStorage()
+    if (!m_indexStorage) {
+      indexTransactions(loadedBlock.block, height, loadedBlock.transactionHashes);
+    }
+
+    pushToDepositIndex(loadedBlock.block, loadedBlock.interest);
+  });
+
+  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - timePoint;
+  logger(INFO, BRIGHT_WHITE) << "Rebuilding internal structures took: " << duration.count();
+}
+
+void Blockchain::loadBlocks(uint32_t startHeight, const std::function<void(uint32_t, const LoadedBlock&)>& handler) {
+  struct Slot {
+    BinaryArray blob;
+    LoadedBlock loadedBlock;
+    bool ready;
+  };
+
+  // A reader thread streams serialized blocks into a ring of slots, workers deserialize and hash them,
+  // and the calling thread hands them to the handler in height order, freeing the slot for the reader.
+  const uint32_t blockCount = static_cast<uint32_t>(m_blocks.size());
+  const size_t workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+  std::vector<Slot> slots(workerCount * LOAD_BLOCKS_PER_WORKER);
+  std::mutex mutex;
+  std::condition_variable readCondition;
+  std::condition_variable workCondition;
+  std::condition_variable handleCondition;
+  std::deque<uint32_t> workQueue;
+  uint32_t handledHeight = startHeight;
+  bool stopped = false;
+  std::exception_ptr error;
+
+  for (Slot& slot : slots) {
+    slot.ready = false;
+  }
+
+  auto stop = [&](std::exception_ptr exception) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (!error) {
+        error = exception;
+      }
+
+      stopped = true;
+    }
+
+    readCondition.notify_all();
+    workCondition.notify_all();
+    handleCondition.notify_all();
+  };
+
+  std::thread reader([&] {
+    try {
+      for (uint32_t b = startHeight; b < blockCount; ++b) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          readCondition.wait(lock, [&] { return stopped || b < handledHeight + slots.size(); });
+          if (stopped) {
+            return;
+          }
+        }
+
+        m_blocks.readBlob(b, slots[b % slots.size()].blob);
+
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          workQueue.push_back(b);
         }
+
+        workCondition.notify_one();
       }
+    } catch (...) {
+      stop(std::current_exception());
+    }
+  });
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < workerCount; ++i) {
+    workers.emplace_back([&] {
+      for (;;) {
+        uint32_t b;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          workCondition.wait(lock, [&] { return stopped || !workQueue.empty(); });
+          if (workQueue.empty()) {
+            return;
+          }
+
+          b = workQueue.front();
+          workQueue.pop_front();
+        }
 
-      // process outputs
-      for (uint16_t o = 0; o < transaction.tx.outputs.size(); ++o) {
-        const auto& out = transaction.tx.outputs[o];
-        if (out.target.type() == typeid(KeyOutput)) {
-          m_outputs[out.amount].push_back(std::make_pair<>(transactionIndex, o));
-        } else if (out.target.type() == typeid(MultisignatureOutput)) {
-          MultisignatureOutputUsage usage = { transactionIndex, o, false };
-          m_multisignatureOutputs[out.amount].push_back(usage);
+        Slot& slot = slots[b % slots.size()];
+        try {
+          LoadedBlock& loadedBlock = slot.loadedBlock;
+          loadedBlock.block = BlockEntry();
+          if (!fromBinaryArray(loadedBlock.block, slot.blob)) {
+            throw std::runtime_error("Failed to deserialize block " + std::to_string(b));
+          }
+
+          loadedBlock.hash = get_block_hash(loadedBlock.block.bl);
+          loadedBlock.transactionHashes.clear();
+          loadedBlock.interest = 0;
+          for (const TransactionEntry& transaction : loadedBlock.block.transactions) {
+            loadedBlock.transactionHashes.push_back(getObjectHash(transaction.tx));
+            loadedBlock.interest += m_currency.calculateTotalTransactionInterest(transaction.tx, b); //block.height shows 0 wrongly sometimes apparently
+          }
+        } catch (...) {
+          stop(std::current_exception());
+          return;
         }
+
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          slot.ready = true;
+        }
+
+        handleCondition.notify_all();
       }
+    });
+  }
 
-      interest += m_currency.calculateTotalTransactionInterest(transaction.tx, b); //block.height); //block.height shows 0 wrongly sometimes apparently
+  try {
+    std::chrono::steady_clock::time_point reportTime = std::chrono::steady_clock::now();
+    uint32_t reportHeight = startHeight;
+    for (uint32_t b = startHeight; b < blockCount; ++b) {
+      Slot& slot = slots[b % slots.size()];
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        handleCondition.wait(lock, [&] { return stopped || slot.ready; });
+        if (stopped) {
+          break;
+        }
+      }
+
+      handler(b, slot.loadedBlock);
+
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        slot.ready = false;
+        handledHeight = b + 1;
+      }
+
+      readCondition.notify_one();
+
+      if ((b + 1) % 1000 == 0) {
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - reportTime;
+        logger(INFO, BRIGHT_WHITE) << "Height " << b + 1 << " of " << blockCount << ", " <<
+          static_cast<uint64_t>((b + 1 - reportHeight) / std::max(duration.count(), 0.001)) << " blocks/s";
+        reportTime = std::chrono::steady_clock::now();
+        reportHeight = b + 1;
+      }
     }
+  } catch (...) {
+    stop(std::current_exception());
+  }
 
-    pushToDepositIndex(block, interest);
+  stop(nullptr);
+  reader.join();
+  for (std::thread& worker : workers) {
+    worker.join();
   }
 
-  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - timePoint;
-  logger(INFO, BRIGHT_WHITE) << "Rebuilding internal structures took: " << duration.count();
+  if (error) {
+    std::rethrow_exception(error);
+  }
 }
 
-bool Blockchain::storeCache() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+bool Blockchain::loadCache(BlockCacheJournal::Header& snapshot) {
+  BlockCacheSerializer loader(*this, Crypto::Hash(), logger.getLogger());
+  loader.load(appendPath(m_config_folder, m_currency.blocksCacheFileName()));
+  if (!loader.loaded()) {
+    return false;
+  }
+
+  m_difficultyState.reset(m_headerIndex.size(), mainChainReader());
+  m_nextDifficulty = 0;
+  snapshot = getCacheState();
+
+  // a checkpoint interrupted by a crash leaves two journals, the second one starting where the first one ends
+  bool replayed[2] = { false, false };
+  uint32_t recordCount = 0;
+  for (bool progress = true; progress;) {
+    progress = false;
+    for (size_t i = 0; i < 2; ++i) {
+      BlockCacheJournal::Header state = getCacheState();
+      BlockCacheJournal::Header header;
+      bool valid = true;
+      bool beyondStoredBlocks = false;
+      if (replayed[i] || !BlockCacheJournal::read(getCacheJournalFileName(i), header, [&](const BinaryArray& record) {
+        if (header.height != state.height || header.lastBlockHash != state.lastBlockHash) {
+          return false;
+        }
+
+        try {
+          valid = replayCacheRecord(record, beyondStoredBlocks);
+        } catch (std::exception&) {
+          valid = false;
+        }
+        recordCount += valid && !beyondStoredBlocks ? 1 : 0;
+        return valid && !beyondStoredBlocks;
+      })) {
+        continue;
+      }
+
+      if (!valid) {
+        return false;
+      }
+
+      if (beyondStoredBlocks) {
+        break;
+      }
+
+      if (header.height == state.height && header.lastBlockHash == state.lastBlockHash) {
+        replayed[i] = true;
+        progress = true;
+      }
+    }
+  }
+
+  uint32_t height = m_blockIndex.size();
+  if (height > m_blocks.size() || m_blockIndex.getTailId() != get_block_hash(m_blocks[height - 1].bl)) {
+    return false;
+  }
+
+  logger(INFO, BRIGHT_WHITE) << "Replayed " << recordCount << " cache journal records, applying " << m_blocks.size() - height << " more stored blocks";
+  loadBlocks(height, [this](uint32_t height, const LoadedBlock& loadedBlock) {
+    m_blockIndex.push(loadedBlock.hash);
+    pushBlockHeader(loadedBlock.block);
+    if (!m_indexStorage) {
+      indexTransactions(loadedBlock.block, height, loadedBlock.transactionHashes);
+    }
+
+    pushToDepositIndex(loadedBlock.block, loadedBlock.interest);
+  });
+
+  return true;
+}
 
-  logger(INFO, BRIGHT_WHITE) << "Saving blockchain...";
-  BlockCacheSerializer ser(*this, getTailId(), logger.getLogger());
-  if (!ser.save(appendPath(m_config_folder, m_currency.blocksCacheFileName()))) {
-    logger(ERROR, BRIGHT_RED) << "Failed to save blockchain cache";
+bool Blockchain::replayCacheRecord(const BinaryArray& record, bool& beyondStoredBlocks) {
+  bool pushed;
+  BlockCacheDelta delta;
+  try {
+    MemoryInputStream stream(record.data(), record.size());
+    BinaryInputStreamSerializer s(stream);
+    s(pushed, "pushed");
+    s(delta, "delta");
+  } catch (std::exception&) {
     return false;
   }
 
+  if (pushed) {
+    if (delta.height != m_blockIndex.size() || (delta.height != 0 && delta.previousBlockHash != m_blockIndex.getTailId())) {
+      return false;
+    }
+
+    // block storage is written without syncing, the journal may outlive the blocks it describes after a crash
+    if (delta.height >= m_blocks.size()) {
+      beyondStoredBlocks = true;
+      return true;
+    }
+
+    m_blockIndex.push(delta.blockHash);
+    pushBlockHeader(delta.timestamp, delta.cumulativeDifficulty, delta.blockCumulativeSize, delta.alreadyGeneratedCoins, delta.majorVersion);
+    if (!m_indexStorage) {
+      for (uint16_t t = 0; t < delta.transactionHashes.size(); ++t) {
+        TransactionIndex transactionIndex = { delta.height, t };
+        insertTransaction(delta.transactionHashes[t], transactionIndex);
+      }
+
+      for (const Crypto::KeyImage& keyImage : delta.keyImages) {
+        insertSpentKeyImage(keyImage);
+      }
+
+      // outputs first, an input of the block can only spend outputs that exist before it
+      for (const OutputDelta& output : delta.outputs) {
+        if (output.multisignature) {
+          MultisignatureOutputUsage usage = { output.transactionIndex, output.outputIndex, false };
+          pushMultisignatureOutput(output.amount, usage);
+        } else {
+          pushKeyOutput(output.amount, output.transactionIndex, output.outputIndex, output.unlockTime, output.key);
+        }
+      }
+
+      for (const MultisignatureInputDelta& input : delta.multisignatureInputs) {
+        setMultisignatureOutputUsed(input.amount, input.outputIndex, true);
+      }
+    }
+
+    m_depositIndex.pushBlock(delta.deposit, delta.interest);
+  } else {
+    if (m_blockIndex.size() == 0 || delta.height + 1 != m_blockIndex.size() || delta.blockHash != m_blockIndex.getTailId()) {
+      return false;
+    }
+
+    // reverted from the delta alone, the payment id and timestamp indices are only loaded after the cache
+    if (!m_indexStorage) {
+      for (const MultisignatureInputDelta& input : delta.multisignatureInputs) {
+        setMultisignatureOutputUsed(input.amount, input.outputIndex, false);
+      }
+
+      for (auto output = delta.outputs.rbegin(); output != delta.outputs.rend(); ++output) {
+        if (output->multisignature) {
+          popMultisignatureOutput(output->amount);
+        } else {
+          popKeyOutput(output->amount);
+        }
+      }
+
+      for (const Crypto::KeyImage& keyImage : delta.keyImages) {
+        eraseSpentKeyImage(keyImage);
+      }
+
+      for (const Crypto::Hash& transactionHash : delta.transactionHashes) {
+        eraseTransaction(transactionHash);
+      }
+    }
+
+    m_depositIndex.popBlock();
+    popBlockHeader();
+    m_blockIndex.pop();
+  }
+
   return true;
 }
 
+Blockchain::BlockCacheDelta Blockchain::makeCacheDelta(const BlockEntry& block, uint64_t interest) {
+  BlockCacheDelta delta;
+  // called while the block is the tail of m_blockIndex, both after pushing and before popping it
+  delta.blockHash = m_blockIndex.getTailId();
+  delta.previousBlockHash = block.bl.previousBlockHash;
+  delta.height = block.height;
+  delta.timestamp = block.bl.timestamp;
+  delta.cumulativeDifficulty = block.cumulative_difficulty;
+  delta.blockCumulativeSize = block.block_cumulative_size;
+  delta.alreadyGeneratedCoins = block.already_generated_coins;
+  delta.majorVersion = block.bl.majorVersion;
+  delta.deposit = 0;
+  delta.interest = interest;
+  for (uint16_t t = 0; t < block.transactions.size(); ++t) {
+    const Transaction& transaction = block.transactions[t].tx;
+    delta.deposit += getDepositChange(transaction);
+    if (m_indexStorage) {
+      continue;
+    }
+
+    delta.transactionHashes.push_back(t == 0 ? getObjectHash(block.bl.baseTransaction) : block.bl.transactionHashes[t - 1]);
+    for (const auto& input : transaction.inputs) {
+      if (input.type() == typeid(KeyInput)) {
+        delta.keyImages.push_back(::boost::get<KeyInput>(input).keyImage);
+      } else if (input.type() == typeid(MultisignatureInput)) {
+        const MultisignatureInput& in = ::boost::get<MultisignatureInput>(input);
+        MultisignatureInputDelta inputDelta = { in.amount, in.outputIndex };
+        delta.multisignatureInputs.push_back(inputDelta);
+      }
+    }
+
+    for (uint16_t o = 0; o < transaction.outputs.size(); ++o) {
+      const TransactionOutput& out = transaction.outputs[o];
+      OutputDelta output = OutputDelta();
+      output.amount = out.amount;
+      output.transactionIndex.block = block.height;
+      output.transactionIndex.transaction = t;
+      output.outputIndex = o;
+      if (out.target.type() == typeid(KeyOutput)) {
+        output.unlockTime = transaction.unlockTime;
+        output.key = ::boost::get<KeyOutput>(out.target).key;
+      } else if (out.target.type() == typeid(MultisignatureOutput)) {
+        output.multisignature = true;
+      } else {
+        continue;
+      }
+
+      delta.outputs.push_back(output);
+    }
+  }
+
+  return delta;
+}
+
+void Blockchain::journalBlock(bool pushed, const BlockEntry& block, uint64_t interest) {
+  if (!m_cacheJournal.isOpened()) {
+    // a new journal has to start from a snapshot, the next start rebuilds from the stored blocks until one is written
+    if (++m_cacheJournalRetryBlocks >= CACHE_JOURNAL_RETRY_INTERVAL) {
+      m_cacheJournalRetryBlocks = 0;
+      checkpointCache();
+    }
+
+    return;
+  }
+
+  BinaryArray record;
+  {
+    BlockCacheDelta delta = makeCacheDelta(block, interest);
+    VectorOutputStream stream(record);
+    BinaryOutputStreamSerializer s(stream);
+    s(pushed, "pushed");
+    s(delta, "delta");
+  }
+
+  // a lost push only means more stored blocks to apply, a lost pop leaves the cache ahead of them and forces a rebuild
+  bool written = m_cacheJournal.append(record);
+  if (written && (!pushed || m_cacheJournal.recordCount() % CACHE_JOURNAL_SYNC_INTERVAL == 0)) {
+    written = m_cacheJournal.sync();
+  }
+
+  if (!written) {
+    // without the journal the next start applies stored blocks on top of the last snapshot
+    logger(ERROR, BRIGHT_RED) << "Failed to write blockchain cache journal";
+    return;
+  }
+
+  if (m_cacheJournal.recordCount() >= CACHE_CHECKPOINT_INTERVAL) {
+    checkpointCache();
+  }
+}
+
+void Blockchain::startCacheJournal(const BlockCacheJournal::Header& snapshot) {
+  BlockCacheJournal::Header state = getCacheState();
+  if (snapshot.height == 0 || snapshot.height != state.height || snapshot.lastBlockHash != state.lastBlockHash) {
+    checkpointCache();
+    return;
+  }
+
+  boost::system::error_code ignore;
+  boost::filesystem::remove(getCacheJournalFileName(1 - m_cacheJournalIndex), ignore);
+  if (!m_cacheJournal.create(getCacheJournalFileName(m_cacheJournalIndex), state)) {
+    logger(ERROR, BRIGHT_RED) << "Failed to create blockchain cache journal";
+  }
+}
+
+void Blockchain::checkpointCache() {
+  if (m_cacheCheckpointRunning) {
+    return;
+  }
+
+  if (m_cacheCheckpointThread.joinable()) {
+    m_cacheCheckpointThread.join();
+  }
+
+  // the indexes are copied and the journal switched under the blockchain lock, serializing and writing happen without it
+  m_cacheCheckpointRunning = true;
+  m_cacheCheckpointThread = std::thread([this] {
+    std::unique_ptr<CacheSnapshot> snapshot;
+    Crypto::Hash lastBlockHash;
+    {
+      std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+      size_t journalIndex = 1 - m_cacheJournalIndex;
+      if (!m_cacheJournal.create(getCacheJournalFileName(journalIndex), getCacheState())) {
+        logger(ERROR, BRIGHT_RED) << "Failed to create blockchain cache journal";
+        m_cacheJournal.close();
+        m_cacheCheckpointRunning = false;
+        return;
+      }
+
+      m_cacheJournalIndex = journalIndex;
+      m_cacheJournalRetryBlocks = 0;
+      snapshot.reset(new CacheSnapshot{ m_blockIndex, m_headerIndex, m_transactionMap, m_spent_keys, m_outputs,
+        m_multisignatureOutputs, m_depositIndex });
+      lastBlockHash = getTailId();
+    }
+
+    BinaryArray data;
+    BlockCacheSerializer ser(*this, *snapshot, lastBlockHash, logger.getLogger());
+    if (!ser.save(data)) {
+      logger(ERROR, BRIGHT_RED) << "Failed to serialize blockchain cache";
+      m_cacheCheckpointRunning = false;
+      return;
+    }
+
+    snapshot.reset();
+    const std::string fileName = appendPath(m_config_folder, m_currency.blocksCacheFileName());
+    if (!BlockCacheJournal::replaceFile(fileName, data)) {
+      logger(ERROR, BRIGHT_RED) << "Failed to replace blockchain cache " << fileName;
+    }
+
+    m_cacheCheckpointRunning = false;
+  });
+}
+
+void Blockchain::stopCacheCheckpoint() {
+  if (m_cacheCheckpointThread.joinable()) {
+    m_cacheCheckpointThread.join();
+  }
+}
+
+BlockCacheJournal::Header Blockchain::getCacheState() const {
+  BlockCacheJournal::Header state = BlockCacheJournal::Header();
+  state.height = m_blockIndex.size();
+  if (state.height != 0) {
+    state.lastBlockHash = m_blockIndex.getTailId();
+  }
+
+  return state;
+}
+
+std::string Blockchain::getCacheJournalFileName(size_t index) const {
+  return appendPath(m_config_folder, m_currency.blocksCacheFileName()) + ".journal." + std::to_string(index);
+}
+
+bool Blockchain::openBlocks(const CoreConfig& config) {
+  const std::string blocksFileName = appendPath(config.configFolder, m_currency.blocksFileName());
+  const std::string blockIndexesFileName = appendPath(config.configFolder, m_currency.blockIndexesFileName());
+  if (config.dataBaseType == "file") {
+    return m_blocks.open(blocksFileName, blockIndexesFileName, config.blockCacheEntries, config.blockCacheBytes);
+  }
+
+  std::unique_ptr<ISwappedVectorStorage> storage;
+  std::string storageFileName;
+  if (config.dataBaseType == "mmap") {
+    storageFileName = appendPath(config.configFolder, m_currency.mappedBlocksFileName());
+    std::unique_ptr<SwappedVectorMappedStorage> mappedStorage(new SwappedVectorMappedStorage());
+    if (!mappedStorage->open(storageFileName, appendPath(config.configFolder, m_currency.mappedBlockOffsetsFileName()))) {
+      logger(ERROR, BRIGHT_RED) << "Failed to open mapped blocks " << storageFileName;
+      return false;
+    }
+
+    storage = std::move(mappedStorage);
+  } else {
+    storageFileName = appendPath(config.configFolder, m_currency.blockchainDataBaseFileName());
+    try {
+      m_dataBase.init(storageFileName);
+    } catch (const std::system_error& e) {
+      logger(ERROR, BRIGHT_RED) << "Failed to open blockchain database " << storageFileName << ": " << e.what();
+      return false;
+    }
+
+    m_indexStorage.reset(new DataBaseOverlay(m_dataBase));
+
+    std::unique_ptr<SwappedVectorLmdbStorage> lmdbStorage(new SwappedVectorLmdbStorage(m_dataBase, "blocks/"));
+    if (!lmdbStorage->open()) {
+      logger(ERROR, BRIGHT_RED) << "Failed to read blockchain database " << storageFileName;
+      return false;
+    }
+
+    storage = std::move(lmdbStorage);
+  }
+
+  // the marker is only written once every block of the file storage is imported, an interrupted import resumes
+  const std::string importedFileName = storageFileName + ".imported";
+  if (!std::ifstream(importedFileName) && std::ifstream(blocksFileName) && std::ifstream(blockIndexesFileName)) {
+    SwappedVectorFileStorage fileStorage;
+    if (fileStorage.open(blocksFileName, blockIndexesFileName)) {
+      uint64_t storedBlocks = storage->size();
+      if (storedBlocks != 0 && storedBlocks < fileStorage.size() && !sameItem(*storage, fileStorage, storedBlocks - 1)) {
+        logger(ERROR, BRIGHT_RED) << "Blocks in " << storageFileName << " don't match " << blocksFileName << ", import isn't resumed";
+        return false;
+      }
+
+      if (storedBlocks < fileStorage.size()) {
+        logger(INFO, BRIGHT_WHITE) << "Importing " << fileStorage.size() - storedBlocks << " blocks from " << blocksFileName << " into " << storageFileName << "...";
+        bool imported = storage->import(fileStorage, [this](uint64_t done, uint64_t total) {
+          if (done % 10000 == 0 || done == total) {
+            logger(INFO, BRIGHT_WHITE) << "Imported " << done << " of " << total << " blocks";
+          }
+        });
+
+        if (!imported) {
+          logger(ERROR, BRIGHT_RED) << "Failed to import blocks into " << storageFileName;
+          return false;
+        }
+      }
+
+      if (!std::ofstream(importedFileName)) {
+        logger(WARNING, BRIGHT_YELLOW) << "Failed to create " << importedFileName;
+      }
+    }
+  }
+
+  return m_blocks.open(std::move(storage), config.blockCacheEntries, config.blockCacheBytes);
+}
+
+void Blockchain::precomputeProofOfWork(const std::vector<const Block*>& blocks) {
+  std::vector<Crypto::Hash> blockHashes(blocks.size());
+  std::vector<Crypto::Hash> proofsOfWork(blocks.size());
+  std::vector<uint8_t> computed(blocks.size(), 0);
+
+  // pushBlock() doesn't look at the proof of work of blocks in the checkpoint zone
+  std::vector<size_t> pending;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (!m_checkpoints.is_in_checkpoint_zone(get_block_height(*blocks[i]))) {
+      pending.push_back(i);
+    }
+  }
+
+  // several blocks per job are hashed interleaved, as long as every thread still gets a job
+  size_t lanes = std::min(Crypto::cn_slow_hash_lanes(), std::max<size_t>(1, pending.size() / (m_workerPool.threadCount() + 1)));
+  m_workerPool.forEach((pending.size() + lanes - 1) / lanes, [&](size_t job) {
+    std::unique_ptr<Crypto::cn_context> context;
+    {
+      std::lock_guard<std::mutex> lk(m_proofOfWorkLock);
+      if (!m_proofOfWorkContexts.empty()) {
+        context = std::move(m_proofOfWorkContexts.back());
+        m_proofOfWorkContexts.pop_back();
+      }
+    }
+
+    if (!context) {
+      context.reset(new Crypto::cn_context());
+    }
+
+    size_t first = job * lanes;
+    size_t count = std::min(lanes, pending.size() - first);
+    std::vector<const Block*> jobBlocks(count);
+    std::vector<Crypto::Hash> jobProofsOfWork(count);
+    for (size_t k = 0; k < count; ++k) {
+      jobBlocks[k] = blocks[pending[first + k]];
+      blockHashes[pending[first + k]] = get_block_hash(*jobBlocks[k]);
+    }
+
+    if (get_block_longhash(*context, jobBlocks.data(), count, jobProofsOfWork.data())) {
+      for (size_t k = 0; k < count; ++k) {
+        proofsOfWork[pending[first + k]] = jobProofsOfWork[k];
+        computed[pending[first + k]] = 1;
+      }
+    }
+
+    std::lock_guard<std::mutex> lk(m_proofOfWorkLock);
+    m_proofOfWorkContexts.push_back(std::move(context));
+  });
+
+  std::lock_guard<std::mutex> lk(m_proofOfWorkLock);
+  if (m_proofOfWorkCache.size() + blocks.size() > PROOF_OF_WORK_CACHE_SIZE) {
+    m_proofOfWorkCache.clear();
+  }
+
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (computed[i]) {
+      m_proofOfWorkCache[blockHashes[i]] = proofsOfWork[i];
+    }
+  }
+}
+
+bool Blockchain::getProofOfWork(const Block& block, const Crypto::Hash& blockHash, Crypto::Hash& proofOfWork) {
+  {
+    std::lock_guard<std::mutex> lk(m_proofOfWorkLock);
+    auto it = m_proofOfWorkCache.find(blockHash);
+    if (it != m_proofOfWorkCache.end()) {
+      proofOfWork = it->second;
+      m_proofOfWorkCache.erase(it);
+      return true;
+    }
+  }
+
+  return get_block_longhash(m_cn_context, block, proofOfWork);
+}
+
+RawBlock Blockchain::getRawBlock(uint32_t height) {
+  ReadLock lk(*this);
+  assert(height < m_blocks.size());
+  std::vector<uint8_t> blob;
+  m_blocks.readBlob(height, blob);
+  return extractRawBlock(blob);
+}
+
 bool Blockchain::deinit() {
-  storeCache();
+  stopCacheCheckpoint();
+  {
+    std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+    m_cacheJournal.close();
+  }
+
   if (m_blockchainIndexesEnabled) {
     storeBlockchainIndices();
   }
+
+  if (m_dataBase.isInitialized()) {
+    m_dataBase.sync();
+  }
+
+  logger(DEBUGGING) << "Block cache hits: " << m_blocks.cacheHits() << ", misses: " << m_blocks.cacheMisses();
+  logger(DEBUGGING) << "Ring signature cache hits: " << m_ringSignatureCache.hits() << ", misses: " << m_ringSignatureCache.misses();
+  logger(DEBUGGING) << "Output key cache hits: " << m_outputKeyCache.hits() << ", misses: " << m_outputKeyCache.misses();
   assert(m_messageQueueList.empty());
   return true;
 }
 
 bool Blockchain::resetAndSetGenesisBlock(const Block& b) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  m_blocks.clear();
-  m_blockIndex.clear();
-  m_transactionMap.clear();
-
-  m_spent_keys.clear();
-  m_alternative_chains.clear();
-  m_outputs.clear();
+  {
+    WriteLock writeLock(*this);
+    m_cacheJournal.close();
+    m_blocks.clear();
+    m_blockIndex.clear();
+    clearBlockHeaders();
+    m_depositIndex.popBlocks(0);
+    clearTransactionIndexes();
+    m_alternative_chains.clear();
 
-  m_paymentIdIndex.clear();
-  m_timestampIndex.clear();
-  m_generatedTransactionsIndex.clear();
-  m_orthanBlocksIndex.clear();
+    m_paymentIdIndex.clear();
+    m_timestampIndex.clear();
+    m_generatedTransactionsIndex.clear();
+    m_orthanBlocksIndex.clear();
+  }
 
   block_verification_context bvc = boost::value_initialized<block_verification_context>();
   addNewBlock(b, bvc);
+  startCacheJournal(BlockCacheJournal::Header());
   return bvc.m_added_to_main_chain && !bvc.m_verification_failed;
 }
 
 Crypto::Hash Blockchain::getTailId(uint32_t& height) {
   assert(!m_blocks.empty());
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   height = getCurrentBlockchainHeight() - 1;
   return getTailId();
 }
 
 Crypto::Hash Blockchain::getTailId() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return m_blocks.empty() ? NULL_HASH : m_blockIndex.getTailId();
 }
 
 std::vector<Crypto::Hash> Blockchain::buildSparseChain() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   assert(m_blockIndex.size() != 0);
   return doBuildSparseChain(m_blockIndex.getTailId());
 }
 
 std::vector<Crypto::Hash> Blockchain::buildSparseChain(const Crypto::Hash& startBlockId) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   assert(haveBlock(startBlockId));
   return doBuildSparseChain(startBlockId);
 }
@@ -634,18 +1556,18 @@ std::vector<Crypto::Hash> Blockchain::doBuildSparseChain(const Crypto::Hash& sta
 }
 
 Crypto::Hash Blockchain::getBlockIdByHeight(uint32_t height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   assert(height < m_blockIndex.size());
   return m_blockIndex.getBlockId(height);
 }
 
 bool Blockchain::getBlockByHash(const Crypto::Hash& blockHash, Block& b) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
 
   uint32_t height = 0;
 
   if (m_blockIndex.getBlockHeight(blockHash, height)) {
-    b = m_blocks[height].bl;
+    readBlock(height, [&b](const BlockEntry& block) { b = block.bl; });
     return true;
   }
 
@@ -661,7 +1583,7 @@ bool Blockchain::getBlockByHash(const Crypto::Hash& blockHash, Block& b) {
 }
 
 bool Blockchain::getBlockHeight(const Crypto::Hash& blockId, uint32_t& blockHeight) {
-  std::lock_guard<decltype(m_blockchain_lock)> lock(m_blockchain_lock);
+  ReadLock lock(*this);
   return m_blockIndex.getBlockHeight(blockId, blockHeight);
 }
 
@@ -681,46 +1603,48 @@ uint8_t Blockchain::getForkVersion() {
 
 difficulty_type Blockchain::getDifficultyForNextBlock() {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  std::vector<uint64_t> timestamps;
-  std::vector<difficulty_type> commulative_difficulties;
-  uint8_t version = getForkVersion();
-  size_t difficultyBlocksCount;
-  auto height = getCurrentBlockchainHeight();
-
-  if (version == 0) {
-	  difficultyBlocksCount = static_cast<uint64_t>(m_currency.difficultyBlocksCount1()); 
+  if (m_nextDifficulty != 0) {
+    return m_nextDifficulty;
   }
-  else if (version == 1) {
-	  difficultyBlocksCount = static_cast<uint64_t>(m_currency.difficultyBlocksCount());
+
+  uint8_t version = getForkVersion();
+  if (version != 0) {
+    logger(DEBUGGING) << "Using Zawy's LWMA difficulty algo (v1 latest)";
+    assert(m_difficultyState.height() == m_blocks.size());
+    m_nextDifficulty = m_difficultyState.nextDifficulty(mainChainReader());
+    return m_nextDifficulty;
   }
+
+  std::vector<uint64_t> timestamps;
+  std::vector<difficulty_type> commulative_difficulties;
+  size_t difficultyBlocksCount = m_currency.difficultyBlocksCount1();
   size_t offset = m_blocks.size() - std::min(m_blocks.size(), static_cast<uint64_t>(difficultyBlocksCount));
   if (offset == 0) {
     ++offset;
   }
 
   for (; offset < m_blocks.size(); offset++) {
-    timestamps.push_back(m_blocks[offset].bl.timestamp);
-    commulative_difficulties.push_back(m_blocks[offset].cumulative_difficulty);
-  }
-  if (version == 0) {
-	  logger(DEBUGGING) << "Using legacy difficulty algo (v0)";
-	  return m_currency.nextDifficulty1(timestamps, commulative_difficulties);
+    timestamps.push_back(m_headerIndex.timestamp(static_cast<uint32_t>(offset)));
+    commulative_difficulties.push_back(m_headerIndex.cumulativeDifficulty(static_cast<uint32_t>(offset)));
   }
-  logger(DEBUGGING) << "Using Zawy's LWMA difficulty algo (v1 latest)";
-  return m_currency.nextDifficulty(timestamps, commulative_difficulties, height);
+
+  logger(DEBUGGING) << "Using legacy difficulty algo (v0)";
+  m_nextDifficulty = m_currency.nextDifficulty1(timestamps, commulative_difficulties);
+  return m_nextDifficulty;
 }
 
 uint64_t Blockchain::getBlockTimestamp(uint32_t height) {
+  ReadLock lk(*this);
   assert(height < m_blocks.size());
-  return m_blocks[height].bl.timestamp;
+  return m_headerIndex.timestamp(height);
 }
 
 uint64_t Blockchain::getCoinsInCirculation() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   if (m_blocks.empty()) {
     return 0;
   } else {
-    return m_blocks.back().already_generated_coins;
+    return m_headerIndex.generatedCoins(m_headerIndex.size() - 1);
   }
 }
 
@@ -733,20 +1657,17 @@ uint8_t Blockchain::getBlockMajorVersionForHeight(uint32_t height) const {
 }
 
 uint64_t Blockchain::coinsEmittedAtHeight(uint64_t height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  const auto& block = m_blocks[height];
-  return block.already_generated_coins;
+  ReadLock lk(*this);
+  return m_headerIndex.generatedCoins(static_cast<uint32_t>(height));
 }
 
 difficulty_type Blockchain::difficultyAtHeight(uint64_t height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  const auto& current = m_blocks[height];
+  ReadLock lk(*this);
   if (height < 1) {
-    return current.cumulative_difficulty;
+    return m_headerIndex.cumulativeDifficulty(0);
   }
 
-  const auto& previous = m_blocks[height - 1];
-  return current.cumulative_difficulty - previous.cumulative_difficulty;
+  return m_headerIndex.cumulativeDifficulty(static_cast<uint32_t>(height)) - m_headerIndex.cumulativeDifficulty(static_cast<uint32_t>(height - 1));
 }
 
 bool Blockchain::rollback_blockchain_switching(std::list<Block> &original_chain, size_t rollback_height) {
@@ -811,6 +1732,7 @@ bool Blockchain::switch_to_alternative_blockchain(std::list<blocks_ext_by_hash::
       rollback_blockchain_switching(disconnected_chain, split_height);
       //add_block_as_invalid(ch_ent->second, get_block_hash(ch_ent->second.bl));
       logger(INFO, BRIGHT_WHITE) << "The block was inserted as invalid while connecting new alternative chain,  block_id: " << get_block_hash(ch_ent->second.bl);
+      WriteLock writeLock(*this);
       m_orthanBlocksIndex.remove(ch_ent->second.bl);
       m_alternative_chains.erase(ch_ent);
 
@@ -842,10 +1764,13 @@ bool Blockchain::switch_to_alternative_blockchain(std::list<blocks_ext_by_hash::
   blocksFromCommonRoot.push_back(alt_chain.front()->second.bl.previousBlockHash);
 
   //removing all_chain entries from alternative chain
-  for (auto ch_ent : alt_chain) {
-    blocksFromCommonRoot.push_back(get_block_hash(ch_ent->second.bl));
-    m_orthanBlocksIndex.remove(ch_ent->second.bl);
-    m_alternative_chains.erase(ch_ent);
+  {
+    WriteLock writeLock(*this);
+    for (auto ch_ent : alt_chain) {
+      blocksFromCommonRoot.push_back(get_block_hash(ch_ent->second.bl));
+      m_orthanBlocksIndex.remove(ch_ent->second.bl);
+      m_alternative_chains.erase(ch_ent);
+    }
   }
 
   sendMessage(BlockchainMessage(ChainSwitchMessage(std::move(blocksFromCommonRoot))));
@@ -855,18 +1780,47 @@ bool Blockchain::switch_to_alternative_blockchain(std::list<blocks_ext_by_hash::
 }
 
 difficulty_type Blockchain::get_next_difficulty_for_alternative_chain(const std::list<blocks_ext_by_hash::iterator>& alt_chain, BlockEntry& bei) {
-  std::vector<uint64_t> timestamps;
-  std::vector<difficulty_type> commulative_difficulties;
   uint8_t version = getForkVersion();
-  size_t difficultyBlocksCount;
-  auto height = getCurrentBlockchainHeight();
+  if (version != 0) {
+    std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+    // the window is read from the main chain below the split height and from the alternative blocks above it
+    uint32_t splitHeight = alt_chain.empty() ? bei.height : alt_chain.front()->second.height;
+    std::vector<const BlockEntry*> altBlocks;
+    for (auto it : alt_chain) {
+      altBlocks.push_back(&it->second);
+    }
 
-  if (version == 0) {
-	  difficultyBlocksCount = static_cast<uint64_t>(m_currency.difficultyBlocksCount1());
-  }
-  else if (version == 1) {
-	  difficultyBlocksCount = static_cast<uint64_t>(m_currency.difficultyBlocksCount());
+    LwmaDifficultyState::BlockReader mainChain = mainChainReader();
+    LwmaDifficultyState::BlockReader chain = [&](uint32_t height, uint64_t& timestamp, difficulty_type& cumulativeDifficulty) {
+      if (height < splitHeight) {
+        mainChain(height, timestamp, cumulativeDifficulty);
+      } else {
+        timestamp = altBlocks[height - splitHeight]->bl.timestamp;
+        cumulativeDifficulty = altBlocks[height - splitHeight]->cumulative_difficulty;
+      }
+    };
+
+    // walk the main chain state back to the split and forward along the alternative chain, unless a fresh window is cheaper
+    LwmaDifficultyState state(m_difficultyState);
+    uint32_t height = splitHeight + static_cast<uint32_t>(altBlocks.size());
+    if (state.height() - splitHeight + altBlocks.size() > m_currency.difficultyWindowv1()) {
+      state.reset(height, chain);
+    } else {
+      while (state.height() > splitHeight) {
+        state.pop(mainChain);
+      }
+
+      while (state.height() < height) {
+        state.push(chain);
+      }
+    }
+
+    return state.nextDifficulty(chain);
   }
+
+  std::vector<uint64_t> timestamps;
+  std::vector<difficulty_type> commulative_difficulties;
+  size_t difficultyBlocksCount = m_currency.difficultyBlocksCount1();
   if (alt_chain.size() < difficultyBlocksCount) {
     std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
     size_t main_chain_stop_offset = alt_chain.size() ? alt_chain.front()->second.height : bei.height;
@@ -877,8 +1831,8 @@ difficulty_type Blockchain::get_next_difficulty_for_alternative_chain(const std:
     if (!main_chain_start_offset)
       ++main_chain_start_offset; //skip genesis block
     for (; main_chain_start_offset < main_chain_stop_offset; ++main_chain_start_offset) {
-      timestamps.push_back(m_blocks[main_chain_start_offset].bl.timestamp);
-      commulative_difficulties.push_back(m_blocks[main_chain_start_offset].cumulative_difficulty);
+      timestamps.push_back(m_headerIndex.timestamp(static_cast<uint32_t>(main_chain_start_offset)));
+      commulative_difficulties.push_back(m_headerIndex.cumulativeDifficulty(static_cast<uint32_t>(main_chain_start_offset)));
     }
 
     if (!((alt_chain.size() + timestamps.size()) <= difficultyBlocksCount)) {
@@ -903,10 +1857,7 @@ difficulty_type Blockchain::get_next_difficulty_for_alternative_chain(const std:
       }
     }
   }
-  if (version == 0) {
-	return m_currency.nextDifficulty1(timestamps, commulative_difficulties);
-  }
-  return m_currency.nextDifficulty(timestamps, commulative_difficulties, height);
+  return m_currency.nextDifficulty1(timestamps, commulative_difficulties);
 }
 
 bool Blockchain::prevalidate_miner_transaction(const Block& b, uint32_t height) {
@@ -995,7 +1946,7 @@ bool Blockchain::getBackwardBlocksSize(size_t from_height, std::vector<size_t>&
 
   size_t start_offset = (from_height + 1) - std::min((from_height + 1), count);
   for (size_t i = start_offset; i != from_height + 1; i++) {
-    sz.push_back(m_blocks[i].block_cumulative_size);
+    sz.push_back(m_headerIndex.cumulativeSize(static_cast<uint32_t>(i)));
   }
 
   return true;
@@ -1030,7 +1981,7 @@ bool Blockchain::complete_timestamps_vector(uint64_t start_top_height, std::vect
   size_t stop_offset = start_top_height > need_elements ? start_top_height - need_elements : 0;
 
   do {
-    timestamps.push_back(m_blocks[start_top_height].bl.timestamp);
+    timestamps.push_back(m_headerIndex.timestamp(static_cast<uint32_t>(start_top_height)));
     if (start_top_height == 0) {
       break;
     }
@@ -1154,7 +2105,7 @@ bool Blockchain::handle_alternative_block(const Block& b, const Crypto::Hash& id
     difficulty_type current_diff = get_next_difficulty_for_alternative_chain(alt_chain, bei);
     if (!(current_diff)) { logger(ERROR, BRIGHT_RED) << "!!!!!!! DIFFICULTY OVERHEAD !!!!!!!"; return false; }
     Crypto::Hash proof_of_work = NULL_HASH;
-    if (!m_currency.checkProofOfWork(m_cn_context, bei.bl, current_diff, proof_of_work)) {
+    if (!getProofOfWork(bei.bl, id, proof_of_work) || !m_currency.checkProofOfWork(bei.bl, current_diff, proof_of_work)) {
       logger(INFO, BRIGHT_RED) <<
         "Block with id: " << id
         << ENDL << " for alternative chain, have not enough proof of work: " << proof_of_work
@@ -1172,7 +2123,7 @@ bool Blockchain::handle_alternative_block(const Block& b, const Crypto::Hash& id
       return false;
     }
 
-    bei.cumulative_difficulty = alt_chain.size() ? it_prev->second.cumulative_difficulty : m_blocks[mainPrevHeight].cumulative_difficulty;
+    bei.cumulative_difficulty = alt_chain.size() ? it_prev->second.cumulative_difficulty : m_headerIndex.cumulativeDifficulty(mainPrevHeight);
     bei.cumulative_difficulty += current_diff;
 
 #ifdef _DEBUG
@@ -1180,14 +2131,20 @@ bool Blockchain::handle_alternative_block(const Block& b, const Crypto::Hash& id
     if (!(i_dres == m_alternative_chains.end())) { logger(ERROR, BRIGHT_RED) << "insertion of new alternative block returned as it already exist"; return false; }
 #endif
 
-    auto i_res = m_alternative_chains.insert(blocks_ext_by_hash::value_type(id, bei));
+    std::pair<blocks_ext_by_hash::iterator, bool> i_res;
+    {
+      WriteLock writeLock(*this);
+      i_res = m_alternative_chains.insert(blocks_ext_by_hash::value_type(id, bei));
+      if (i_res.second) {
+        m_orthanBlocksIndex.add(bei.bl);
+      }
+    }
+
     if (!(i_res.second)) {
       logger(ERROR, BRIGHT_RED) << "insertion of new alternative block returned as it already exist";
       return false;
     }
 
-    m_orthanBlocksIndex.add(bei.bl);
-
     alt_chain.push_back(i_res.first);
 
     if (is_a_checkpoint) {
@@ -1204,11 +2161,11 @@ bool Blockchain::handle_alternative_block(const Block& b, const Crypto::Hash& id
         bvc.m_verification_failed = true;
       }
       return r;
-    } else if (m_blocks.back().cumulative_difficulty < bei.cumulative_difficulty) //check if difficulty bigger then in main chain
+    } else if (m_headerIndex.cumulativeDifficulty(m_headerIndex.size() - 1) < bei.cumulative_difficulty) //check if difficulty bigger then in main chain
     {
       //do reorganize!
       logger(INFO, BRIGHT_GREEN) <<
-        "###### REORGANIZE on height: " << alt_chain.front()->second.height << " of " << m_blocks.size() - 1 << " with cum_difficulty " << m_blocks.back().cumulative_difficulty
+        "###### REORGANIZE on height: " << alt_chain.front()->second.height << " of " << m_blocks.size() - 1 << " with cum_difficulty " << m_headerIndex.cumulativeDifficulty(m_headerIndex.size() - 1)
         << ENDL << " alternative blockchain size: " << alt_chain.size() << " with cum_difficulty " << bei.cumulative_difficulty;
 
       bool r = switch_to_alternative_blockchain(alt_chain, false);
@@ -1241,55 +2198,54 @@ bool Blockchain::handle_alternative_block(const Block& b, const Crypto::Hash& id
 }
 
 bool Blockchain::getBlocks(uint32_t start_offset, uint32_t count, std::list<Block>& blocks, std::list<Transaction>& txs) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   if (start_offset >= m_blocks.size()) {
     return false;
   }
 
-  for (size_t i = start_offset; i < start_offset + count && i < m_blocks.size(); i++) {
-    blocks.push_back(m_blocks[i].bl);
-    std::list<Crypto::Hash> missed_ids;
-    getTransactions(m_blocks[i].bl.transactionHashes, txs, missed_ids);
-    if (!(!missed_ids.size())) {
-      logger(ERROR, BRIGHT_RED) << "have missed transactions in own block in main blockchain";
-      return false;
-    }
+  for (uint32_t i = start_offset; i < start_offset + count && i < m_blocks.size(); i++) {
+    // the stored block carries its transactions in transactionHashes order, no need to look them up by hash
+    readBlock(i, [&blocks, &txs](const BlockEntry& block) {
+      blocks.push_back(block.bl);
+      for (size_t j = 1; j < block.transactions.size(); ++j) {
+        txs.push_back(block.transactions[j].tx);
+      }
+    });
   }
 
   return true;
 }
 
 bool Blockchain::getBlocks(uint32_t start_offset, uint32_t count, std::list<Block>& blocks) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   if (start_offset >= m_blocks.size()) {
     return false;
   }
 
   for (uint32_t i = start_offset; i < start_offset + count && i < m_blocks.size(); i++) {
-    blocks.push_back(m_blocks[i].bl);
+    readBlock(i, [&blocks](const BlockEntry& block) { blocks.push_back(block.bl); });
   }
 
   return true;
 }
 
 bool Blockchain::handleGetObjects(NOTIFY_REQUEST_GET_OBJECTS::request& arg, NOTIFY_RESPONSE_GET_OBJECTS::request& rsp) { //Deprecated. Should be removed with CryptoNoteProtocolHandler.
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   rsp.current_blockchain_height = getCurrentBlockchainHeight();
-  std::list<Block> blocks;
-  getBlocks(arg.blocks, blocks, rsp.missed_ids);
-
-  for (const auto& bl : blocks) {
-    std::list<Crypto::Hash> missed_tx_id;
-    std::list<Transaction> txs;
-    getTransactions(bl.transactionHashes, txs, rsp.missed_ids);
-    if (!(!missed_tx_id.size())) { logger(ERROR, BRIGHT_RED) << "Internal error: have missed missed_tx_id.size()=" << missed_tx_id.size() << ENDL << "for block id = " << get_block_hash(bl); return false; } //WTF???
+  for (const auto& bl_id : arg.blocks) {
+    uint32_t height = 0;
+    if (!m_blockIndex.getBlockHeight(bl_id, height)) {
+      rsp.missed_ids.push_back(bl_id);
+      continue;
+    }
+
+    //cut out of the stored block, no need to pack it again
+    RawBlock rawBlock = getRawBlock(height);
     rsp.blocks.push_back(block_complete_entry());
     block_complete_entry& e = rsp.blocks.back();
-    //pack block
-    e.block = asString(toBinaryArray(bl));
-    //pack transactions
-    for (Transaction& tx : txs) {
-      e.txs.push_back(asString(toBinaryArray(tx)));
+    e.block = asString(rawBlock.block);
+    for (const BinaryArray& tx : rawBlock.transactions) {
+      e.txs.push_back(asString(tx));
     }
   }
 
@@ -1305,7 +2261,7 @@ bool Blockchain::handleGetObjects(NOTIFY_REQUEST_GET_OBJECTS::request& arg, NOTI
 }
 
 bool Blockchain::getAlternativeBlocks(std::list<Block>& blocks) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   for (auto& alt_bl : m_alternative_chains) {
     blocks.push_back(alt_bl.second.bl);
   }
@@ -1314,39 +2270,35 @@ bool Blockchain::getAlternativeBlocks(std::list<Block>& blocks) {
 }
 
 uint32_t Blockchain::getAlternativeBlocksCount() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return static_cast<uint32_t>(m_alternative_chains.size());
 }
 
-bool Blockchain::add_out_to_get_random_outs(std::vector<std::pair<TransactionIndex, uint16_t>>& amount_outs, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount& result_outs, uint64_t amount, size_t i) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  const Transaction& tx = transactionByIndex(amount_outs[i].first).tx;
-  if (!(tx.outputs.size() > amount_outs[i].second)) {
-    logger(ERROR, BRIGHT_RED) << "internal error: in global outs index, transaction out index="
-      << amount_outs[i].second << " more than transaction outputs = " << tx.outputs.size() << ", for tx id = " << getObjectHash(tx); return false;
-  }
-  if (!(tx.outputs[amount_outs[i].second].target.type() == typeid(KeyOutput))) { logger(ERROR, BRIGHT_RED) << "unknown tx out type"; return false; }
+bool Blockchain::add_out_to_get_random_outs(COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount& result_outs, uint64_t amount, size_t i) {
+  ReadLock lk(*this);
+  KeyOutputEntry amountOutput = getKeyOutput(amount, static_cast<uint32_t>(i));
 
   //check if transaction is unlocked
-  if (!is_tx_spendtime_unlocked(tx.unlockTime))
+  if (!is_tx_spendtime_unlocked(amountOutput.unlockTime))
     return false;
 
   COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::out_entry& oen = *result_outs.outs.insert(result_outs.outs.end(), COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::out_entry());
   oen.global_amount_index = static_cast<uint32_t>(i);
-  oen.out_key = boost::get<KeyOutput>(tx.outputs[amount_outs[i].second].target).key;
+  oen.out_key = amountOutput.key;
   return true;
 }
 
-size_t Blockchain::find_end_of_allowed_index(const std::vector<std::pair<TransactionIndex, uint16_t>>& amount_outs) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  if (amount_outs.empty()) {
+size_t Blockchain::find_end_of_allowed_index(uint64_t amount) {
+  ReadLock lk(*this);
+  uint32_t amountOutputCount = getKeyOutputCount(amount);
+  if (amountOutputCount == 0) {
     return 0;
   }
 
-  size_t i = amount_outs.size();
+  uint32_t i = amountOutputCount;
   do {
     --i;
-    if (amount_outs[i].first.block + m_currency.minedMoneyUnlockWindow() <= getCurrentBlockchainHeight()) {
+    if (getKeyOutput(amount, i).transactionIndex.block + m_currency.minedMoneyUnlockWindow() <= getCurrentBlockchainHeight()) {
       return i + 1;
     }
   } while (i != 0);
@@ -1355,25 +2307,24 @@ size_t Blockchain::find_end_of_allowed_index(const std::vector<std::pair<Transac
 }
 
 bool Blockchain::getRandomOutsByAmount(const COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::request& req, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::response& res) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
 
   for (uint64_t amount : req.amounts) {
     COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount& result_outs = *res.outs.insert(res.outs.end(), COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount());
     result_outs.amount = amount;
-    auto it = m_outputs.find(amount);
-    if (it == m_outputs.end()) {
+    uint32_t amountOutputCount = getKeyOutputCount(amount);
+    if (amountOutputCount == 0) {
       logger(ERROR, BRIGHT_RED) <<
         "COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS: not outs for amount " << amount << ", wallet should use some real outs when it lookup for some mix, so, at least one out for this amount should exist";
       continue;//actually this is strange situation, wallet should use some real outs when it lookup for some mix, so, at least one out for this amount should exist
     }
 
-    std::vector<std::pair<TransactionIndex, uint16_t>>& amount_outs = it->second;
     //it is not good idea to use top fresh outs, because it increases possibility of transaction canceling on split
     //lets find upper bound of not fresh outs
-    size_t up_index_limit = find_end_of_allowed_index(amount_outs);
-    if (!(up_index_limit <= amount_outs.size())) { logger(ERROR, BRIGHT_RED) << "internal error: find_end_of_allowed_index returned wrong index=" << up_index_limit << ", with amount_outs.size = " << amount_outs.size(); return false; }
+    size_t up_index_limit = find_end_of_allowed_index(amount);
+    if (!(up_index_limit <= amountOutputCount)) { logger(ERROR, BRIGHT_RED) << "internal error: find_end_of_allowed_index returned wrong index=" << up_index_limit << ", with amount_outs.size = " << amountOutputCount; return false; }
 
-    if(amount_outs.size() > req.outs_count)
+    if(amountOutputCount > req.outs_count)
     {
       std::set<size_t> used;
       size_t try_count = 0;
@@ -1385,7 +2336,7 @@ bool Blockchain::getRandomOutsByAmount(const COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_
         size_t i = (size_t)(frac*up_index_limit);
         if(used.count(i))
           continue;
-        bool added = add_out_to_get_random_outs(amount_outs, result_outs, amount, i);
+        bool added = add_out_to_get_random_outs(result_outs, amount, i);
         used.insert(i);
         if(added)
           ++j;
@@ -1394,7 +2345,7 @@ bool Blockchain::getRandomOutsByAmount(const COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_
      }else
     {
       for(size_t i = 0; i != up_index_limit; i++)
-        add_out_to_get_random_outs(amount_outs, result_outs, amount, i);
+        add_out_to_get_random_outs(result_outs, amount, i);
     }
   }
   return true;
@@ -1404,7 +2355,7 @@ uint32_t Blockchain::findBlockchainSupplement(const std::vector<Crypto::Hash>& q
   assert(!qblock_ids.empty());
   assert(qblock_ids.back() == m_blockIndex.getBlockId(0));
 
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   uint32_t blockIndex;
   // assert above guarantees that method returns true
   m_blockIndex.findSupplement(qblock_ids, blockIndex);
@@ -1415,9 +2366,9 @@ uint64_t Blockchain::blockDifficulty(size_t i) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   if (!(i < m_blocks.size())) { logger(ERROR, BRIGHT_RED) << "wrong block index i = " << i << " at Blockchain::block_difficulty()"; return false; }
   if (i == 0)
-    return m_blocks[i].cumulative_difficulty;
+    return m_headerIndex.cumulativeDifficulty(0);
 
-  return m_blocks[i].cumulative_difficulty - m_blocks[i - 1].cumulative_difficulty;
+  return m_headerIndex.cumulativeDifficulty(static_cast<uint32_t>(i)) - m_headerIndex.cumulativeDifficulty(static_cast<uint32_t>(i - 1));
 }
 
 void Blockchain::print_blockchain(uint64_t start_index, uint64_t end_index) {
@@ -1457,12 +2408,31 @@ void Blockchain::print_blockchain_index() {
 void Blockchain::print_blockchain_outs(const std::string& file) {
   std::stringstream ss;
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  for (const outputs_container::value_type& v : m_outputs) {
-    const std::vector<std::pair<TransactionIndex, uint16_t>>& vals = v.second;
-    if (!vals.empty()) {
-      ss << "amount: " << v.first << ENDL;
-      for (size_t i = 0; i != vals.size(); i++) {
-        ss << "\t" << getObjectHash(transactionByIndex(vals[i].first).tx) << ": " << vals[i].second << ENDL;
+  if (m_indexStorage) {
+    m_indexStorage->dataBase().readPrefix(INDEX_KEY_OUTPUT_COUNT_PREFIX, [&](const std::string& key, const std::string& value) {
+      uint64_t amount = 0;
+      for (size_t i = INDEX_KEY_OUTPUT_COUNT_PREFIX.size(); i < key.size(); ++i) {
+        amount = (amount << 8) | static_cast<uint8_t>(key[i]);
+      }
+
+      ss << "amount: " << amount << ENDL;
+      uint32_t count = static_cast<uint32_t>(unpackUInt(value, 0, sizeof(uint64_t)));
+      for (uint32_t i = 0; i != count; i++) {
+        KeyOutputEntry output = getKeyOutput(amount, i);
+        ss << "\t" << transactionHashByIndex(output.transactionIndex) << ": " << output.outputIndex << ENDL;
+      }
+
+      return true;
+    });
+  } else {
+    for (const outputs_container::value_type& v : m_outputs) {
+      const std::vector<uint64_t>& locations = v.second.locations;
+      if (!locations.empty()) {
+        ss << "amount: " << v.first << ENDL;
+        for (size_t i = 0; i != locations.size(); i++) {
+          KeyOutputEntry output = unpackOutputLocation(locations[i]);
+          ss << "\t" << transactionHashByIndex(output.transactionIndex) << ": " << output.outputIndex << ENDL;
+        }
       }
     }
   }
@@ -1482,7 +2452,7 @@ std::vector<Crypto::Hash> Blockchain::findBlockchainSupplement(const std::vector
   assert(!remoteBlockIds.empty());
   assert(remoteBlockIds.back() == m_blockIndex.getBlockId(0));
 
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   totalBlockCount = getCurrentBlockchainHeight();
   startBlockIndex = findBlockchainSupplement(remoteBlockIds);
 
@@ -1490,7 +2460,7 @@ std::vector<Crypto::Hash> Blockchain::findBlockchainSupplement(const std::vector
 }
 
 bool Blockchain::haveBlock(const Crypto::Hash& id) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   if (m_blockIndex.hasBlock(id))
     return true;
 
@@ -1501,41 +2471,42 @@ bool Blockchain::haveBlock(const Crypto::Hash& id) {
 }
 
 size_t Blockchain::getTotalTransactions() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  return m_transactionMap.size();
+  ReadLock lk(*this);
+  return getTransactionCount();
 }
 
 bool Blockchain::getTransactionOutputGlobalIndexes(const Crypto::Hash& tx_id, std::vector<uint32_t>& indexs) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  auto it = m_transactionMap.find(tx_id);
-  if (it == m_transactionMap.end()) {
+  ReadLock lk(*this);
+  TransactionIndex transactionIndex;
+  if (!findMainChainTransaction(tx_id, transactionIndex)) {
     logger(WARNING, YELLOW) << "warning: get_tx_outputs_gindexs failed to find transaction with id = " << tx_id;
     return false;
   }
 
-  const TransactionEntry& tx = transactionByIndex(it->second);
-  if (!(tx.m_global_output_indexes.size())) { logger(ERROR, BRIGHT_RED) << "internal error: global indexes for transaction " << tx_id << " is empty"; return false; }
-  indexs.resize(tx.m_global_output_indexes.size());
-  for (size_t i = 0; i < tx.m_global_output_indexes.size(); ++i) {
-    indexs[i] = tx.m_global_output_indexes[i];
-  }
+  readBlock(transactionIndex.block, [&indexs, &transactionIndex](const BlockEntry& block) {
+    indexs = block.transactions[transactionIndex.transaction].m_global_output_indexes;
+  });
 
+  if (!(indexs.size())) { logger(ERROR, BRIGHT_RED) << "internal error: global indexes for transaction " << tx_id << " is empty"; return false; }
   return true;
 }
 
 bool Blockchain::get_out_by_msig_gindex(uint64_t amount, uint64_t gindex, MultisignatureOutput& out) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  auto it = m_multisignatureOutputs.find(amount);
-  if (it == m_multisignatureOutputs.end()) {
+  ReadLock lk(*this);
+  if (getMultisignatureOutputCount(amount) <= gindex) {
     return false;
   }
 
-  if (it->second.size() <= gindex) {
+  auto msigUsage = getMultisignatureOutput(amount, static_cast<uint32_t>(gindex));
+  if (msigUsage.transactionIndex.block >= m_blocks.size()) {
     return false;
   }
 
-  auto msigUsage = it->second[gindex];
-  auto& targetOut = transactionByIndex(msigUsage.transactionIndex).tx.outputs[msigUsage.outputIndex].target;
+  TransactionOutputTarget targetOut;
+  readBlock(msigUsage.transactionIndex.block, [&targetOut, &msigUsage](const BlockEntry& block) {
+    targetOut = block.transactions[msigUsage.transactionIndex.transaction].tx.outputs[msigUsage.outputIndex].target;
+  });
+
   if (targetOut.type() != typeid(MultisignatureOutput)) {
     return false;
   }
@@ -1576,7 +2547,7 @@ bool Blockchain::checkTransactionInputs(const Transaction& tx, uint32_t* pmax_us
   return checkTransactionInputs(tx, tx_prefix_hash, pmax_used_block_height);
 }
 
-bool Blockchain::checkTransactionInputs(const Transaction& tx, const Crypto::Hash& tx_prefix_hash, uint32_t* pmax_used_block_height) {
+bool Blockchain::checkTransactionInputs(const Transaction& tx, const Crypto::Hash& tx_prefix_hash, uint32_t* pmax_used_block_height, std::vector<RingSignatureCheck>* deferredChecks) {
   size_t inputIndex = 0;
   if (pmax_used_block_height) {
     *pmax_used_block_height = 0;
@@ -1596,7 +2567,7 @@ bool Blockchain::checkTransactionInputs(const Transaction& tx, const Crypto::Has
         return false;
       }
 
-      if (!check_tx_input(in_to_key, tx_prefix_hash, tx.signatures[inputIndex], pmax_used_block_height)) {
+      if (!check_tx_input(in_to_key, tx_prefix_hash, tx.signatures[inputIndex], pmax_used_block_height, deferredChecks)) {
         logger(TRACE) <<
           "Failed ring signature validation for transaction " << transactionHash;
         return false;
@@ -1638,37 +2609,31 @@ bool Blockchain::is_tx_spendtime_unlocked(uint64_t unlock_time) {
   return false;
 }
 
-bool Blockchain::check_tx_input(const KeyInput& txin, const Crypto::Hash& tx_prefix_hash, const std::vector<Crypto::Signature>& sig, uint32_t* pmax_related_block_height) {
+bool Blockchain::check_tx_input(const KeyInput& txin, const Crypto::Hash& tx_prefix_hash, const std::vector<Crypto::Signature>& sig, uint32_t* pmax_related_block_height, std::vector<RingSignatureCheck>* deferredChecks) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   struct outputs_visitor {
-    std::vector<const Crypto::PublicKey *>& m_results_collector;
+    std::vector<Crypto::PublicKey>& m_results_collector;
     Blockchain& m_bch;
     LoggerRef logger;
-    outputs_visitor(std::vector<const Crypto::PublicKey *>& results_collector, Blockchain& bch, ILogger& logger) :m_results_collector(results_collector), m_bch(bch), logger(logger, "outputs_visitor") {
+    outputs_visitor(std::vector<Crypto::PublicKey>& results_collector, Blockchain& bch, ILogger& logger) :m_results_collector(results_collector), m_bch(bch), logger(logger, "outputs_visitor") {
     }
 
-    bool handle_output(const Transaction& tx, const TransactionOutput& out, size_t transactionOutputIndex) {
+    bool handle_output(const KeyOutputEntry& output) {
       //check tx unlock time
-      if (!m_bch.is_tx_spendtime_unlocked(tx.unlockTime)) {
+      if (!m_bch.is_tx_spendtime_unlocked(output.unlockTime)) {
         logger(INFO, BRIGHT_WHITE) <<
-          "One of outputs for one of inputs have wrong tx.unlockTime = " << tx.unlockTime;
+          "One of outputs for one of inputs have wrong tx.unlockTime = " << output.unlockTime;
         return false;
       }
 
-      if (out.target.type() != typeid(KeyOutput)) {
-        logger(INFO, BRIGHT_WHITE) <<
-          "Output have wrong type id, which=" << out.target.which();
-        return false;
-      }
-
-      m_results_collector.push_back(&boost::get<KeyOutput>(out.target).key);
+      m_results_collector.push_back(output.key);
       return true;
     }
   };
 
   //check ring signature
-  std::vector<const Crypto::PublicKey *> output_keys;
+  std::vector<Crypto::PublicKey> output_keys;
   outputs_visitor vi(output_keys, *this, logger.getLogger());
   if (!scanOutputKeysForIndexes(txin, vi, pmax_related_block_height)) {
     logger(INFO, BRIGHT_WHITE) <<
@@ -1677,24 +2642,115 @@ bool Blockchain::check_tx_input(const KeyInput& txin, const Crypto::Hash& tx_pre
     return false;
   }
 
-  if (txin.outputIndexes.size() != output_keys.size()) {
-    logger(INFO, BRIGHT_WHITE) <<
-      "Output keys for tx with amount = " << txin.amount << " and count indexes " << txin.outputIndexes.size() << " returned wrong keys count " << output_keys.size();
-    return false;
+  if (txin.outputIndexes.size() != output_keys.size()) {
+    logger(INFO, BRIGHT_WHITE) <<
+      "Output keys for tx with amount = " << txin.amount << " and count indexes " << txin.outputIndexes.size() << " returned wrong keys count " << output_keys.size();
+    return false;
+  }
+
+  if (!(sig.size() == output_keys.size())) { logger(ERROR, BRIGHT_RED) << "internal error: tx signatures count=" << sig.size() << " mismatch with outputs keys count for inputs=" << output_keys.size(); return false; }
+  if (m_is_in_checkpoint_zone) {
+    return true;
+  }
+
+  RingSignatureCheck check;
+  check.transaction = 0;
+  check.prefixHash = tx_prefix_hash;
+  check.keyImage = txin.keyImage;
+  check.keys = std::move(output_keys);
+  check.signatures = sig.data();
+  if (deferredChecks) {
+    deferredChecks->push_back(std::move(check));
+    return true;
+  }
+
+  return checkRingSignature(check);
+}
+
+bool Blockchain::checkRingSignature(const RingSignatureCheck& check) {
+  Crypto::Hash cacheKey = RingSignatureCache::makeKey(check.prefixHash, check.keyImage, check.keys, check.signatures);
+  if (m_ringSignatureCache.contains(cacheKey)) {
+    return true;
+  }
+
+  static const Crypto::KeyImage I = { {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } };
+  static const Crypto::KeyImage L = { {0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10 } };
+  if (!(scalarmultKey(check.keyImage, L) == I)) {
+    return false;
+  }
+
+  std::vector<std::shared_ptr<const Crypto::RingMemberTables>> members;
+  std::vector<const Crypto::RingMemberTables*> memberPointers;
+  members.reserve(check.keys.size());
+  memberPointers.reserve(check.keys.size());
+  for (const Crypto::PublicKey& key : check.keys) {
+    members.push_back(m_outputKeyCache.get(key));
+    if (!members.back()) {
+      return false;
+    }
+
+    memberPointers.push_back(members.back().get());
+  }
+
+  if (!Crypto::check_ring_signature(check.prefixHash, check.keyImage, memberPointers.data(), memberPointers.size(), check.signatures)) {
+    return false;
+  }
+
+  m_ringSignatureCache.insert(cacheKey);
+  return true;
+}
+
+bool Blockchain::verifyRingSignatures(const std::vector<RingSignatureCheck>& checks, size_t& failedTransaction) {
+  // checks only read their own data, so they run outside of any chain state and in any order
+  std::vector<uint8_t> valid(checks.size(), 0);
+  m_workerPool.forEach(checks.size(), [&](size_t i) {
+    valid[i] = checkRingSignature(checks[i]) ? 1 : 0;
+  });
+
+  for (size_t i = 0; i < checks.size(); ++i) {
+    if (!valid[i]) {
+      failedTransaction = checks[i].transaction;
+      return false;
+    }
   }
 
-  if (!(sig.size() == output_keys.size())) { logger(ERROR, BRIGHT_RED) << "internal error: tx signatures count=" << sig.size() << " mismatch with outputs keys count for inputs=" << output_keys.size(); return false; }
-  if (m_is_in_checkpoint_zone) {
-    return true;
+  return true;
+}
+
+void Blockchain::verifyTransactionsInputs(const std::vector<const Transaction*>& transactions, std::vector<bool>& valid) {
+  std::vector<Crypto::Hash> prefixHashes(transactions.size());
+  for (size_t i = 0; i < transactions.size(); ++i) {
+    prefixHashes[i] = getObjectHash(*static_cast<const TransactionPrefix*>(transactions[i]));
   }
 
-  static const Crypto::KeyImage I = { {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } };
-  static const Crypto::KeyImage L = { {0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10 } };
-  if (!(scalarmultKey(txin.keyImage, L) == I)) {
-    return false;
+  valid.assign(transactions.size(), true);
+  std::vector<RingSignatureCheck> checks;
+  {
+    std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+    for (size_t i = 0; i < transactions.size(); ++i) {
+      size_t checkCount = checks.size();
+      if (!checkTransactionInputs(*transactions[i], prefixHashes[i], NULL, &checks)) {
+        valid[i] = false;
+        checks.resize(checkCount);
+        continue;
+      }
+
+      for (size_t j = checkCount; j < checks.size(); ++j) {
+        checks[j].transaction = i;
+      }
+    }
   }
 
-  return Crypto::check_ring_signature(tx_prefix_hash, txin.keyImage, output_keys, sig.data());
+  std::vector<uint8_t> verified(checks.size(), 0);
+  m_workerPool.forEach(checks.size(), [&](size_t i) {
+    verified[i] = checkRingSignature(checks[i]) ? 1 : 0;
+  });
+
+  for (size_t i = 0; i < checks.size(); ++i) {
+    if (!verified[i]) {
+      valid[checks[i].transaction] = false;
+    }
+  }
 }
 
 uint64_t Blockchain::get_adjusted_time() {
@@ -1715,7 +2771,7 @@ bool Blockchain::check_block_timestamp_main(const Block& b) {
   std::vector<uint64_t> timestamps;
   size_t offset = m_blocks.size() <= m_currency.timestampCheckWindow() ? 0 : m_blocks.size() - m_currency.timestampCheckWindow();
   for (; offset != m_blocks.size(); ++offset) {
-    timestamps.push_back(m_blocks[offset].bl.timestamp);
+    timestamps.push_back(m_headerIndex.timestamp(static_cast<uint32_t>(offset)));
   }
 
   return check_block_timestamp(std::move(timestamps), b);
@@ -1867,6 +2923,11 @@ bool Blockchain::addNewBlock(const Block& bl_, block_verification_context& bvc)
   return add_result;
 }
 
+Crypto::Hash Blockchain::transactionHashByIndex(TransactionIndex index) {
+  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  return getObjectHash(transactionByIndex(index).tx);
+}
+
 const Blockchain::TransactionEntry& Blockchain::transactionByIndex(TransactionIndex index) {
   return m_blocks[index.block].transactions[index.transaction];
 }
@@ -1883,6 +2944,7 @@ bool Blockchain::pushBlock(const Block& blockData, block_verification_context& b
     return false;
   }
 
+  m_tx_pool.on_blockchain_inc(height, getTailId(), transactions);
   return true;
 }
 
@@ -1946,7 +3008,7 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
       return false;
     }
   } else {
-    if (!m_currency.checkProofOfWork(m_cn_context, blockData, currentDifficulty, proof_of_work)) {
+    if (!getProofOfWork(blockData, blockHash, proof_of_work) || !m_currency.checkProofOfWork(blockData, currentDifficulty, proof_of_work)) {
       logger(INFO, BRIGHT_WHITE) <<
         "Block " << blockHash << ", has too weak proof of work: " << proof_of_work << ", expected difficulty: " << currentDifficulty;
       bvc.m_verification_failed = true;
@@ -1971,6 +3033,7 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
   block.transactions.resize(1);
   block.transactions[0].tx = blockData.baseTransaction;
   TransactionIndex transactionIndex = { block.height, static_cast<uint16_t>(0) };
+  WriteLock writeLock(*this);
   pushTransaction(block, minerTransactionHash, transactionIndex);
 
   size_t coinbase_blob_size = getObjectBinarySize(blockData.baseTransaction);
@@ -1978,6 +3041,9 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
   uint64_t fee_summary = 0;
   uint64_t interestSummary = 0;
 
+  // Inputs are resolved and key images marked spent transaction by transaction, ring signatures are collected
+  // and verified together on the worker pool once the whole block passed the cheap checks.
+  std::vector<RingSignatureCheck> ringSignatureChecks;
   for (size_t i = 0; i < transactions.size(); ++i) {
     const Crypto::Hash& tx_id = blockData.transactionHashes[i];
     block.transactions.resize(block.transactions.size() + 1);
@@ -1994,11 +3060,16 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
       logger(INFO, BRIGHT_WHITE) << "Block " << blockHash << " can't contain transaction " << tx_id << " because it has invalid version " << transactions[i].version;
     }
 
-    if (!checkTransactionInputs(transactions[i])) {
+    size_t checkCount = ringSignatureChecks.size();
+    if (!checkTransactionInputs(transactions[i], getObjectHash(*static_cast<const TransactionPrefix*>(&transactions[i])), NULL, &ringSignatureChecks)) {
       isTransactionValid = false;
       logger(INFO, BRIGHT_WHITE) << "Block " << blockHash << " has at least one transaction with wrong inputs: " << tx_id;
     }
 
+    for (size_t j = checkCount; j < ringSignatureChecks.size(); ++j) {
+      ringSignatureChecks[j].transaction = i;
+    }
+
     if (!isTransactionValid) {
       logger(INFO, BRIGHT_WHITE) << "Block " << blockHash << " has at least one invalid transaction: " << tx_id;
       bvc.m_verification_failed = true;
@@ -2016,6 +3087,18 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
     interestSummary += m_currency.calculateTotalTransactionInterest(transactions[i], block.height);
   }
 
+  // readers may go on while the signatures are checked, they skip transactions of blocks beyond m_blocks
+  writeLock.unlock();
+  size_t failedTransaction = 0;
+  bool ringSignaturesValid = verifyRingSignatures(ringSignatureChecks, failedTransaction);
+  writeLock.lock();
+  if (!ringSignaturesValid) {
+    logger(INFO, BRIGHT_WHITE) << "Block " << blockHash << " has at least one transaction with wrong inputs: " << blockData.transactionHashes[failedTransaction];
+    bvc.m_verification_failed = true;
+    popTransactions(block, minerTransactionHash);
+    return false;
+  }
+
   if (!checkCumulativeBlockSize(blockHash, cumulative_block_size, block.height)) {
     bvc.m_verification_failed = true;
     return false;
@@ -2023,7 +3106,7 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
 
   int64_t emissionChange = 0;
   uint64_t reward = 0;
-  uint64_t already_generated_coins = m_blocks.empty() ? 0 : m_blocks.back().already_generated_coins;
+  uint64_t already_generated_coins = m_blocks.empty() ? 0 : m_headerIndex.generatedCoins(m_headerIndex.size() - 1);
   if (!validate_miner_transaction(blockData, block.height, cumulative_block_size, already_generated_coins, fee_summary, reward, emissionChange)) {
     logger(INFO, BRIGHT_WHITE) << "Block " << blockHash << " has invalid miner transaction";
     bvc.m_verification_failed = true;
@@ -2036,11 +3119,10 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
   block.cumulative_difficulty = currentDifficulty;
   block.already_generated_coins = already_generated_coins + emissionChange + interestSummary;
   if (m_blocks.size() > 0) {
-    block.cumulative_difficulty += m_blocks.back().cumulative_difficulty;
+    block.cumulative_difficulty += m_headerIndex.cumulativeDifficulty(m_headerIndex.size() - 1);
   }
 
-  pushBlock(block);
-  pushToDepositIndex(block, interestSummary);
+  pushBlock(block, interestSummary);
 
   auto block_processing_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - blockProcessingStart).count();
 
@@ -2063,59 +3145,51 @@ bool Blockchain::pushBlock(const Block& blockData, const std::vector<Transaction
 }
 
 uint64_t Blockchain::fullDepositAmount() const {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return m_depositIndex.fullDepositAmount();
 }
 
 uint64_t Blockchain::depositAmountAtHeight(size_t height) const {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return m_depositIndex.depositAmountAtHeight(static_cast<DepositIndex::DepositHeight>(height));
 }
 
 uint64_t Blockchain::fullDepositInterest() const {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return m_depositIndex.fullInterestAmount();
 }
 
 uint64_t Blockchain::depositInterestAtHeight(size_t height) const {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return m_depositIndex.depositInterestAtHeight(static_cast<DepositIndex::DepositHeight>(height));
 }
 
 void Blockchain::pushToDepositIndex(const BlockEntry& block, uint64_t interest) {
   int64_t deposit = 0;
   for (const auto& tx : block.transactions) {
-    for (const auto& in : tx.tx.inputs) {
-      if (in.type() == typeid(MultisignatureInput)) {
-        auto& multisign = boost::get<MultisignatureInput>(in);
-        if (multisign.term > 0) {
-          deposit -= multisign.amount;
-        }
-      }
-    }
-    for (const auto& out : tx.tx.outputs) {
-      if (out.target.type() == typeid(MultisignatureOutput)) {
-        auto& multisign = boost::get<MultisignatureOutput>(out.target);
-        if (multisign.term > 0) {
-          deposit += out.amount;
-        }
-      }
-    }
+    deposit += getDepositChange(tx.tx);
   }
   m_depositIndex.pushBlock(deposit, interest);
 }
 
-bool Blockchain::pushBlock(BlockEntry& block) {
+bool Blockchain::pushBlock(BlockEntry& block, uint64_t interest) {
   Crypto::Hash blockHash = get_block_hash(block.bl);
 
   m_blocks.push_back(block);
   m_blockIndex.push(blockHash);
+  pushBlockHeader(block);
+
+  // indexes go to disk after the block itself, so a crash in between is repaired by updateIndexStorage()
+  commitIndexStorage(m_blockIndex.size());
+  pushToDepositIndex(block, interest);
+  journalBlock(true, block, interest);
 
   m_timestampIndex.add(block.bl.timestamp, blockHash);
   m_generatedTransactionsIndex.add(block.bl);
 
   assert(m_blockIndex.size() == m_blocks.size());
 
+  publishTip();
   return true;
 }
 
@@ -2135,6 +3209,7 @@ void Blockchain::popBlock() {
   uint32_t height = m_blocks.size(); //height of popped block should be same as number of blocks
   saveTransactions(transactions, height);
   removeLastBlock();
+  m_tx_pool.on_blockchain_dec(m_blocks.size(), getTailId());
 
   m_upgradeDetectorv1.blockPopped();
   m_upgradeDetectorv2.blockPopped();
@@ -2143,8 +3218,7 @@ void Blockchain::popBlock() {
 }
 
 bool Blockchain::pushTransaction(BlockEntry& block, const Crypto::Hash& transactionHash, TransactionIndex transactionIndex) {
-  auto result = m_transactionMap.insert(std::make_pair(transactionHash, transactionIndex));
-  if (!result.second) {
+  if (!insertTransaction(transactionHash, transactionIndex)) {
     logger(ERROR, BRIGHT_RED) <<
       "Duplicate transaction was pushed to blockchain.";
 
@@ -2157,22 +3231,23 @@ bool Blockchain::pushTransaction(BlockEntry& block, const Crypto::Hash& transact
     logger(ERROR, BRIGHT_RED) <<
       "Double spending transaction was pushed to blockchain.";
 
-    m_transactionMap.erase(transactionHash);
+    eraseTransaction(transactionHash);
     return false;
   }
 
   for (size_t i = 0; i < transaction.tx.inputs.size(); ++i) {
     if (transaction.tx.inputs[i].type() == typeid(KeyInput)) {
-      auto result = m_spent_keys.insert(::boost::get<KeyInput>(transaction.tx.inputs[i]).keyImage);
-      if (!result.second) {
+      if (!insertSpentKeyImage(::boost::get<KeyInput>(transaction.tx.inputs[i]).keyImage)) {
         logger(ERROR, BRIGHT_RED) <<
           "Double spending transaction was pushed to blockchain.";
 
         for (size_t j = 0; j < i; ++j) {
-          m_spent_keys.erase(::boost::get<KeyInput>(transaction.tx.inputs[i - 1 - j]).keyImage);
+          if (transaction.tx.inputs[i - 1 - j].type() == typeid(KeyInput)) {
+            eraseSpentKeyImage(::boost::get<KeyInput>(transaction.tx.inputs[i - 1 - j]).keyImage);
+          }
         }
 
-        m_transactionMap.erase(transactionHash);
+        eraseTransaction(transactionHash);
         return false;
       }
     }
@@ -2181,22 +3256,18 @@ bool Blockchain::pushTransaction(BlockEntry& block, const Crypto::Hash& transact
   for (const auto& inv : transaction.tx.inputs) {
     if (inv.type() == typeid(MultisignatureInput)) {
       const MultisignatureInput& in = ::boost::get<MultisignatureInput>(inv);
-      auto& amountOutputs = m_multisignatureOutputs[in.amount];
-      amountOutputs[in.outputIndex].isUsed = true;
+      setMultisignatureOutputUsed(in.amount, in.outputIndex, true);
     }
   }
 
   transaction.m_global_output_indexes.resize(transaction.tx.outputs.size());
   for (uint16_t output = 0; output < transaction.tx.outputs.size(); ++output) {
     if (transaction.tx.outputs[output].target.type() == typeid(KeyOutput)) {
-      auto& amountOutputs = m_outputs[transaction.tx.outputs[output].amount];
-      transaction.m_global_output_indexes[output] = static_cast<uint32_t>(amountOutputs.size());
-      amountOutputs.push_back(std::make_pair<>(transactionIndex, output));
+      transaction.m_global_output_indexes[output] = pushKeyOutput(transaction.tx.outputs[output].amount, transactionIndex, output,
+        transaction.tx.unlockTime, boost::get<KeyOutput>(transaction.tx.outputs[output].target).key);
     } else if (transaction.tx.outputs[output].target.type() == typeid(MultisignatureOutput)) {
-      auto& amountOutputs = m_multisignatureOutputs[transaction.tx.outputs[output].amount];
-      transaction.m_global_output_indexes[output] = static_cast<uint32_t>(amountOutputs.size());
       MultisignatureOutputUsage outputUsage = { transactionIndex, output, false };
-      amountOutputs.push_back(outputUsage);
+      transaction.m_global_output_indexes[output] = pushMultisignatureOutput(transaction.tx.outputs[output].amount, outputUsage);
     }
   }
 
@@ -2205,111 +3276,123 @@ bool Blockchain::pushTransaction(BlockEntry& block, const Crypto::Hash& transact
   return true;
 }
 
+void Blockchain::indexTransactions(const BlockEntry& block, uint32_t height, const std::vector<Crypto::Hash>& transactionHashes) {
+  for (uint16_t t = 0; t < block.transactions.size(); ++t) {
+    const TransactionEntry& transaction = block.transactions[t];
+    TransactionIndex transactionIndex = { height, t };
+    insertTransaction(transactionHashes[t], transactionIndex);
+
+    // process inputs
+    for (auto& i : transaction.tx.inputs) {
+      if (i.type() == typeid(KeyInput)) {
+        insertSpentKeyImage(::boost::get<KeyInput>(i).keyImage);
+      } else if (i.type() == typeid(MultisignatureInput)) {
+        auto out = ::boost::get<MultisignatureInput>(i);
+        setMultisignatureOutputUsed(out.amount, out.outputIndex, true);
+      }
+    }
+
+    // process outputs
+    for (uint16_t o = 0; o < transaction.tx.outputs.size(); ++o) {
+      const auto& out = transaction.tx.outputs[o];
+      if (out.target.type() == typeid(KeyOutput)) {
+        pushKeyOutput(out.amount, transactionIndex, o, transaction.tx.unlockTime, boost::get<KeyOutput>(out.target).key);
+      } else if (out.target.type() == typeid(MultisignatureOutput)) {
+        MultisignatureOutputUsage usage = { transactionIndex, o, false };
+        pushMultisignatureOutput(out.amount, usage);
+      }
+    }
+  }
+}
+
 void Blockchain::popTransaction(const Transaction& transaction, const Crypto::Hash& transactionHash) {
-  TransactionIndex transactionIndex = m_transactionMap.at(transactionHash);
+  TransactionIndex transactionIndex;
+  if (!findTransaction(transactionHash, transactionIndex)) {
+    throw std::out_of_range("Blockchain::popTransaction");
+  }
+
   for (size_t outputIndex = 0; outputIndex < transaction.outputs.size(); ++outputIndex) {
     const TransactionOutput& output = transaction.outputs[transaction.outputs.size() - 1 - outputIndex];
     if (output.target.type() == typeid(KeyOutput)) {
-      auto amountOutputs = m_outputs.find(output.amount);
-      if (amountOutputs == m_outputs.end()) {
+      uint32_t amountOutputCount = getKeyOutputCount(output.amount);
+      if (amountOutputCount == 0) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - cannot find specific amount in outputs map.";
 
         continue;
       }
 
-      if (amountOutputs->second.empty()) {
-        logger(ERROR, BRIGHT_RED) <<
-          "Blockchain consistency broken - output array for specific amount is empty.";
-
-        continue;
-      }
-
-      if (amountOutputs->second.back().first.block != transactionIndex.block || amountOutputs->second.back().first.transaction != transactionIndex.transaction) {
+      KeyOutputEntry lastOutput = getKeyOutput(output.amount, amountOutputCount - 1);
+      if (lastOutput.transactionIndex.block != transactionIndex.block || lastOutput.transactionIndex.transaction != transactionIndex.transaction) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid transaction index.";
 
         continue;
       }
 
-      if (amountOutputs->second.back().second != transaction.outputs.size() - 1 - outputIndex) {
+      if (lastOutput.outputIndex != transaction.outputs.size() - 1 - outputIndex) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid output index.";
 
         continue;
       }
 
-      amountOutputs->second.pop_back();
-      if (amountOutputs->second.empty()) {
-        m_outputs.erase(amountOutputs);
-      }
+      popKeyOutput(output.amount);
     } else if (output.target.type() == typeid(MultisignatureOutput)) {
-      auto amountOutputs = m_multisignatureOutputs.find(output.amount);
-      if (amountOutputs == m_multisignatureOutputs.end()) {
+      uint32_t amountOutputCount = getMultisignatureOutputCount(output.amount);
+      if (amountOutputCount == 0) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - cannot find specific amount in outputs map.";
 
         continue;
       }
 
-      if (amountOutputs->second.empty()) {
-        logger(ERROR, BRIGHT_RED) <<
-          "Blockchain consistency broken - output array for specific amount is empty.";
-
-        continue;
-      }
-
-      if (amountOutputs->second.back().isUsed) {
+      MultisignatureOutputUsage lastOutput = getMultisignatureOutput(output.amount, amountOutputCount - 1);
+      if (lastOutput.isUsed) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - attempting to remove used output.";
 
         continue;
       }
 
-      if (amountOutputs->second.back().transactionIndex.block != transactionIndex.block || amountOutputs->second.back().transactionIndex.transaction != transactionIndex.transaction) {
+      if (lastOutput.transactionIndex.block != transactionIndex.block || lastOutput.transactionIndex.transaction != transactionIndex.transaction) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid transaction index.";
 
         continue;
       }
 
-      if (amountOutputs->second.back().outputIndex != transaction.outputs.size() - 1 - outputIndex) {
+      if (lastOutput.outputIndex != transaction.outputs.size() - 1 - outputIndex) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid output index.";
 
         continue;
       }
 
-      amountOutputs->second.pop_back();
-      if (amountOutputs->second.empty()) {
-        m_multisignatureOutputs.erase(amountOutputs);
-      }
+      popMultisignatureOutput(output.amount);
     }
   }
 
   for (auto& input : transaction.inputs) {
     if (input.type() == typeid(KeyInput)) {
-      size_t count = m_spent_keys.erase(::boost::get<KeyInput>(input).keyImage);
-      if (count != 1) {
+      if (!eraseSpentKeyImage(::boost::get<KeyInput>(input).keyImage)) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - cannot find spent key.";
       }
     } else if (input.type() == typeid(MultisignatureInput)) {
       const MultisignatureInput& in = ::boost::get<MultisignatureInput>(input);
-      auto& amountOutputs = m_multisignatureOutputs[in.amount];
-      if (!amountOutputs[in.outputIndex].isUsed) {
+      if (!getMultisignatureOutput(in.amount, in.outputIndex).isUsed) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - multisignature output not marked as used.";
       }
 
-      amountOutputs[in.outputIndex].isUsed = false;
+      setMultisignatureOutputUsed(in.amount, in.outputIndex, false);
     }
   }
 
   m_paymentIdIndex.remove(transaction);
 
-  size_t count = m_transactionMap.erase(transactionHash);
-  if (count != 1) {
+  if (!eraseTransaction(transactionHash)) {
     logger(ERROR, BRIGHT_RED) <<
       "Blockchain consistency broken - cannot find transaction by hash.";
   }
@@ -2325,22 +3408,22 @@ void Blockchain::popTransactions(const BlockEntry& block, const Crypto::Hash& mi
 
 bool Blockchain::validateInput(const MultisignatureInput& input, const Crypto::Hash& transactionHash, const Crypto::Hash& transactionPrefixHash, const std::vector<Crypto::Signature>& transactionSignatures) {
   assert(input.signatureCount == transactionSignatures.size());
-  MultisignatureOutputsContainer::const_iterator amountOutputs = m_multisignatureOutputs.find(input.amount);
-  if (amountOutputs == m_multisignatureOutputs.end()) {
+  uint32_t amountOutputCount = getMultisignatureOutputCount(input.amount);
+  if (amountOutputCount == 0) {
     logger(DEBUGGING) <<
       "Transaction << " << transactionHash << " contains multisignature input with invalid amount.";
 
     return false;
   }
 
-  if (input.outputIndex >= amountOutputs->second.size()) {
+  if (input.outputIndex >= amountOutputCount) {
     logger(DEBUGGING) <<
       "Transaction << " << transactionHash << " contains multisignature input with invalid outputIndex.";
 
     return false;
   }
 
-  const MultisignatureOutputUsage& outputIndex = amountOutputs->second[input.outputIndex];
+  const MultisignatureOutputUsage outputIndex = getMultisignatureOutput(input.amount, input.outputIndex);
   if (outputIndex.isUsed) {
     logger(DEBUGGING) <<
       "Transaction << " << transactionHash << " contains double spending multisignature input.";
@@ -2417,6 +3500,37 @@ void Blockchain::rollbackBlockchainTo(uint32_t height) {
   while (height + 1 < m_blocks.size()) {
     removeLastBlock();
   }
+
+  m_tx_pool.on_blockchain_dec(m_blocks.size(), getTailId());
+}
+
+void Blockchain::pushBlockHeader(const BlockEntry& block) {
+  pushBlockHeader(block.bl.timestamp, block.cumulative_difficulty, block.block_cumulative_size, block.already_generated_coins, block.bl.majorVersion);
+}
+
+void Blockchain::pushBlockHeader(uint64_t timestamp, difficulty_type cumulativeDifficulty, uint64_t blockCumulativeSize, uint64_t alreadyGeneratedCoins, uint8_t majorVersion) {
+  m_headerIndex.push(timestamp, cumulativeDifficulty, blockCumulativeSize, alreadyGeneratedCoins, majorVersion);
+  m_difficultyState.push(mainChainReader());
+  m_nextDifficulty = 0;
+}
+
+void Blockchain::popBlockHeader() {
+  m_difficultyState.pop(mainChainReader());
+  m_headerIndex.pop();
+  m_nextDifficulty = 0;
+}
+
+void Blockchain::clearBlockHeaders() {
+  m_headerIndex.clear();
+  m_difficultyState.reset(0, mainChainReader());
+  m_nextDifficulty = 0;
+}
+
+LwmaDifficultyState::BlockReader Blockchain::mainChainReader() const {
+  return [this](uint32_t height, uint64_t& timestamp, difficulty_type& cumulativeDifficulty) {
+    timestamp = m_headerIndex.timestamp(height);
+    cumulativeDifficulty = m_headerIndex.cumulativeDifficulty(height);
+  };
 }
 
 void Blockchain::removeLastBlock() {
@@ -2426,24 +3540,32 @@ void Blockchain::removeLastBlock() {
     return;
   }
 
+  WriteLock writeLock(*this);
   logger(DEBUGGING) << "Removing last block with height " << m_blocks.back().height;
+  // the journal records the pop before the stored block goes away, a start in between applies the block again
+  journalBlock(false, m_blocks.back(), 0);
   popTransactions(m_blocks.back(), getObjectHash(m_blocks.back().bl.baseTransaction));
 
   Crypto::Hash blockHash = getBlockIdByHeight(m_blocks.back().height);
   m_timestampIndex.remove(m_blocks.back().bl.timestamp, blockHash);
   m_generatedTransactionsIndex.remove(m_blocks.back().bl);
 
-  m_blocks.pop_back();
+  m_depositIndex.popBlock();
+  popBlockHeader();
   m_blockIndex.pop();
+  // indexes are unwound on disk before the block is dropped, the same order pushBlock relies on
+  commitIndexStorage(m_blockIndex.size());
+  m_blocks.pop_back();
 
   assert(m_blockIndex.size() == m_blocks.size());
+  publishTip();
 }
 
 bool Blockchain::checkUpgradeHeight(const UpgradeDetector& upgradeDetector) {
   uint32_t upgradeHeight = upgradeDetector.upgradeHeight();
   if (upgradeHeight != UpgradeDetectorBase::UNDEF_HEIGHT && upgradeHeight + 1 < m_blocks.size()) {
     logger(INFO) << "Checking block version at " << upgradeHeight + 1;
-    if (m_blocks[upgradeHeight + 1].bl.majorVersion != upgradeDetector.targetVersion()) {
+    if (m_headerIndex.majorVersion(upgradeHeight + 1) != upgradeDetector.targetVersion()) {
       return false;
     }
   }
@@ -2452,7 +3574,7 @@ bool Blockchain::checkUpgradeHeight(const UpgradeDetector& upgradeDetector) {
 }
 
 bool Blockchain::getLowerBound(uint64_t timestamp, uint64_t startOffset, uint32_t& height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
 
   assert(startOffset < m_blocks.size());
 
@@ -2460,41 +3582,40 @@ bool Blockchain::getLowerBound(uint64_t timestamp, uint64_t startOffset, uint32_
   if (getForkVersion() == 1)
     ftl = m_currency.blockFutureTimeLimit_v1();
 
-  auto bound = std::lower_bound(m_blocks.begin() + startOffset, m_blocks.end(), timestamp - ftl,
-    [](const BlockEntry& b, uint64_t timestamp) { return b.bl.timestamp < timestamp; });
-
-  if (bound == m_blocks.end()) {
+  const std::vector<uint64_t>& timestamps = m_headerIndex.timestamps();
+  auto bound = std::lower_bound(timestamps.begin() + startOffset, timestamps.end(), timestamp - ftl);
+  if (bound == timestamps.end()) {
     return false;
   }
 
-  height = static_cast<uint32_t>(std::distance(m_blocks.begin(), bound));
+  height = static_cast<uint32_t>(std::distance(timestamps.begin(), bound));
   return true;
 }
 
 std::vector<Crypto::Hash> Blockchain::getBlockIds(uint32_t startHeight, uint32_t maxCount) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return m_blockIndex.getBlockIds(startHeight, maxCount);
 }
 
 bool Blockchain::getBlockContainingTransaction(const Crypto::Hash& txId, Crypto::Hash& blockId, uint32_t& blockHeight) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  auto it = m_transactionMap.find(txId);
-  if (it == m_transactionMap.end()) {
+  ReadLock lk(*this);
+  TransactionIndex transactionIndex;
+  if (!findMainChainTransaction(txId, transactionIndex)) {
     return false;
   } else {
-    blockHeight = m_blocks[it->second.block].height;
+    blockHeight = transactionIndex.block;
     blockId = getBlockIdByHeight(blockHeight);
     return true;
   }
 }
 
 bool Blockchain::getAlreadyGeneratedCoins(const Crypto::Hash& hash, uint64_t& generatedCoins) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
 
   // try to find block in main chain
   uint32_t height = 0;
   if (m_blockIndex.getBlockHeight(hash, height)) {
-    generatedCoins = m_blocks[height].already_generated_coins;
+    generatedCoins = m_headerIndex.generatedCoins(height);
     return true;
   }
 
@@ -2510,12 +3631,12 @@ bool Blockchain::getAlreadyGeneratedCoins(const Crypto::Hash& hash, uint64_t& ge
 }
 
 bool Blockchain::getBlockSize(const Crypto::Hash& hash, size_t& size) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
 
   // try to find block in main chain
   uint32_t height = 0;
   if (m_blockIndex.getBlockHeight(hash, height)) {
-    size = m_blocks[height].block_cumulative_size;
+    size = m_headerIndex.cumulativeSize(height);
     return true;
   }
 
@@ -2531,23 +3652,392 @@ bool Blockchain::getBlockSize(const Crypto::Hash& hash, size_t& size) {
 }
 
 bool Blockchain::getMultisigOutputReference(const MultisignatureInput& txInMultisig, std::pair<Crypto::Hash, size_t>& outputReference) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  MultisignatureOutputsContainer::const_iterator amountIter = m_multisignatureOutputs.find(txInMultisig.amount);
-  if (amountIter == m_multisignatureOutputs.end()) {
+  ReadLock lk(*this);
+  uint32_t amountOutputCount = getMultisignatureOutputCount(txInMultisig.amount);
+  if (amountOutputCount == 0) {
     logger(DEBUGGING) << "Transaction contains multisignature input with invalid amount.";
     return false;
   }
-  if (amountIter->second.size() <= txInMultisig.outputIndex) {
+  if (amountOutputCount <= txInMultisig.outputIndex) {
     logger(DEBUGGING) << "Transaction contains multisignature input with invalid outputIndex.";
     return false;
   }
-  const MultisignatureOutputUsage& outputIndex = amountIter->second[txInMultisig.outputIndex];
-  const Transaction& outputTransaction = m_blocks[outputIndex.transactionIndex.block].transactions[outputIndex.transactionIndex.transaction].tx;
-  outputReference.first = getObjectHash(outputTransaction);
+  const MultisignatureOutputUsage outputIndex = getMultisignatureOutput(txInMultisig.amount, txInMultisig.outputIndex);
+  if (outputIndex.transactionIndex.block >= m_blocks.size()) {
+    logger(DEBUGGING) << "Transaction contains multisignature input spending an output of a block still being added.";
+    return false;
+  }
+
+  readBlock(outputIndex.transactionIndex.block, [&outputReference, &outputIndex](const BlockEntry& block) {
+    outputReference.first = getObjectHash(block.transactions[outputIndex.transactionIndex.transaction].tx);
+  });
+
   outputReference.second = outputIndex.outputIndex;
   return true;
 }
 
+bool Blockchain::findTransaction(const Crypto::Hash& transactionHash, TransactionIndex& transactionIndex) {
+  if (m_indexStorage) {
+    std::string value;
+    if (!m_indexStorage->get(podKey(INDEX_TRANSACTION_PREFIX, transactionHash), value)) {
+      return false;
+    }
+
+    transactionIndex.block = static_cast<uint32_t>(unpackUInt(value, 0, sizeof(uint32_t)));
+    transactionIndex.transaction = static_cast<uint16_t>(unpackUInt(value, sizeof(uint32_t), sizeof(uint16_t)));
+    return true;
+  }
+
+  auto it = m_transactionMap.find(transactionHash);
+  if (it == m_transactionMap.end()) {
+    return false;
+  }
+
+  transactionIndex = it->second;
+  return true;
+}
+
+bool Blockchain::findMainChainTransaction(const Crypto::Hash& transactionHash, TransactionIndex& transactionIndex) {
+  // pushBlock() indexes transactions before it verifies their ring signatures without m_readLock, readers skip them
+  return findTransaction(transactionHash, transactionIndex) && transactionIndex.block < m_blocks.size();
+}
+
+void Blockchain::readBlock(uint32_t height, const std::function<void(const BlockEntry&)>& visitor) {
+  m_blocks.read(height, visitor);
+}
+
+uint64_t Blockchain::getTransactionCount() {
+  if (m_indexStorage) {
+    std::string value;
+    return m_indexStorage->get(INDEX_TRANSACTION_COUNT_KEY, value) ? unpackUInt(value, 0, sizeof(uint64_t)) : 0;
+  }
+
+  return m_transactionMap.size();
+}
+
+bool Blockchain::insertTransaction(const Crypto::Hash& transactionHash, TransactionIndex transactionIndex) {
+  if (m_indexStorage) {
+    std::string key = podKey(INDEX_TRANSACTION_PREFIX, transactionHash);
+    if (m_indexStorage->contains(key)) {
+      return false;
+    }
+
+    std::string value;
+    packUInt(value, transactionIndex.block, sizeof(uint32_t));
+    packUInt(value, transactionIndex.transaction, sizeof(uint16_t));
+    m_indexStorage->put(key, value);
+
+    std::string count;
+    packUInt(count, getTransactionCount() + 1, sizeof(uint64_t));
+    m_indexStorage->put(INDEX_TRANSACTION_COUNT_KEY, count);
+    return true;
+  }
+
+  return m_transactionMap.insert(std::make_pair(transactionHash, transactionIndex)).second;
+}
+
+bool Blockchain::eraseTransaction(const Crypto::Hash& transactionHash) {
+  if (m_indexStorage) {
+    std::string key = podKey(INDEX_TRANSACTION_PREFIX, transactionHash);
+    if (!m_indexStorage->contains(key)) {
+      return false;
+    }
+
+    m_indexStorage->remove(key);
+
+    std::string count;
+    packUInt(count, getTransactionCount() - 1, sizeof(uint64_t));
+    m_indexStorage->put(INDEX_TRANSACTION_COUNT_KEY, count);
+    return true;
+  }
+
+  return m_transactionMap.erase(transactionHash) == 1;
+}
+
+bool Blockchain::isSpentKeyImage(const Crypto::KeyImage& keyImage) {
+  if (m_indexStorage) {
+    return m_indexStorage->contains(podKey(INDEX_KEY_IMAGE_PREFIX, keyImage));
+  }
+
+  return m_spent_keys.find(keyImage) != m_spent_keys.end();
+}
+
+bool Blockchain::insertSpentKeyImage(const Crypto::KeyImage& keyImage) {
+  if (m_indexStorage) {
+    std::string key = podKey(INDEX_KEY_IMAGE_PREFIX, keyImage);
+    if (m_indexStorage->contains(key)) {
+      return false;
+    }
+
+    m_indexStorage->put(key, std::string());
+    return true;
+  }
+
+  return m_spent_keys.insert(keyImage).second;
+}
+
+bool Blockchain::eraseSpentKeyImage(const Crypto::KeyImage& keyImage) {
+  if (m_indexStorage) {
+    std::string key = podKey(INDEX_KEY_IMAGE_PREFIX, keyImage);
+    if (!m_indexStorage->contains(key)) {
+      return false;
+    }
+
+    m_indexStorage->remove(key);
+    return true;
+  }
+
+  return m_spent_keys.erase(keyImage) == 1;
+}
+
+uint32_t Blockchain::getKeyOutputCount(uint64_t amount) {
+  if (m_indexStorage) {
+    std::string value;
+    return m_indexStorage->get(amountKey(INDEX_KEY_OUTPUT_COUNT_PREFIX, amount), value) ? static_cast<uint32_t>(unpackUInt(value, 0, sizeof(uint64_t))) : 0;
+  }
+
+  auto it = m_outputs.find(amount);
+  return it == m_outputs.end() ? 0 : static_cast<uint32_t>(it->second.locations.size());
+}
+
+Blockchain::KeyOutputEntry Blockchain::getKeyOutput(uint64_t amount, uint32_t index) {
+  if (m_indexStorage) {
+    std::string value;
+    if (!m_indexStorage->get(amountIndexKey(INDEX_KEY_OUTPUT_PREFIX, amount, index), value)) {
+      throw std::out_of_range("Blockchain::getKeyOutput");
+    }
+
+    KeyOutputEntry entry = unpackOutputLocation(unpackUInt(value, 0, sizeof(uint64_t)));
+    entry.unlockTime = unpackUInt(value, 8, sizeof(uint64_t));
+    if (value.size() != 16 + sizeof(Crypto::PublicKey)) {
+      throw std::runtime_error("Corrupted blockchain index value");
+    }
+
+    memcpy(&entry.key, value.data() + 16, sizeof(Crypto::PublicKey));
+    return entry;
+  }
+
+  auto it = m_outputs.find(amount);
+  if (it == m_outputs.end() || index >= it->second.locations.size()) {
+    throw std::out_of_range("Blockchain::getKeyOutput");
+  }
+
+  KeyOutputEntry entry = unpackOutputLocation(it->second.locations[index]);
+  entry.unlockTime = it->second.unlockTimes[index];
+  entry.key = it->second.keys[index];
+  return entry;
+}
+
+uint32_t Blockchain::pushKeyOutput(uint64_t amount, TransactionIndex transactionIndex, uint16_t outputIndex, uint64_t unlockTime, const Crypto::PublicKey& key) {
+  if (m_indexStorage) {
+    uint32_t index = getKeyOutputCount(amount);
+    std::string value;
+    packUInt(value, packOutputLocation(transactionIndex, outputIndex), sizeof(uint64_t));
+    packUInt(value, unlockTime, sizeof(uint64_t));
+    value.append(reinterpret_cast<const char*>(&key), sizeof(key));
+    m_indexStorage->put(amountIndexKey(INDEX_KEY_OUTPUT_PREFIX, amount, index), value);
+
+    std::string count;
+    packUInt(count, index + 1, sizeof(uint64_t));
+    m_indexStorage->put(amountKey(INDEX_KEY_OUTPUT_COUNT_PREFIX, amount), count);
+    return index;
+  }
+
+  KeyOutputColumns& amountOutputs = m_outputs[amount];
+  amountOutputs.locations.push_back(packOutputLocation(transactionIndex, outputIndex));
+  amountOutputs.unlockTimes.push_back(unlockTime);
+  amountOutputs.keys.push_back(key);
+  return static_cast<uint32_t>(amountOutputs.locations.size() - 1);
+}
+
+void Blockchain::popKeyOutput(uint64_t amount) {
+  if (m_indexStorage) {
+    uint32_t index = getKeyOutputCount(amount) - 1;
+    m_indexStorage->remove(amountIndexKey(INDEX_KEY_OUTPUT_PREFIX, amount, index));
+    if (index == 0) {
+      m_indexStorage->remove(amountKey(INDEX_KEY_OUTPUT_COUNT_PREFIX, amount));
+    } else {
+      std::string count;
+      packUInt(count, index, sizeof(uint64_t));
+      m_indexStorage->put(amountKey(INDEX_KEY_OUTPUT_COUNT_PREFIX, amount), count);
+    }
+
+    return;
+  }
+
+  auto amountOutputs = m_outputs.find(amount);
+  amountOutputs->second.locations.pop_back();
+  amountOutputs->second.unlockTimes.pop_back();
+  amountOutputs->second.keys.pop_back();
+  if (amountOutputs->second.locations.empty()) {
+    m_outputs.erase(amountOutputs);
+  }
+}
+
+uint32_t Blockchain::getMultisignatureOutputCount(uint64_t amount) {
+  if (m_indexStorage) {
+    std::string value;
+    return m_indexStorage->get(amountKey(INDEX_MULTISIGNATURE_OUTPUT_COUNT_PREFIX, amount), value) ? static_cast<uint32_t>(unpackUInt(value, 0, sizeof(uint64_t))) : 0;
+  }
+
+  auto it = m_multisignatureOutputs.find(amount);
+  return it == m_multisignatureOutputs.end() ? 0 : static_cast<uint32_t>(it->second.size());
+}
+
+Blockchain::MultisignatureOutputUsage Blockchain::getMultisignatureOutput(uint64_t amount, uint32_t index) {
+  if (m_indexStorage) {
+    std::string value;
+    if (!m_indexStorage->get(amountIndexKey(INDEX_MULTISIGNATURE_OUTPUT_PREFIX, amount, index), value)) {
+      throw std::out_of_range("Blockchain::getMultisignatureOutput");
+    }
+
+    MultisignatureOutputUsage outputUsage;
+    outputUsage.transactionIndex.block = static_cast<uint32_t>(unpackUInt(value, 0, sizeof(uint32_t)));
+    outputUsage.transactionIndex.transaction = static_cast<uint16_t>(unpackUInt(value, 4, sizeof(uint16_t)));
+    outputUsage.outputIndex = static_cast<uint16_t>(unpackUInt(value, 6, sizeof(uint16_t)));
+    outputUsage.isUsed = unpackUInt(value, 8, sizeof(uint8_t)) != 0;
+    return outputUsage;
+  }
+
+  auto amountOutputs = m_multisignatureOutputs.find(amount);
+  if (amountOutputs == m_multisignatureOutputs.end() || index >= amountOutputs->second.size()) {
+    throw std::out_of_range("Blockchain::getMultisignatureOutput");
+  }
+
+  return amountOutputs->second[index];
+}
+
+uint32_t Blockchain::pushMultisignatureOutput(uint64_t amount, const MultisignatureOutputUsage& outputUsage) {
+  if (m_indexStorage) {
+    uint32_t index = getMultisignatureOutputCount(amount);
+    std::string value;
+    packUInt(value, outputUsage.transactionIndex.block, sizeof(uint32_t));
+    packUInt(value, outputUsage.transactionIndex.transaction, sizeof(uint16_t));
+    packUInt(value, outputUsage.outputIndex, sizeof(uint16_t));
+    packUInt(value, outputUsage.isUsed ? 1 : 0, sizeof(uint8_t));
+    m_indexStorage->put(amountIndexKey(INDEX_MULTISIGNATURE_OUTPUT_PREFIX, amount, index), value);
+
+    std::string count;
+    packUInt(count, index + 1, sizeof(uint64_t));
+    m_indexStorage->put(amountKey(INDEX_MULTISIGNATURE_OUTPUT_COUNT_PREFIX, amount), count);
+    return index;
+  }
+
+  auto& amountOutputs = m_multisignatureOutputs[amount];
+  amountOutputs.push_back(outputUsage);
+  return static_cast<uint32_t>(amountOutputs.size() - 1);
+}
+
+void Blockchain::popMultisignatureOutput(uint64_t amount) {
+  if (m_indexStorage) {
+    uint32_t index = getMultisignatureOutputCount(amount) - 1;
+    m_indexStorage->remove(amountIndexKey(INDEX_MULTISIGNATURE_OUTPUT_PREFIX, amount, index));
+    if (index == 0) {
+      m_indexStorage->remove(amountKey(INDEX_MULTISIGNATURE_OUTPUT_COUNT_PREFIX, amount));
+    } else {
+      std::string count;
+      packUInt(count, index, sizeof(uint64_t));
+      m_indexStorage->put(amountKey(INDEX_MULTISIGNATURE_OUTPUT_COUNT_PREFIX, amount), count);
+    }
+
+    return;
+  }
+
+  auto amountOutputs = m_multisignatureOutputs.find(amount);
+  amountOutputs->second.pop_back();
+  if (amountOutputs->second.empty()) {
+    m_multisignatureOutputs.erase(amountOutputs);
+  }
+}
+
+void Blockchain::setMultisignatureOutputUsed(uint64_t amount, uint32_t index, bool isUsed) {
+  if (m_indexStorage) {
+    std::string key = amountIndexKey(INDEX_MULTISIGNATURE_OUTPUT_PREFIX, amount, index);
+    std::string value;
+    if (!m_indexStorage->get(key, value) || value.size() != 9) {
+      throw std::out_of_range("Blockchain::setMultisignatureOutputUsed");
+    }
+
+    value[8] = isUsed ? 1 : 0;
+    m_indexStorage->put(key, value);
+    return;
+  }
+
+  // an unknown output is an error in both index modes, it's never created here
+  auto amountOutputs = m_multisignatureOutputs.find(amount);
+  if (amountOutputs == m_multisignatureOutputs.end() || index >= amountOutputs->second.size()) {
+    throw std::out_of_range("Blockchain::setMultisignatureOutputUsed");
+  }
+
+  amountOutputs->second[index].isUsed = isUsed;
+}
+
+void Blockchain::clearTransactionIndexes() {
+  m_transactionMap.clear();
+  m_spent_keys.clear();
+  m_outputs.clear();
+  m_multisignatureOutputs.clear();
+
+  if (m_indexStorage) {
+    m_indexStorage->discard();
+    std::error_code ec = m_indexStorage->dataBase().removePrefix(INDEX_PREFIX);
+    if (ec) {
+      throw std::system_error(ec, "Failed to clear blockchain indexes");
+    }
+
+    std::string version;
+    packUInt(version, INDEX_STORAGE_VERSION, sizeof(uint32_t));
+    m_indexStorage->put(INDEX_VERSION_KEY, version);
+  }
+}
+
+void Blockchain::commitIndexStorage(uint32_t height) {
+  if (!m_indexStorage) {
+    return;
+  }
+
+  std::string value;
+  packUInt(value, height, sizeof(uint32_t));
+  m_indexStorage->put(INDEX_HEIGHT_KEY, value);
+
+  std::error_code ec = m_indexStorage->commit();
+  if (ec) {
+    throw std::system_error(ec, "Failed to write blockchain indexes");
+  }
+}
+
+void Blockchain::updateIndexStorage() {
+  std::string value;
+  uint32_t indexedHeight = m_indexStorage->get(INDEX_HEIGHT_KEY, value) ? static_cast<uint32_t>(unpackUInt(value, 0, sizeof(uint32_t))) : 0;
+  uint32_t version = m_indexStorage->get(INDEX_VERSION_KEY, value) ? static_cast<uint32_t>(unpackUInt(value, 0, sizeof(uint32_t))) : 0;
+  if (indexedHeight > m_blocks.size()) {
+    logger(WARNING, BRIGHT_YELLOW) << "Blockchain indexes are ahead of stored blocks, rebuilding them";
+    clearTransactionIndexes();
+    indexedHeight = 0;
+  } else if (version != INDEX_STORAGE_VERSION) {
+    if (indexedHeight != 0) {
+      logger(WARNING, BRIGHT_YELLOW) << "Blockchain indexes have an old format, rebuilding them";
+    }
+
+    clearTransactionIndexes();
+    indexedHeight = 0;
+  }
+
+  if (indexedHeight == m_blocks.size()) {
+    return;
+  }
+
+  logger(INFO, BRIGHT_WHITE) << "Indexing blocks " << indexedHeight << " - " << m_blocks.size() - 1;
+  loadBlocks(indexedHeight, [this](uint32_t height, const LoadedBlock& loadedBlock) {
+    indexTransactions(loadedBlock.block, height, loadedBlock.transactionHashes);
+    if ((height + 1) % 1000 == 0) {
+      commitIndexStorage(height + 1);
+    }
+  });
+
+  commitIndexStorage(static_cast<uint32_t>(m_blocks.size()));
+}
+
 bool Blockchain::storeBlockchainIndices() {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
@@ -2598,23 +4088,37 @@ bool Blockchain::loadBlockchainIndices() {
 }
 
 bool Blockchain::getGeneratedTransactionsNumber(uint32_t height, uint64_t& generatedTransactions) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return m_generatedTransactionsIndex.find(height, generatedTransactions);
 }
 
 bool Blockchain::getOrphanBlockIdsByHeight(uint32_t height, std::vector<Crypto::Hash>& blockHashes) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return m_orthanBlocksIndex.find(height, blockHashes);
 }
 
 bool Blockchain::getBlockIdsByTimestamp(uint64_t timestampBegin, uint64_t timestampEnd, uint32_t blocksNumberLimit, std::vector<Crypto::Hash>& hashes, uint32_t& blocksNumberWithinTimestamps) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  ReadLock lk(*this);
   return m_timestampIndex.find(timestampBegin, timestampEnd, blocksNumberLimit, hashes, blocksNumberWithinTimestamps);
 }
 
 bool Blockchain::getTransactionIdsByPaymentId(const Crypto::Hash& paymentId, std::vector<Crypto::Hash>& transactionHashes) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  return m_paymentIdIndex.find(paymentId, transactionHashes);
+  ReadLock lk(*this);
+  std::vector<Crypto::Hash> indexedHashes;
+  if (!m_paymentIdIndex.find(paymentId, indexedHashes)) {
+    return false;
+  }
+
+  bool found = false;
+  for (const Crypto::Hash& hash : indexedHashes) {
+    TransactionIndex transactionIndex;
+    if (findMainChainTransaction(hash, transactionIndex)) {
+      transactionHashes.push_back(hash);
+      found = true;
+    }
+  }
+
+  return found;
 }
 
 bool Blockchain::loadTransactions(const Block& block, std::vector<Transaction>& transactions, uint32_t height) {
@@ -2661,6 +4165,7 @@ void Blockchain::sendMessage(const BlockchainMessage& message) {
 }
 
 bool Blockchain::isBlockInMainChain(const Crypto::Hash& blockId) {
+  ReadLock lk(*this);
   return m_blockIndex.hasBlock(blockId);
 }
 
@@ -1,18 +1,31 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <boost/thread/shared_mutex.hpp>
 
 #include "google/sparse_hash_set"
 #include "google/sparse_hash_map"
 
 #include "ObserverManager.h"
 #include "common/Util.h"
+#include "common/WorkerPool.h"
+#include "BlockCacheJournal.h"
+#include "BlockHeaderIndex.h"
 #include "BlockIndex.h"
 #include "Checkpoints.h"
+#include "core/CoreConfig.h"
 #include "core/Currency.h"
 #include "core/DepositIndex.h"
 #include "IBlockchainStorageObserver.h"
 #include "ITransactionValidator.h"
+#include "DataBaseOverlay.h"
+#include "LmdbDataBase.h"
+#include "LwmaDifficultyState.h"
+#include "OutputKeyCache.h"
+#include "RingSignatureCache.h"
 #include "SwappedVector.h"
 #include "base/CryptoNoteFormatUtils.h"
 #include "core/trans/TransactionPool.h"
@@ -37,7 +50,21 @@ namespace CryptoNote {
   using CryptoNote::BlockInfo;
   class Blockchain : public CryptoNote::ITransactionValidator {
   public:
-    Blockchain(const Currency& currency, tx_memory_pool& tx_pool, Logging::ILogger& logger, bool blockchainIndexesEnabled);
+    // Summary of the main chain tip. A new one is published after every block push and pop, readers hold on to
+    // the shared_ptr they got and never see it change, so they need no lock at all. Block, transaction and output
+    // queries take m_readLock.
+    struct ChainTip {
+      uint32_t height; // number of blocks, as getCurrentBlockchainHeight()
+      Crypto::Hash id;
+      difficulty_type nextDifficulty;
+      uint64_t alreadyGeneratedCoins;
+      size_t transactionCount;
+      uint64_t fullDepositAmount;
+      uint64_t fullDepositInterest;
+    };
+
+    Blockchain(const Currency& currency, tx_memory_pool& tx_pool, Tools::WorkerPool& workerPool, Logging::ILogger& logger, bool blockchainIndexesEnabled);
+    ~Blockchain();
 
     bool addObserver(IBlockchainStorageObserver* observer);
     bool removeObserver(IBlockchainStorageObserver* observer);
@@ -50,6 +77,7 @@ namespace CryptoNote {
 
     bool init() { return init(Tools::getDefaultDataDirectory(), true); }
     bool init(const std::string& config_folder, bool load_existing);
+    bool init(const CoreConfig& config, bool load_existing);
     bool deinit();
 
     bool getLowerBound(uint64_t timestamp, uint64_t startOffset, uint32_t& height);
@@ -70,6 +98,7 @@ namespace CryptoNote {
     bool haveTransactionKeyImagesAsSpent(const Transaction &tx);
 
     uint32_t getCurrentBlockchainHeight(); //TODO rename to getCurrentBlockchainSize
+    std::shared_ptr<const ChainTip> getTip() const;
     Crypto::Hash getTailId();
     Crypto::Hash getTailId(uint32_t& height);
     difficulty_type getDifficultyForNextBlock();
@@ -118,7 +147,7 @@ namespace CryptoNote {
 
     template<class t_ids_container, class t_blocks_container, class t_missed_container>
     bool getBlocks(const t_ids_container& block_ids, t_blocks_container& blocks, t_missed_container& missed_bs) {
-      std::lock_guard<std::recursive_mutex> lk(m_blockchain_lock);
+      ReadLock lk(*this);
 
       for (const auto& bl_id : block_ids) {
         uint32_t height = 0;
@@ -127,7 +156,7 @@ namespace CryptoNote {
         } else {
           if (!(height < m_blocks.size())) { logger(Logging::ERROR, Logging::BRIGHT_RED) << "Internal error: bl_id=" << Common::podToHex(bl_id)
             << " have index record with offset=" << height << ", bigger then m_blocks.size()=" << m_blocks.size(); return false; }
-            blocks.push_back(m_blocks[height].bl);
+            readBlock(height, [&blocks](const BlockEntry& block) { blocks.push_back(block.bl); });
         }
       }
 
@@ -136,14 +165,16 @@ namespace CryptoNote {
 
     template<class t_ids_container, class t_tx_container, class t_missed_container>
     void getBlockchainTransactions(const t_ids_container& txs_ids, t_tx_container& txs, t_missed_container& missed_txs) {
-      std::lock_guard<decltype(m_blockchain_lock)> bcLock(m_blockchain_lock);
+      ReadLock lk(*this);
 
       for (const auto& tx_id : txs_ids) {
-        auto it = m_transactionMap.find(tx_id);
-        if (it == m_transactionMap.end()) {
+        TransactionIndex transactionIndex;
+        if (!findMainChainTransaction(tx_id, transactionIndex)) {
           missed_txs.push_back(tx_id);
         } else {
-          txs.push_back(transactionByIndex(it->second).tx);
+          readBlock(transactionIndex.block, [&txs, &transactionIndex](const BlockEntry& block) {
+            txs.push_back(block.transactions[transactionIndex.transaction].tx);
+          });
         }
       }
     }
@@ -179,6 +210,29 @@ namespace CryptoNote {
       }
     };
 
+    // Key output as resolved by the output index, without loading the transaction that created it.
+    struct KeyOutputEntry {
+      TransactionIndex transactionIndex;
+      uint16_t outputIndex;
+      uint64_t unlockTime;
+      Crypto::PublicKey key;
+    };
+
+    // Key outputs of one amount stored column by column; a location packs block, transaction and output indexes into one word.
+    struct KeyOutputColumns {
+      std::vector<uint64_t> locations;
+      std::vector<uint64_t> unlockTimes;
+      std::vector<Crypto::PublicKey> keys;
+    };
+
+    Crypto::Hash transactionHashByIndex(TransactionIndex index);
+    RawBlock getRawBlock(uint32_t height);
+    // Computes the proof of work of blocks about to be pushed on the worker pool, pushBlock() picks the results up by block hash.
+    void precomputeProofOfWork(const std::vector<const Block*>& blocks);
+    // Checks the inputs of transactions about to enter the pool, valid[i] tells whether transactions[i] passed. Rings are
+    // resolved under the lock, signatures are verified on the worker pool without it and cached for add_tx().
+    void verifyTransactionsInputs(const std::vector<const Transaction*>& transactions, std::vector<bool>& valid);
+
   private:
 
     struct MultisignatureOutputUsage {
@@ -221,15 +275,110 @@ namespace CryptoNote {
       }
     };
 
+    // Block read back from m_blocks by loadBlocks() together with the values derived from it off the calling thread.
+    struct LoadedBlock {
+      BlockEntry block;
+      Crypto::Hash hash;
+      std::vector<Crypto::Hash> transactionHashes;
+      uint64_t interest;
+    };
+
+    // Output a block appends to the key or multisignature output index, unlockTime and key are set for key outputs only.
+    struct OutputDelta {
+      uint64_t amount;
+      TransactionIndex transactionIndex;
+      uint16_t outputIndex;
+      bool multisignature;
+      uint64_t unlockTime;
+      Crypto::PublicKey key;
+
+      void serialize(ISerializer& s) {
+        s(amount, "amount");
+        s(transactionIndex, "txindex");
+        s(outputIndex, "outindex");
+        s(multisignature, "multisignature");
+        s(unlockTime, "unlock_time");
+        s(key, "key");
+      }
+    };
+
+    struct MultisignatureInputDelta {
+      uint64_t amount;
+      uint32_t outputIndex;
+
+      void serialize(ISerializer& s) {
+        s(amount, "amount");
+        s(outputIndex, "outindex");
+      }
+    };
+
+    // What pushing a block changed in the cache, journaled instead of the block itself. Applying it again pushes the
+    // block, reverting it pops the block; neither touches m_blocks or the optional blockchain indices. The transaction
+    // lists stay empty when those indexes live in m_indexStorage.
+    struct BlockCacheDelta {
+      Crypto::Hash blockHash;
+      Crypto::Hash previousBlockHash;
+      uint32_t height;
+      uint64_t timestamp;
+      difficulty_type cumulativeDifficulty;
+      uint64_t blockCumulativeSize;
+      uint64_t alreadyGeneratedCoins;
+      uint8_t majorVersion;
+      int64_t deposit;
+      uint64_t interest;
+      std::vector<Crypto::Hash> transactionHashes;
+      std::vector<Crypto::KeyImage> keyImages;
+      std::vector<MultisignatureInputDelta> multisignatureInputs;
+      std::vector<OutputDelta> outputs;
+
+      void serialize(ISerializer& s) {
+        s(blockHash, "hash");
+        s(previousBlockHash, "prev_hash");
+        s(height, "height");
+        s(timestamp, "timestamp");
+        s(cumulativeDifficulty, "cumulative_difficulty");
+        s(blockCumulativeSize, "block_cumulative_size");
+        s(alreadyGeneratedCoins, "already_generated_coins");
+        s(majorVersion, "major_version");
+        s(deposit, "deposit");
+        s(interest, "interest");
+        s(transactionHashes, "transactions");
+        s(keyImages, "key_images");
+        s(multisignatureInputs, "multisignature_inputs");
+        s(outputs, "outputs");
+      }
+    };
+
+    // Ring signature of a key input whose ring was resolved under the lock, verified later by verifyRingSignatures().
+    struct RingSignatureCheck {
+      size_t transaction; // position of the transaction in the block, for logging
+      Crypto::Hash prefixHash;
+      Crypto::KeyImage keyImage;
+      std::vector<Crypto::PublicKey> keys;
+      const Crypto::Signature* signatures;
+    };
+
     typedef google::sparse_hash_set<Crypto::KeyImage> key_images_container;
     typedef std::unordered_map<Crypto::Hash, BlockEntry> blocks_ext_by_hash;
-    typedef google::sparse_hash_map<uint64_t, std::vector<std::pair<TransactionIndex, uint16_t>>> outputs_container; //Crypto::Hash - tx hash, size_t - index of out in transaction
+    typedef google::sparse_hash_map<uint64_t, KeyOutputColumns> outputs_container;
     typedef google::sparse_hash_map<uint64_t, std::vector<MultisignatureOutputUsage>> MultisignatureOutputsContainer;
 
     const Currency& m_currency;
     tx_memory_pool& m_tx_pool;
-    mutable std::recursive_mutex m_blockchain_lock; // TODO: add here reader/writer lock
+    // Block import, transaction validation and the getters that keep state of their own. Block, transaction and
+    // output queries, the explorer indexes and ReadLockedBlockchainStorage only take m_readLock.
+    mutable std::recursive_mutex m_blockchain_lock;
+    // Held shared by the queries and exclusively, under m_blockchain_lock, while blocks and indexes change, so the
+    // queries wait for those changes but not for a whole block verification. A thread holding it shared must not
+    // take m_blockchain_lock. init() runs before there are readers and doesn't take it.
+    mutable boost::shared_mutex m_readLock;
     Crypto::cn_context m_cn_context;
+    Tools::WorkerPool& m_workerPool; // owned by the core
+    RingSignatureCache m_ringSignatureCache;
+    OutputKeyCache m_outputKeyCache;
+    std::mutex m_proofOfWorkLock;
+    std::unordered_map<Crypto::Hash, Crypto::Hash> m_proofOfWorkCache; // block hash -> proof of work hash
+    std::vector<std::unique_ptr<Crypto::cn_context>> m_proofOfWorkContexts; // idle contexts of precomputeProofOfWork()
     Tools::ObserverManager<IBlockchainStorageObserver> m_observerManager;
 
     key_images_container m_spent_keys;
@@ -246,12 +395,34 @@ namespace CryptoNote {
     typedef std::unordered_map<Crypto::Hash, TransactionIndex> TransactionMap;
     typedef BasicUpgradeDetector<Blocks> UpgradeDetector;
 
+    // Copy of the cached indexes, taken under the lock so a checkpoint serializes it without holding the lock.
+    struct CacheSnapshot {
+      CryptoNote::BlockIndex blockIndex;
+      BlockHeaderIndex headerIndex;
+      TransactionMap transactionMap;
+      key_images_container spentKeys;
+      outputs_container outputs;
+      MultisignatureOutputsContainer multisignatureOutputs;
+      CryptoNote::DepositIndex depositIndex;
+    };
+
     friend class BlockCacheSerializer;
     friend class BlockchainIndicesSerializer;
 
+    LmdbDataBase m_dataBase; // must outlive m_blocks
+    std::unique_ptr<DataBaseOverlay> m_indexStorage; // set when transaction, key image and output indexes live in m_dataBase
     Blocks m_blocks;
     CryptoNote::BlockIndex m_blockIndex;
+    BlockHeaderIndex m_headerIndex;
+    LwmaDifficultyState m_difficultyState;
+    difficulty_type m_nextDifficulty; // 0 until computed for the current tip
+    std::shared_ptr<const ChainTip> m_tip; // only accessed through std::atomic_load/atomic_store
     CryptoNote::DepositIndex m_depositIndex;
+    BlockCacheJournal m_cacheJournal; // changes since the last cache snapshot
+    size_t m_cacheJournalIndex;
+    uint32_t m_cacheJournalRetryBlocks; // blocks added since the journal failed, a checkpoint restarts it
+    std::thread m_cacheCheckpointThread;
+    std::atomic<bool> m_cacheCheckpointRunning;
     TransactionMap m_transactionMap;
     MultisignatureOutputsContainer m_multisignatureOutputs;
     UpgradeDetector m_upgradeDetectorv1;
@@ -269,8 +440,18 @@ namespace CryptoNote {
 
     Logging::LoggerRef logger;
 
+    bool openBlocks(const CoreConfig& config);
     void rebuildCache();
-    bool storeCache();
+    void loadBlocks(uint32_t startHeight, const std::function<void(uint32_t, const LoadedBlock&)>& handler);
+    bool loadCache(BlockCacheJournal::Header& snapshot);
+    bool replayCacheRecord(const BinaryArray& record, bool& beyondStoredBlocks);
+    BlockCacheDelta makeCacheDelta(const BlockEntry& block, uint64_t interest);
+    void journalBlock(bool pushed, const BlockEntry& block, uint64_t interest);
+    void startCacheJournal(const BlockCacheJournal::Header& snapshot);
+    void checkpointCache();
+    void stopCacheCheckpoint();
+    BlockCacheJournal::Header getCacheState() const;
+    std::string getCacheJournalFileName(size_t index) const;
     bool switch_to_alternative_blockchain(std::list<blocks_ext_by_hash::iterator>& alt_chain, bool discard_disconnected_chain);
     bool handle_alternative_block(const Block& b, const Crypto::Hash& id, block_verification_context& bvc, bool sendNewAlternativeBlockMessage = true);
     difficulty_type get_next_difficulty_for_alternative_chain(const std::list<blocks_ext_by_hash::iterator>& alt_chain, BlockEntry& bei);
@@ -279,9 +460,9 @@ namespace CryptoNote {
     bool validate_miner_transaction(const Block& b, uint32_t height, size_t cumulativeBlockSize, uint64_t alreadyGeneratedCoins, uint64_t fee, uint64_t& reward, int64_t& emissionChange);
     bool rollback_blockchain_switching(std::list<Block>& original_chain, size_t rollback_height);
     bool get_last_n_blocks_sizes(std::vector<size_t>& sz, size_t count);
-    bool add_out_to_get_random_outs(std::vector<std::pair<TransactionIndex, uint16_t>>& amount_outs, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS_outs_for_amount& result_outs, uint64_t amount, size_t i);
+    bool add_out_to_get_random_outs(COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS_outs_for_amount& result_outs, uint64_t amount, size_t i);
     bool is_tx_spendtime_unlocked(uint64_t unlock_time);
-    size_t find_end_of_allowed_index(const std::vector<std::pair<TransactionIndex, uint16_t>>& amount_outs);
+    size_t find_end_of_allowed_index(uint64_t amount);
     bool check_block_timestamp_main(const Block& b);
     bool check_block_timestamp(std::vector<uint64_t> timestamps, const Block& b);
     uint64_t get_adjusted_time();
@@ -292,34 +473,97 @@ namespace CryptoNote {
     std::vector<Crypto::Hash> doBuildSparseChain(const Crypto::Hash& startBlockId) const;
     bool getBlockCumulativeSize(const Block& block, size_t& cumulativeSize);
     bool update_next_comulative_size_limit();
-    bool check_tx_input(const KeyInput& txin, const Crypto::Hash& tx_prefix_hash, const std::vector<Crypto::Signature>& sig, uint32_t* pmax_related_block_height = NULL);
-    bool checkTransactionInputs(const Transaction& tx, const Crypto::Hash& tx_prefix_hash, uint32_t* pmax_used_block_height = NULL);
+    bool check_tx_input(const KeyInput& txin, const Crypto::Hash& tx_prefix_hash, const std::vector<Crypto::Signature>& sig, uint32_t* pmax_related_block_height = NULL, std::vector<RingSignatureCheck>* deferredChecks = NULL);
+    bool checkTransactionInputs(const Transaction& tx, const Crypto::Hash& tx_prefix_hash, uint32_t* pmax_used_block_height = NULL, std::vector<RingSignatureCheck>* deferredChecks = NULL);
+    bool checkRingSignature(const RingSignatureCheck& check);
+    bool verifyRingSignatures(const std::vector<RingSignatureCheck>& checks, size_t& failedTransaction);
+    bool getProofOfWork(const Block& block, const Crypto::Hash& blockHash, Crypto::Hash& proofOfWork);
     bool checkTransactionInputs(const Transaction& tx, uint32_t* pmax_used_block_height = NULL);
     bool check_tx_outputs(const Transaction& tx) const;
     bool have_tx_keyimg_as_spent(const Crypto::KeyImage &key_im);
     const TransactionEntry& transactionByIndex(TransactionIndex index);
     bool pushBlock(const Block& blockData, block_verification_context& bvc, uint32_t height);
     bool pushBlock(const Block& blockData, const std::vector<Transaction>& transactions, block_verification_context& bvc);
-    bool pushBlock(BlockEntry& block);
+    bool pushBlock(BlockEntry& block, uint64_t interest);
     void popBlock();
     bool pushTransaction(BlockEntry& block, const Crypto::Hash& transactionHash, TransactionIndex transactionIndex);
+    void indexTransactions(const BlockEntry& block, uint32_t height, const std::vector<Crypto::Hash>& transactionHashes);
     void popTransaction(const Transaction& transaction, const Crypto::Hash& transactionHash);
     void popTransactions(const BlockEntry& block, const Crypto::Hash& minerTransactionHash);
     bool validateInput(const MultisignatureInput& input, const Crypto::Hash& transactionHash, const Crypto::Hash& transactionPrefixHash, const std::vector<Crypto::Signature>& transactionSignatures);
     bool checkCheckpoints(uint32_t& lastValidCheckpointHeight);
     void rollbackBlockchainTo(uint32_t height);
     void removeLastBlock();
+    void pushBlockHeader(const BlockEntry& block);
+    void pushBlockHeader(uint64_t timestamp, difficulty_type cumulativeDifficulty, uint64_t blockCumulativeSize, uint64_t alreadyGeneratedCoins, uint8_t majorVersion);
+    void publishTip();
+    void popBlockHeader();
+    void clearBlockHeaders();
+    LwmaDifficultyState::BlockReader mainChainReader() const;
     bool checkUpgradeHeight(const UpgradeDetector& upgradeDetector);
 
     bool storeBlockchainIndices();
     bool loadBlockchainIndices();
 
+    // Scoped m_readLock. A thread that already holds it, shared or exclusively, doesn't take it again: a nested
+    // shared lock would queue behind a waiting writer for good.
+    class ReadLock : boost::noncopyable {
+    public:
+      explicit ReadLock(const Blockchain& blockchain);
+      ~ReadLock();
+
+    private:
+      const Blockchain& m_blockchain;
+      const Blockchain* m_outerBlockchain;
+      bool m_outerExclusively;
+      bool m_locked;
+    };
+
+    class WriteLock : boost::noncopyable {
+    public:
+      explicit WriteLock(const Blockchain& blockchain);
+      ~WriteLock();
+      void lock();
+      void unlock();
+
+    private:
+      const Blockchain& m_blockchain;
+      const Blockchain* m_outerBlockchain;
+      bool m_outerExclusively;
+      bool m_owner;
+      bool m_locked;
+    };
+
+    bool findTransaction(const Crypto::Hash& transactionHash, TransactionIndex& transactionIndex);
+    bool findMainChainTransaction(const Crypto::Hash& transactionHash, TransactionIndex& transactionIndex);
+    // Hands a stored block to visitor without changing the block cache, other readers may be using it.
+    void readBlock(uint32_t height, const std::function<void(const BlockEntry&)>& visitor);
+    uint64_t getTransactionCount();
+    bool insertTransaction(const Crypto::Hash& transactionHash, TransactionIndex transactionIndex);
+    bool eraseTransaction(const Crypto::Hash& transactionHash);
+    bool isSpentKeyImage(const Crypto::KeyImage& keyImage);
+    bool insertSpentKeyImage(const Crypto::KeyImage& keyImage);
+    bool eraseSpentKeyImage(const Crypto::KeyImage& keyImage);
+    uint32_t getKeyOutputCount(uint64_t amount);
+    KeyOutputEntry getKeyOutput(uint64_t amount, uint32_t index);
+    uint32_t pushKeyOutput(uint64_t amount, TransactionIndex transactionIndex, uint16_t outputIndex, uint64_t unlockTime, const Crypto::PublicKey& key);
+    void popKeyOutput(uint64_t amount);
+    uint32_t getMultisignatureOutputCount(uint64_t amount);
+    MultisignatureOutputUsage getMultisignatureOutput(uint64_t amount, uint32_t index);
+    uint32_t pushMultisignatureOutput(uint64_t amount, const MultisignatureOutputUsage& outputUsage);
+    void popMultisignatureOutput(uint64_t amount);
+    void setMultisignatureOutputUsed(uint64_t amount, uint32_t index, bool isUsed);
+    void clearTransactionIndexes();
+    void commitIndexStorage(uint32_t height);
+    void updateIndexStorage();
+
     bool loadTransactions(const Block& block, std::vector<Transaction>& transactions, uint32_t height);
     void saveTransactions(const std::vector<Transaction>& transactions, uint32_t height);
 
     void sendMessage(const BlockchainMessage& message);
 
     friend class LockedBlockchainStorage;
+    friend class ReadLockedBlockchainStorage;
   };
 
   class LockedBlockchainStorage: boost::noncopyable {
@@ -338,42 +582,47 @@ namespace CryptoNote {
     std::lock_guard<std::recursive_mutex> m_lock;
   };
 
+  // Keeps the chain from changing between calls like LockedBlockchainStorage, but lets other readers and block
+  // verification go on. Only the queries that take m_readLock may be called through it.
+  class ReadLockedBlockchainStorage: boost::noncopyable {
+  public:
+
+    ReadLockedBlockchainStorage(Blockchain& bc)
+      : m_bc(bc), m_lock(bc) {}
+
+    Blockchain* operator -> () {
+      return &m_bc;
+    }
+
+  private:
+
+    Blockchain& m_bc;
+    Blockchain::ReadLock m_lock;
+  };
+
   template<class visitor_t> bool Blockchain::scanOutputKeysForIndexes(const KeyInput& tx_in_to_key, visitor_t& vis, uint32_t* pmax_related_block_height) {
     std::lock_guard<std::recursive_mutex> lk(m_blockchain_lock);
-    auto it = m_outputs.find(tx_in_to_key.amount);
-    if (it == m_outputs.end() || !tx_in_to_key.outputIndexes.size())
+    uint32_t amountOutputCount = getKeyOutputCount(tx_in_to_key.amount);
+    if (amountOutputCount == 0 || !tx_in_to_key.outputIndexes.size())
       return false;
 
     std::vector<uint32_t> absolute_offsets = relative_output_offsets_to_absolute(tx_in_to_key.outputIndexes);
-    std::vector<std::pair<TransactionIndex, uint16_t>>& amount_outs_vec = it->second;
     size_t count = 0;
     for (uint64_t i : absolute_offsets) {
-      if(i >= amount_outs_vec.size() ) {
-        logger(Logging::INFO) << "Wrong index in transaction inputs: " << i << ", expected maximum " << amount_outs_vec.size() - 1;
-        return false;
-      }
-
-      //auto tx_it = m_transactionMap.find(amount_outs_vec[i].first);
-      //if (!(tx_it != m_transactionMap.end())) { logger(ERROR, BRIGHT_RED) << "Wrong transaction id in output indexes: " << Common::podToHex(amount_outs_vec[i].first); return false; }
-
-      const TransactionEntry& tx = transactionByIndex(amount_outs_vec[i].first);
-
-      if (!(amount_outs_vec[i].second < tx.tx.outputs.size())) {
-        logger(Logging::ERROR, Logging::BRIGHT_RED)
-            << "Wrong index in transaction outputs: "
-            << amount_outs_vec[i].second << ", expected less then "
-            << tx.tx.outputs.size();
+      if(i >= amountOutputCount) {
+        logger(Logging::INFO) << "Wrong index in transaction inputs: " << i << ", expected maximum " << amountOutputCount - 1;
         return false;
       }
 
-      if (!vis.handle_output(tx.tx, tx.tx.outputs[amount_outs_vec[i].second], amount_outs_vec[i].second)) {
+      KeyOutputEntry amountOutput = getKeyOutput(tx_in_to_key.amount, static_cast<uint32_t>(i));
+      if (!vis.handle_output(amountOutput)) {
         logger(Logging::INFO) << "Failed to handle_output for output no = " << count << ", with absolute offset " << i;
         return false;
       }
 
       if(count++ == absolute_offsets.size()-1 && pmax_related_block_height) {
-        if (*pmax_related_block_height < amount_outs_vec[i].first.block) {
-          *pmax_related_block_height = amount_outs_vec[i].first.block;
+        if (*pmax_related_block_height < amountOutput.transactionIndex.block) {
+          *pmax_related_block_height = amountOutput.transactionIndex.block;
         }
       }
     }
@@ -0,0 +1,69 @@
+#include "DataBaseBatch.h"
+
+#include <cassert>
+
+namespace CryptoNote {
+
+std::string makeIndexKey(const std::string& prefix, uint64_t index) {
+  std::string key(prefix);
+  key.reserve(prefix.size() + sizeof(index));
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<char>((index >> shift) & 0xff));
+  }
+
+  return key;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void DataBaseWriteBatch::insert(const std::string& key, const std::string& value) {
+  m_rawDataToInsert.emplace_back(key, value);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void DataBaseWriteBatch::insert(const std::string& key, std::string&& value) {
+  m_rawDataToInsert.emplace_back(key, std::move(value));
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void DataBaseWriteBatch::remove(const std::string& key) {
+  m_rawKeysToRemove.push_back(key);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool DataBaseWriteBatch::empty() const {
+  return m_rawDataToInsert.empty() && m_rawKeysToRemove.empty();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::vector<std::pair<std::string, std::string>> DataBaseWriteBatch::extractRawDataToInsert() {
+  std::vector<std::pair<std::string, std::string>> result;
+  result.swap(m_rawDataToInsert);
+  return result;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::vector<std::string> DataBaseWriteBatch::extractRawKeysToRemove() {
+  std::vector<std::string> result;
+  result.swap(m_rawKeysToRemove);
+  return result;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+size_t DataBaseReadBatch::request(const std::string& key) {
+  m_rawKeys.push_back(key);
+  return m_rawKeys.size() - 1;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool DataBaseReadBatch::hasResult(size_t position) const {
+  return position < m_resultStates.size() && m_resultStates[position];
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+const std::string& DataBaseReadBatch::getResult(size_t position) const {
+  assert(hasResult(position));
+  return m_values[position];
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::vector<std::string> DataBaseReadBatch::getRawKeys() const {
+  return m_rawKeys;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void DataBaseReadBatch::submitRawResult(const std::vector<std::string>& values, const std::vector<bool>& resultStates) {
+  assert(values.size() == m_rawKeys.size() && resultStates.size() == m_rawKeys.size());
+  m_values = values;
+  m_resultStates = resultStates;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+} //namespace CryptoNote
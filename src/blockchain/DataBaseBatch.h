@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "IReadBatch.h"
+#include "IWriteBatch.h"
+
+namespace CryptoNote {
+
+// Builds "<prefix><big-endian index>" keys, so LMDB keeps entries of one prefix in index order.
+std::string makeIndexKey(const std::string& prefix, uint64_t index);
+
+class DataBaseWriteBatch : public IWriteBatch {
+
+public:
+
+  void insert(const std::string& key, const std::string& value);
+  void insert(const std::string& key, std::string&& value);
+  void remove(const std::string& key);
+  bool empty() const;
+
+  virtual std::vector<std::pair<std::string, std::string>> extractRawDataToInsert() override;
+  virtual std::vector<std::string> extractRawKeysToRemove() override;
+
+private:
+
+  std::vector<std::pair<std::string, std::string>> m_rawDataToInsert;
+  std::vector<std::string> m_rawKeysToRemove;
+};
+
+class DataBaseReadBatch : public IReadBatch {
+
+public:
+
+  // Returns position of the key in the result
+  size_t request(const std::string& key);
+
+  bool hasResult(size_t position) const;
+  const std::string& getResult(size_t position) const;
+
+  virtual std::vector<std::string> getRawKeys() const override;
+  virtual void submitRawResult(const std::vector<std::string>& values, const std::vector<bool>& resultStates) override;
+
+private:
+
+  std::vector<std::string> m_rawKeys;
+  std::vector<std::string> m_values;
+  std::vector<bool> m_resultStates;
+};
+
+} //namespace CryptoNote
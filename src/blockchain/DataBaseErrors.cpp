@@ -0,0 +1,9 @@
+#include "DataBaseErrors.h"
+
+namespace CryptoNote {
+namespace error {
+
+DataBaseErrorCategory DataBaseErrorCategory::INSTANCE;
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <system_error>
+
+namespace CryptoNote {
+namespace error {
+
+enum class DataBaseErrorCodes : int {
+  NOT_INITIALIZED = 1,
+  ALREADY_INITIALIZED,
+  INTERNAL_ERROR,
+  IO_ERROR
+};
+
+// custom category:
+class DataBaseErrorCategory : public std::error_category {
+
+public:
+
+  static DataBaseErrorCategory INSTANCE;
+
+  virtual const char* name() const throw() override {
+    return "DataBaseErrorCategory";
+  }
+
+  virtual std::error_condition default_error_condition(int ev) const throw() override {
+    return std::error_condition(ev, *this);
+  }
+
+  virtual std::string message(int ev) const override {
+    switch (static_cast<DataBaseErrorCodes>(ev)) {
+      case DataBaseErrorCodes::NOT_INITIALIZED: return "Object was not initialized";
+      case DataBaseErrorCodes::ALREADY_INITIALIZED: return "Object has been already initialized";
+      case DataBaseErrorCodes::INTERNAL_ERROR: return "Internal error";
+      case DataBaseErrorCodes::IO_ERROR: return "IO error";
+      default: return "Unknown error";
+    }
+  }
+
+private:
+
+  DataBaseErrorCategory() {
+  }
+};
+
+inline std::error_code make_error_code(CryptoNote::error::DataBaseErrorCodes e) {
+  return std::error_code(static_cast<int>(e), CryptoNote::error::DataBaseErrorCategory::INSTANCE);
+}
+
+}
+}
+
+namespace std {
+
+template <>
+struct is_error_code_enum<CryptoNote::error::DataBaseErrorCodes>: public true_type {};
+
+}
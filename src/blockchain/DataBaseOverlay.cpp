@@ -0,0 +1,83 @@
+#include "DataBaseOverlay.h"
+
+#include <stdexcept>
+
+#include "DataBaseBatch.h"
+
+namespace CryptoNote {
+
+DataBaseOverlay::DataBaseOverlay(LmdbDataBase& dataBase) : m_dataBase(dataBase) {
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool DataBaseOverlay::get(const std::string& key, std::string& value) {
+  auto it = m_changes.find(key);
+  if (it != m_changes.end()) {
+    if (it->second.first) {
+      value = it->second.second;
+    }
+
+    return it->second.first;
+  }
+
+  bool found;
+  std::error_code ec = m_dataBase.read(key, [&value](const void* data, size_t size) {
+    value.assign(static_cast<const char*>(data), size);
+  }, found);
+
+  if (ec) {
+    throw std::system_error(ec, "DataBaseOverlay::get");
+  }
+
+  return found;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool DataBaseOverlay::contains(const std::string& key) {
+  auto it = m_changes.find(key);
+  if (it != m_changes.end()) {
+    return it->second.first;
+  }
+
+  bool found;
+  std::error_code ec = m_dataBase.read(key, [](const void*, size_t) {}, found);
+  if (ec) {
+    throw std::system_error(ec, "DataBaseOverlay::contains");
+  }
+
+  return found;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void DataBaseOverlay::put(const std::string& key, const std::string& value) {
+  m_changes[key] = std::make_pair(true, value);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void DataBaseOverlay::remove(const std::string& key) {
+  m_changes[key] = std::make_pair(false, std::string());
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool DataBaseOverlay::hasChanges() const {
+  return !m_changes.empty();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code DataBaseOverlay::commit() {
+  DataBaseWriteBatch batch;
+  for (auto& change : m_changes) {
+    if (change.second.first) {
+      batch.insert(change.first, std::move(change.second.second));
+    } else {
+      batch.remove(change.first);
+    }
+  }
+
+  m_changes.clear();
+  return m_dataBase.write(batch);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void DataBaseOverlay::discard() {
+  m_changes.clear();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+LmdbDataBase& DataBaseOverlay::dataBase() {
+  return m_dataBase;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+} //namespace CryptoNote
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "LmdbDataBase.h"
+
+namespace CryptoNote {
+
+// Stages changes on top of LmdbDataBase: reads see staged values, commit() writes all of them in one transaction.
+class DataBaseOverlay {
+
+public:
+
+  explicit DataBaseOverlay(LmdbDataBase& dataBase);
+
+  bool get(const std::string& key, std::string& value);
+  bool contains(const std::string& key);
+  void put(const std::string& key, const std::string& value);
+  void remove(const std::string& key);
+
+  bool hasChanges() const;
+  std::error_code commit();
+  void discard();
+
+  LmdbDataBase& dataBase();
+
+private:
+
+  LmdbDataBase& m_dataBase;
+  std::map<std::string, std::pair<bool, std::string>> m_changes; // key -> (present, value)
+};
+
+} //namespace CryptoNote
@@ -0,0 +1,401 @@
+#include "LmdbDataBase.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "DataBaseErrors.h"
+
+namespace CryptoNote {
+
+namespace {
+
+const uint64_t MAP_SIZE_INCREMENT = 1ULL << 30;
+
+MDB_val toValue(const std::string& data) {
+  MDB_val value;
+  value.mv_size = data.size();
+  value.mv_data = const_cast<char*>(data.data());
+  return value;
+}
+
+std::error_code toErrorCode(int result) {
+  if (result == MDB_SUCCESS) {
+    return std::error_code();
+  }
+
+  if (result == MDB_NOTFOUND || result == MDB_MAP_FULL || result == MDB_MAP_RESIZED || result == MDB_BAD_TXN || result == MDB_CORRUPTED || result == MDB_PANIC) {
+    return make_error_code(error::DataBaseErrorCodes::INTERNAL_ERROR);
+  }
+
+  return make_error_code(error::DataBaseErrorCodes::IO_ERROR);
+}
+
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+LmdbDataBase::LmdbDataBase() : m_env(nullptr), m_dbi(0), m_mapSize(0) {
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+LmdbDataBase::~LmdbDataBase() {
+  shutdown();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void LmdbDataBase::init(const std::string& path, uint64_t initialMapSize) {
+  if (m_env != nullptr) {
+    throw std::system_error(make_error_code(error::DataBaseErrorCodes::ALREADY_INITIALIZED));
+  }
+
+  MDB_env* env;
+  int result = mdb_env_create(&env);
+  if (result != MDB_SUCCESS) {
+    throw std::system_error(toErrorCode(result), std::string("mdb_env_create: ") + mdb_strerror(result));
+  }
+
+  result = mdb_env_set_mapsize(env, static_cast<size_t>(initialMapSize));
+  if (result == MDB_SUCCESS) {
+    // Writes commit asynchronously with respect to the meta page; writeSync forces an fsync.
+    result = mdb_env_open(env, path.c_str(), MDB_NOSUBDIR | MDB_NOMETASYNC | MDB_NOTLS, 0644);
+  }
+
+  if (result != MDB_SUCCESS) {
+    mdb_env_close(env);
+    throw std::system_error(toErrorCode(result), "Failed to open database " + path + ": " + mdb_strerror(result));
+  }
+
+  MDB_txn* txn;
+  result = mdb_txn_begin(env, nullptr, 0, &txn);
+  if (result == MDB_SUCCESS) {
+    result = mdb_dbi_open(txn, nullptr, 0, &m_dbi);
+    if (result == MDB_SUCCESS) {
+      result = mdb_txn_commit(txn);
+    } else {
+      mdb_txn_abort(txn);
+    }
+  }
+
+  if (result != MDB_SUCCESS) {
+    mdb_env_close(env);
+    throw std::system_error(toErrorCode(result), std::string("mdb_dbi_open: ") + mdb_strerror(result));
+  }
+
+  MDB_envinfo info;
+  mdb_env_info(env, &info);
+  m_mapSize = info.me_mapsize;
+  m_env = env;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void LmdbDataBase::shutdown() {
+  if (m_env != nullptr) {
+    mdb_env_sync(m_env, 1);
+    mdb_env_close(m_env);
+    m_env = nullptr;
+  }
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool LmdbDataBase::isInitialized() const {
+  return m_env != nullptr;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::write(IWriteBatch& batch) {
+  return write(batch, false);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::writeSync(IWriteBatch& batch) {
+  return write(batch, true);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::write(IWriteBatch& batch, bool sync) {
+  if (m_env == nullptr) {
+    return make_error_code(error::DataBaseErrorCodes::NOT_INITIALIZED);
+  }
+
+  const std::vector<std::pair<std::string, std::string>> rawData = batch.extractRawDataToInsert();
+  const std::vector<std::string> rawKeys = batch.extractRawKeysToRemove();
+
+  std::lock_guard<std::mutex> writeLock(m_writeMutex);
+  for (;;) {
+    uint64_t mapSize;
+    int result;
+
+    {
+      boost::shared_lock<boost::shared_mutex> resizeLock(m_resizeMutex);
+      mapSize = m_mapSize;
+
+      MDB_txn* txn;
+      result = mdb_txn_begin(m_env, nullptr, 0, &txn);
+      if (result == MDB_MAP_RESIZED) {
+        resizeLock.unlock();
+        std::error_code ec = resizeMap(mapSize, false);
+        if (ec) {
+          return ec;
+        }
+
+        continue;
+      }
+
+      if (result != MDB_SUCCESS) {
+        return toErrorCode(result);
+      }
+
+      for (const auto& item : rawData) {
+        MDB_val key = toValue(item.first);
+        MDB_val value = toValue(item.second);
+        result = mdb_put(txn, m_dbi, &key, &value, 0);
+        if (result != MDB_SUCCESS) {
+          break;
+        }
+      }
+
+      for (auto it = rawKeys.begin(); result == MDB_SUCCESS && it != rawKeys.end(); ++it) {
+        MDB_val key = toValue(*it);
+        result = mdb_del(txn, m_dbi, &key, nullptr);
+        if (result == MDB_NOTFOUND) {
+          result = MDB_SUCCESS;
+        }
+      }
+
+      if (result == MDB_SUCCESS) {
+        result = mdb_txn_commit(txn);
+      } else {
+        mdb_txn_abort(txn);
+      }
+    }
+
+    if (result == MDB_MAP_FULL) {
+      std::error_code ec = resizeMap(mapSize, true);
+      if (ec) {
+        return ec;
+      }
+
+      continue;
+    }
+
+    if (result == MDB_SUCCESS && sync) {
+      result = mdb_env_sync(m_env, 1);
+    }
+
+    return toErrorCode(result);
+  }
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::sync() {
+  if (m_env == nullptr) {
+    return make_error_code(error::DataBaseErrorCodes::NOT_INITIALIZED);
+  }
+
+  return toErrorCode(mdb_env_sync(m_env, 1));
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::read(IReadBatch& batch) {
+  if (m_env == nullptr) {
+    return make_error_code(error::DataBaseErrorCodes::NOT_INITIALIZED);
+  }
+
+  const std::vector<std::string> rawKeys = batch.getRawKeys();
+  std::vector<std::string> values;
+  std::vector<bool> resultStates;
+  values.reserve(rawKeys.size());
+  resultStates.reserve(rawKeys.size());
+
+  {
+    boost::shared_lock<boost::shared_mutex> resizeLock;
+    MDB_txn* txn;
+    std::error_code ec = beginReadTransaction(txn, resizeLock);
+    if (ec) {
+      return ec;
+    }
+
+    for (const auto& rawKey : rawKeys) {
+      MDB_val key = toValue(rawKey);
+      MDB_val value;
+      int result = mdb_get(txn, m_dbi, &key, &value);
+      if (result == MDB_SUCCESS) {
+        values.emplace_back(static_cast<const char*>(value.mv_data), value.mv_size);
+        resultStates.push_back(true);
+      } else if (result == MDB_NOTFOUND) {
+        values.emplace_back();
+        resultStates.push_back(false);
+      } else {
+        mdb_txn_abort(txn);
+        return toErrorCode(result);
+      }
+    }
+
+    mdb_txn_abort(txn);
+  }
+
+  batch.submitRawResult(values, resultStates);
+  return std::error_code();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::read(const std::string& rawKey, const std::function<void(const void*, size_t)>& visitor, bool& found) {
+  if (m_env == nullptr) {
+    return make_error_code(error::DataBaseErrorCodes::NOT_INITIALIZED);
+  }
+
+  boost::shared_lock<boost::shared_mutex> resizeLock;
+  MDB_txn* txn;
+  std::error_code ec = beginReadTransaction(txn, resizeLock);
+  if (ec) {
+    return ec;
+  }
+
+  MDB_val key = toValue(rawKey);
+  MDB_val value;
+  int result = mdb_get(txn, m_dbi, &key, &value);
+  found = result == MDB_SUCCESS;
+  if (found) {
+    try {
+      visitor(value.mv_data, value.mv_size);
+    } catch (...) {
+      mdb_txn_abort(txn);
+      throw;
+    }
+  }
+
+  mdb_txn_abort(txn);
+  return result == MDB_NOTFOUND ? std::error_code() : toErrorCode(result);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::readPrefix(const std::string& prefix, const std::function<bool(const std::string&, const std::string&)>& visitor) {
+  if (m_env == nullptr) {
+    return make_error_code(error::DataBaseErrorCodes::NOT_INITIALIZED);
+  }
+
+  boost::shared_lock<boost::shared_mutex> resizeLock;
+  MDB_txn* txn;
+  std::error_code ec = beginReadTransaction(txn, resizeLock);
+  if (ec) {
+    return ec;
+  }
+
+  MDB_cursor* cursor;
+  int result = mdb_cursor_open(txn, m_dbi, &cursor);
+  if (result != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    return toErrorCode(result);
+  }
+
+  MDB_val key = toValue(prefix);
+  MDB_val value;
+  result = mdb_cursor_get(cursor, &key, &value, MDB_SET_RANGE);
+  while (result == MDB_SUCCESS) {
+    std::string rawKey(static_cast<const char*>(key.mv_data), key.mv_size);
+    if (rawKey.compare(0, prefix.size(), prefix) != 0 || !visitor(rawKey, std::string(static_cast<const char*>(value.mv_data), value.mv_size))) {
+      break;
+    }
+
+    result = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+  }
+
+  mdb_cursor_close(cursor);
+  mdb_txn_abort(txn);
+  return result == MDB_NOTFOUND ? std::error_code() : toErrorCode(result);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::removePrefix(const std::string& prefix) {
+  if (m_env == nullptr) {
+    return make_error_code(error::DataBaseErrorCodes::NOT_INITIALIZED);
+  }
+
+  std::lock_guard<std::mutex> writeLock(m_writeMutex);
+  for (;;) {
+    uint64_t mapSize;
+    int result;
+
+    {
+      boost::shared_lock<boost::shared_mutex> resizeLock(m_resizeMutex);
+      mapSize = m_mapSize;
+
+      MDB_txn* txn;
+      result = mdb_txn_begin(m_env, nullptr, 0, &txn);
+      if (result == MDB_MAP_RESIZED) {
+        resizeLock.unlock();
+        std::error_code ec = resizeMap(mapSize, false);
+        if (ec) {
+          return ec;
+        }
+
+        continue;
+      }
+
+      if (result != MDB_SUCCESS) {
+        return toErrorCode(result);
+      }
+
+      MDB_cursor* cursor;
+      result = mdb_cursor_open(txn, m_dbi, &cursor);
+      if (result != MDB_SUCCESS) {
+        mdb_txn_abort(txn);
+        return toErrorCode(result);
+      }
+
+      // After mdb_cursor_del the cursor already points at the following record, which MDB_NEXT returns.
+      MDB_val key = toValue(prefix);
+      MDB_val value;
+      result = mdb_cursor_get(cursor, &key, &value, MDB_SET_RANGE);
+      while (result == MDB_SUCCESS && key.mv_size >= prefix.size() && memcmp(key.mv_data, prefix.data(), prefix.size()) == 0) {
+        result = mdb_cursor_del(cursor, 0);
+        if (result == MDB_SUCCESS) {
+          result = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+        }
+      }
+
+      mdb_cursor_close(cursor);
+      if (result == MDB_SUCCESS || result == MDB_NOTFOUND) {
+        result = mdb_txn_commit(txn);
+      } else {
+        mdb_txn_abort(txn);
+      }
+    }
+
+    // deletes can split pages too
+    if (result == MDB_MAP_FULL) {
+      std::error_code ec = resizeMap(mapSize, true);
+      if (ec) {
+        return ec;
+      }
+
+      continue;
+    }
+
+    return toErrorCode(result);
+  }
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::resizeMap(uint64_t observedMapSize, bool grow) {
+  boost::unique_lock<boost::shared_mutex> resizeLock(m_resizeMutex);
+  if (m_mapSize != observedMapSize) {
+    return std::error_code();
+  }
+
+  // Size 0 adopts the size another process has already grown the map to.
+  uint64_t newMapSize = grow ? m_mapSize + std::max(MAP_SIZE_INCREMENT, m_mapSize / 2) : 0;
+  int result = mdb_env_set_mapsize(m_env, static_cast<size_t>(newMapSize));
+  if (result != MDB_SUCCESS) {
+    return toErrorCode(result);
+  }
+
+  MDB_envinfo info;
+  mdb_env_info(m_env, &info);
+  m_mapSize = info.me_mapsize;
+  return std::error_code();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::error_code LmdbDataBase::beginReadTransaction(MDB_txn*& txn, boost::shared_lock<boost::shared_mutex>& resizeLock) {
+  for (;;) {
+    resizeLock = boost::shared_lock<boost::shared_mutex>(m_resizeMutex);
+    uint64_t mapSize = m_mapSize;
+    int result = mdb_txn_begin(m_env, nullptr, MDB_RDONLY, &txn);
+    if (result != MDB_MAP_RESIZED) {
+      return toErrorCode(result);
+    }
+
+    resizeLock.unlock();
+    std::error_code ec = resizeMap(mapSize, false);
+    if (ec) {
+      return ec;
+    }
+  }
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+} //namespace CryptoNote
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <system_error>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <lmdb.h>
+
+#include "IDataBase.h"
+
+namespace CryptoNote {
+
+// IDataBase over a single LMDB environment. Every write batch is committed as one
+// transaction, so callers get all-or-nothing semantics per batch.
+class LmdbDataBase : public IDataBase {
+
+public:
+
+  LmdbDataBase();
+  LmdbDataBase(const LmdbDataBase&) = delete;
+  LmdbDataBase(LmdbDataBase&&) = delete;
+
+  virtual ~LmdbDataBase();
+
+  LmdbDataBase& operator=(const LmdbDataBase&) = delete;
+
+  void init(const std::string& path, uint64_t initialMapSize = DEFAULT_MAP_SIZE);
+  void shutdown();
+  bool isInitialized() const;
+
+  virtual std::error_code write(IWriteBatch& batch) override;
+  virtual std::error_code writeSync(IWriteBatch& batch) override;
+
+  virtual std::error_code read(IReadBatch& batch) override;
+
+  // Flushes commits made by write() to disk.
+  std::error_code sync();
+
+  // Zero-copy single key lookup: visitor sees the value in the mapped region and must not keep the pointer.
+  std::error_code read(const std::string& key, const std::function<void(const void*, size_t)>& visitor, bool& found);
+  // Visits keys starting with prefix in key order until visitor returns false.
+  std::error_code readPrefix(const std::string& prefix, const std::function<bool(const std::string&, const std::string&)>& visitor);
+  std::error_code removePrefix(const std::string& prefix);
+
+  static const uint64_t DEFAULT_MAP_SIZE = 1ULL << 30;
+
+private:
+
+  std::error_code write(IWriteBatch& batch, bool sync);
+  std::error_code resizeMap(uint64_t observedMapSize, bool grow);
+  std::error_code beginReadTransaction(MDB_txn*& txn, boost::shared_lock<boost::shared_mutex>& resizeLock);
+
+  MDB_env* m_env;
+  MDB_dbi m_dbi;
+  uint64_t m_mapSize;
+  std::mutex m_writeMutex;
+  boost::shared_mutex m_resizeMutex; // shared by transactions, exclusive while the map is being resized
+};
+
+} //namespace CryptoNote
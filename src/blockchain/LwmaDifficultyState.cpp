@@ -0,0 +1,93 @@
+#include "LwmaDifficultyState.h"
+
+#include "core/Currency.h"
+
+namespace CryptoNote {
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+LwmaDifficultyState::LwmaDifficultyState(const Currency& currency) :
+  m_currency(currency),
+  m_height(0),
+  m_windowSize(static_cast<uint32_t>(currency.difficultyWindowv1())),
+  m_valid(false),
+  m_weightedSolveTime(0),
+  m_solveTimeSum(0) {
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void LwmaDifficultyState::reset(uint32_t height, const BlockReader& chain) {
+  m_height = height;
+  m_valid = hasWindow(height);
+  m_weightedSolveTime = 0;
+  m_solveTimeSum = 0;
+  if (!m_valid) {
+    return;
+  }
+
+  // solve times of blocks [height - N, height) get weights 1..N
+  uint32_t solveTimeCount = m_windowSize - 1;
+  for (uint32_t i = 1; i <= solveTimeCount; ++i) {
+    int64_t time = solveTime(height - solveTimeCount - 1 + i, chain);
+    m_weightedSolveTime += time * i;
+    m_solveTimeSum += time;
+  }
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void LwmaDifficultyState::push(const BlockReader& chain) {
+  if (!m_valid) {
+    reset(m_height + 1, chain);
+    return;
+  }
+
+  // every solve time in the window loses one weight, the oldest one drops out and the new one gets the top weight
+  uint32_t solveTimeCount = m_windowSize - 1;
+  int64_t time = solveTime(m_height, chain);
+  m_weightedSolveTime += static_cast<int64_t>(solveTimeCount) * time - m_solveTimeSum;
+  m_solveTimeSum += time - solveTime(m_height - solveTimeCount, chain);
+  ++m_height;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void LwmaDifficultyState::pop(const BlockReader& chain) {
+  if (!m_valid || !hasWindow(m_height - 1)) {
+    reset(m_height - 1, chain);
+    return;
+  }
+
+  uint32_t solveTimeCount = m_windowSize - 1;
+  int64_t time = solveTime(m_height - 1, chain);
+  m_solveTimeSum += solveTime(m_height - 1 - solveTimeCount, chain) - time;
+  m_weightedSolveTime += m_solveTimeSum - static_cast<int64_t>(solveTimeCount) * time;
+  --m_height;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+difficulty_type LwmaDifficultyState::nextDifficulty(const BlockReader& chain) const {
+  // If coin is starting, this will be activated.
+  if (!m_valid) {
+    return 1;
+  }
+
+  uint64_t timestamp;
+  difficulty_type first;
+  difficulty_type last;
+  difficulty_type previous;
+  chain(m_height - m_windowSize, timestamp, first);
+  chain(m_height - 2, timestamp, previous);
+  chain(m_height - 1, timestamp, last);
+
+  int64_t lastSolveTimes = solveTime(m_height - 3, chain) + solveTime(m_height - 2, chain) + solveTime(m_height - 1, chain);
+  return m_currency.lwmaDifficulty(last - first, last - previous, m_weightedSolveTime, lastSolveTimes);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+int64_t LwmaDifficultyState::solveTime(uint32_t height, const BlockReader& chain) const {
+  uint64_t timestamp;
+  uint64_t previousTimestamp;
+  difficulty_type cumulativeDifficulty;
+  chain(height, timestamp, cumulativeDifficulty);
+  chain(height - 1, previousTimestamp, cumulativeDifficulty);
+  return m_currency.lwmaSolveTime(timestamp, previousTimestamp);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool LwmaDifficultyState::hasWindow(uint32_t height) const {
+  // the window never includes the genesis block
+  return height > m_windowSize;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "core/Difficulty.h"
+
+namespace CryptoNote
+{
+  class Currency;
+
+  // Weighted solve time sums of the LWMA-2 difficulty window, updated in constant time as blocks are pushed and popped.
+  // Blocks are read through a BlockReader, so the same state follows the main chain or an alternative chain.
+  class LwmaDifficultyState {
+
+  public:
+
+    typedef std::function<void(uint32_t height, uint64_t& timestamp, difficulty_type& cumulativeDifficulty)> BlockReader;
+
+    explicit LwmaDifficultyState(const Currency& currency);
+
+    // chain holds blocks [0, height)
+    void reset(uint32_t height, const BlockReader& chain);
+    // chain holds blocks [0, height()], the new block included
+    void push(const BlockReader& chain);
+    // chain holds blocks [0, height()), the block being removed included
+    void pop(const BlockReader& chain);
+
+    uint32_t height() const {
+      return m_height;
+    }
+
+    difficulty_type nextDifficulty(const BlockReader& chain) const;
+
+  private:
+
+    int64_t solveTime(uint32_t height, const BlockReader& chain) const;
+    bool hasWindow(uint32_t height) const;
+
+    const Currency& m_currency;
+    uint32_t m_height;
+    uint32_t m_windowSize;
+    bool m_valid;
+    int64_t m_weightedSolveTime;
+    int64_t m_solveTimeSum;
+
+  };
+}
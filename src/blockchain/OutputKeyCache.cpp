@@ -0,0 +1,53 @@
+#include "OutputKeyCache.h"
+
+namespace CryptoNote
+{
+
+OutputKeyCache::OutputKeyCache(size_t capacity) : m_capacity(capacity), m_hits(0), m_misses(0) {
+}
+
+std::shared_ptr<const Crypto::RingMemberTables> OutputKeyCache::get(const Crypto::PublicKey& key) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+      ++m_hits;
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      return it->second->second;
+    }
+
+    ++m_misses;
+  }
+
+  // computed outside of the lock, a key missed by two threads at once is just decompressed twice
+  std::shared_ptr<Crypto::RingMemberTables> tables = std::make_shared<Crypto::RingMemberTables>();
+  if (!Crypto::precompute_ring_member(key, *tables)) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_capacity == 0 || m_index.count(key) != 0) {
+    return tables;
+  }
+
+  m_entries.emplace_front(key, tables);
+  m_index.emplace(key, m_entries.begin());
+  if (m_entries.size() > m_capacity) {
+    m_index.erase(m_entries.back().first);
+    m_entries.pop_back();
+  }
+
+  return tables;
+}
+
+uint64_t OutputKeyCache::hits() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hits;
+}
+
+uint64_t OutputKeyCache::misses() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_misses;
+}
+
+}
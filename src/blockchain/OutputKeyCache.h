@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "crypto/crypto.h"
+
+namespace CryptoNote
+{
+  // Decompressed ring members by output key, least recently used evicted first. Popular outputs show up in many
+  // rings, so ring signature checks mostly skip the point decompression and hash_to_ec. Safe to use from several threads.
+  class OutputKeyCache {
+
+  public:
+
+    explicit OutputKeyCache(size_t capacity);
+
+    // Returns nullptr if the key is not a valid curve point.
+    std::shared_ptr<const Crypto::RingMemberTables> get(const Crypto::PublicKey& key);
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+  private:
+
+    typedef std::pair<Crypto::PublicKey, std::shared_ptr<const Crypto::RingMemberTables>> Entry;
+
+    const size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::list<Entry> m_entries; // most recently used first
+    std::unordered_map<Crypto::PublicKey, std::list<Entry>::iterator> m_index;
+    uint64_t m_hits;
+    uint64_t m_misses;
+  };
+}
@@ -0,0 +1,62 @@
+#include "RingSignatureCache.h"
+
+#include "base/CryptoNoteTools.h"
+
+namespace CryptoNote
+{
+
+RingSignatureCache::RingSignatureCache(size_t capacity) : m_capacity(capacity), m_hits(0), m_misses(0) {
+}
+
+Crypto::Hash RingSignatureCache::makeKey(const Crypto::Hash& prefixHash, const Crypto::KeyImage& keyImage, const std::vector<Crypto::PublicKey>& keys,
+  const Crypto::Signature* signatures) {
+  // signatures are not covered by the prefix hash and ring members depend on the chain the input was resolved against
+  BinaryArray data;
+  data.reserve(sizeof(prefixHash) + sizeof(keyImage) + keys.size() * (sizeof(Crypto::PublicKey) + sizeof(Crypto::Signature)));
+  data.insert(data.end(), prefixHash.data, prefixHash.data + sizeof(prefixHash.data));
+  data.insert(data.end(), keyImage.data, keyImage.data + sizeof(keyImage.data));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const uint8_t* key = reinterpret_cast<const uint8_t*>(&keys[i]);
+    const uint8_t* signature = reinterpret_cast<const uint8_t*>(&signatures[i]);
+    data.insert(data.end(), key, key + sizeof(Crypto::PublicKey));
+    data.insert(data.end(), signature, signature + sizeof(Crypto::Signature));
+  }
+
+  return getBinaryArrayHash(data);
+}
+
+bool RingSignatureCache::contains(const Crypto::Hash& key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_keys.count(key) != 0) {
+    ++m_hits;
+    return true;
+  }
+
+  ++m_misses;
+  return false;
+}
+
+void RingSignatureCache::insert(const Crypto::Hash& key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_capacity == 0 || !m_keys.insert(key).second) {
+    return;
+  }
+
+  m_order.push_back(key);
+  if (m_order.size() > m_capacity) {
+    m_keys.erase(m_order.front());
+    m_order.pop_front();
+  }
+}
+
+uint64_t RingSignatureCache::hits() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hits;
+}
+
+uint64_t RingSignatureCache::misses() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_misses;
+}
+
+}
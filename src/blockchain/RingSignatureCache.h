@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "crypto/crypto.h"
+#include "crypto/hash.h"
+
+namespace CryptoNote
+{
+  // Ring signatures that already passed verification, so a transaction checked on mempool admission or template
+  // building isn't verified again when its block arrives. Safe to use from several threads.
+  class RingSignatureCache {
+
+  public:
+
+    explicit RingSignatureCache(size_t capacity);
+
+    // Identifies one input: the signed prefix, its key image, the resolved ring members and the signatures.
+    static Crypto::Hash makeKey(const Crypto::Hash& prefixHash, const Crypto::KeyImage& keyImage, const std::vector<Crypto::PublicKey>& keys,
+      const Crypto::Signature* signatures);
+
+    bool contains(const Crypto::Hash& key);
+    void insert(const Crypto::Hash& key);
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+  private:
+
+    const size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::unordered_set<Crypto::Hash> m_keys;
+    std::deque<Crypto::Hash> m_order; // oldest first, evicted once the cache is full
+    uint64_t m_hits;
+    uint64_t m_misses;
+  };
+}
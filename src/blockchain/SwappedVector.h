@@ -2,18 +2,18 @@
 
 #include <cstdint>
 #include <cstddef>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
-#include <list>
-#include <map>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
-#include "common/StdInputStream.h"
-#include "common/StdOutputStream.h"
+#include "common/MemoryInputStream.h"
+#include "common/VectorOutputStream.h"
 #include "Serialization/BinaryInputStreamSerializer.h"
 #include "Serialization/BinaryOutputStreamSerializer.h"
+#include "SwappedVectorStorage.h"
 
 template<class T> class SwappedVector {
 public:
@@ -131,7 +131,9 @@ public:
   ~SwappedVector();
   //SwappedVector& operator=(const SwappedVector&) = delete;
 
-  bool open(const std::string& itemFileName, const std::string& indexFileName, size_t poolSize);
+  // poolSize limits cached items, poolBytes (0 for no limit) their total serialized size.
+  bool open(const std::string& itemFileName, const std::string& indexFileName, size_t poolSize, uint64_t poolBytes = 0);
+  bool open(std::unique_ptr<CryptoNote::ISwappedVectorStorage> storage, size_t poolSize, uint64_t poolBytes = 0);
   void close();
 
   bool empty() const;
@@ -144,106 +146,128 @@ public:
   void clear();
   void pop_back();
   void push_back(const T& item);
+  uint64_t cacheHits() const;
+  uint64_t cacheMisses() const;
+  // Copies the serialized item without touching the cache, so bulk scans do not evict hot items.
+  void readBlob(uint64_t index, std::vector<uint8_t>& blob);
+  // Hands the item to visitor without touching the cache. Unlike operator[] it may run on other threads next to
+  // the members above, the items they returned stay cached. visitor must not use the vector.
+  template<class Visitor> void read(uint64_t index, Visitor visitor);
 
 private:
-  struct ItemEntry;
-  struct CacheEntry;
+  // 2Q cache: items enter the recent FIFO and move to the frequent LRU when touched again, so a single pass
+  // over many items only cycles the recent queue. Keys evicted from the recent queue are remembered as ghosts
+  // and go straight to the frequent queue when read back.
+  // Items and ghosts live in a slot array allocated by open(); the queues are linked through slot numbers and an
+  // open addressing table maps item indexes to slots, so cache misses don't allocate bookkeeping nodes.
+  enum Queue : uint8_t {
+    RECENT,
+    FREQUENT,
+    GHOSTS,
+    FREE,
+    QUEUE_COUNT
+  };
 
-  struct ItemEntry {
-  public:
+  struct Slot {
     T item;
-    typename std::list<CacheEntry>::iterator cacheIter;
+    uint64_t index;
+    uint64_t size;
+    uint32_t prev;
+    uint32_t next;
+    Queue queue;
   };
 
-  struct CacheEntry {
-  public:
-    typename std::map<uint64_t, ItemEntry>::iterator itemIter;
+  struct QueueList {
+    uint32_t head;
+    uint32_t tail;
+    size_t count;
   };
 
-  std::fstream m_itemsFile;
-  std::fstream m_indexesFile;
+  static const uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+  std::mutex m_mutex; // guards the cache and the storage, not m_size
+  std::unique_ptr<CryptoNote::ISwappedVectorStorage> m_storage;
   size_t m_poolSize;
-  std::vector<uint64_t> m_offsets;
-  uint64_t m_itemsFileSize;
-  std::map<uint64_t, ItemEntry> m_items;
-  std::list<CacheEntry> m_cache;
+  uint64_t m_poolBytes;
+  uint64_t m_size;
+  std::vector<Slot> m_slots;
+  std::vector<uint32_t> m_buckets; // slot numbers, NO_SLOT for empty buckets
+  QueueList m_queues[QUEUE_COUNT];
+  uint64_t m_cachedBytes;
+  uint64_t m_recentBytes;
+  uint64_t m_lastIndex;
   uint64_t m_cacheHits;
   uint64_t m_cacheMisses;
 
-  T* prepare(uint64_t index);
+  T* prepare(uint64_t index, uint64_t size);
+  void evict(uint64_t incomingSize);
+  void erase(uint32_t slot);
+  uint32_t allocateSlot();
+  void releaseSlot(uint32_t slot);
+  size_t cachedCount() const;
+  void link(uint32_t slot, Queue queue);
+  void unlink(uint32_t slot);
+  size_t bucketOf(uint64_t index) const;
+  uint32_t findSlot(uint64_t index) const;
+  void insertSlotIndex(uint32_t slot);
+  void eraseSlotIndex(uint64_t index);
+  void resetCache();
 };
 
-template<class T> SwappedVector<T>::SwappedVector() {
+template<class T> const uint32_t SwappedVector<T>::NO_SLOT;
+
+template<class T> SwappedVector<T>::SwappedVector() : m_poolSize(0), m_poolBytes(0), m_size(0), m_cachedBytes(0), m_recentBytes(0),
+  m_lastIndex(std::numeric_limits<uint64_t>::max()), m_cacheHits(0), m_cacheMisses(0) {
 }
 
 template<class T> SwappedVector<T>::~SwappedVector() {
   close();
 }
 
-template<class T> bool SwappedVector<T>::open(const std::string& itemFileName, const std::string& indexFileName, size_t poolSize) {
-  if (poolSize == 0) {
+template<class T> bool SwappedVector<T>::open(const std::string& itemFileName, const std::string& indexFileName, size_t poolSize, uint64_t poolBytes) {
+  std::unique_ptr<CryptoNote::SwappedVectorFileStorage> storage(new CryptoNote::SwappedVectorFileStorage());
+  if (!storage->open(itemFileName, indexFileName)) {
     return false;
   }
 
-  m_itemsFile.open(itemFileName, std::ios::in | std::ios::out | std::ios::binary);
-  m_indexesFile.open(indexFileName, std::ios::in | std::ios::out | std::ios::binary);
-  if (m_itemsFile && m_indexesFile) {
-    uint64_t count;
-    m_indexesFile.read(reinterpret_cast<char*>(&count), sizeof count);
-    if (!m_indexesFile) {
-      return false;
-    }
-
-    std::vector<uint64_t> offsets;
-    uint64_t itemsFileSize = 0;
-    for (uint64_t i = 0; i < count; ++i) {
-      uint32_t itemSize;
-      m_indexesFile.read(reinterpret_cast<char*>(&itemSize), sizeof itemSize);
-      if (!m_indexesFile) {
-        return false;
-      }
-
-      offsets.emplace_back(itemsFileSize);
-      itemsFileSize += itemSize;
-    }
+  return open(std::move(storage), poolSize, poolBytes);
+}
 
-    m_offsets.swap(offsets);
-    m_itemsFileSize = itemsFileSize;
-  } else {
-    m_itemsFile.open(itemFileName, std::ios::out | std::ios::binary);
-    m_itemsFile.close();
-    m_itemsFile.open(itemFileName, std::ios::in | std::ios::out | std::ios::binary);
-    m_indexesFile.open(indexFileName, std::ios::out | std::ios::binary);
-    uint64_t count = 0;
-    m_indexesFile.write(reinterpret_cast<char*>(&count), sizeof count);
-    if (!m_indexesFile) {
-      return false;
-    }
-
-    m_indexesFile.close();
-    m_indexesFile.open(indexFileName, std::ios::in | std::ios::out | std::ios::binary);
-    m_offsets.clear();
-    m_itemsFileSize = 0;
+template<class T> bool SwappedVector<T>::open(std::unique_ptr<CryptoNote::ISwappedVectorStorage> storage, size_t poolSize, uint64_t poolBytes) {
+  if (poolSize == 0 || poolSize > std::numeric_limits<uint32_t>::max() / 2 || !storage) {
+    return false;
   }
 
+  m_storage = std::move(storage);
+  m_size = m_storage->size();
   m_poolSize = poolSize;
-  m_items.clear();
-  m_cache.clear();
+  m_poolBytes = poolBytes;
+  resetCache();
   m_cacheHits = 0;
   m_cacheMisses = 0;
   return true;
 }
 
 template<class T> void SwappedVector<T>::close() {
-  std::cout << "SwappedVector cache hits: " << m_cacheHits << ", misses: " << m_cacheMisses << " (" << std::fixed << std::setprecision(2) << static_cast<double>(m_cacheMisses) / (m_cacheHits + m_cacheMisses) * 100 << "%)" << std::endl;
+  m_storage.reset();
+  m_size = 0;
+  resetCache();
+}
+
+template<class T> uint64_t SwappedVector<T>::cacheHits() const {
+  return m_cacheHits;
+}
+
+template<class T> uint64_t SwappedVector<T>::cacheMisses() const {
+  return m_cacheMisses;
 }
 
 template<class T> bool SwappedVector<T>::empty() const {
-  return m_offsets.empty();
+  return m_size == 0;
 }
 
 template<class T> uint64_t SwappedVector<T>::size() const {
-  return m_offsets.size();
+  return m_size;
 }
 
 template<class T> typename SwappedVector<T>::const_iterator SwappedVector<T>::begin() {
@@ -251,36 +275,43 @@ template<class T> typename SwappedVector<T>::const_iterator SwappedVector<T>::be
 }
 
 template<class T> typename SwappedVector<T>::const_iterator SwappedVector<T>::end() {
-  return const_iterator(this, m_offsets.size());
+  return const_iterator(this, m_size);
 }
 
 template<class T> const T& SwappedVector<T>::operator[](uint64_t index) {
-  auto itemIter = m_items.find(index);
-  if (itemIter != m_items.end()) {
-    if (itemIter->second.cacheIter != --m_cache.end()) {
-      m_cache.splice(m_cache.end(), m_cache, itemIter->second.cacheIter);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  uint32_t slot = findSlot(index);
+  if (slot != NO_SLOT && m_slots[slot].queue != GHOSTS) {
+    Slot& entry = m_slots[slot];
+    if (entry.queue == FREQUENT) {
+      unlink(slot);
+      link(slot, FREQUENT);
+    } else if (index != m_lastIndex) {
+      // back-to-back reads of one item are a single reference, anything later earns a place in the frequent queue
+      unlink(slot);
+      m_recentBytes -= entry.size;
+      link(slot, FREQUENT);
     }
 
+    m_lastIndex = index;
     ++m_cacheHits;
-    return itemIter->second.item;
+    return entry.item;
   }
 
-  if (index >= m_offsets.size()) {
+  if (index >= m_size || !m_storage) {
     throw std::runtime_error("SwappedVector::operator[]");
   }
 
-  if (!m_itemsFile) {
-    throw std::runtime_error("SwappedVector::operator[]");
-  }
-
-  m_itemsFile.seekg(m_offsets[index]);
   T tempItem;
-  
-  Common::StdInputStream stream(m_itemsFile);
-  CryptoNote::BinaryInputStreamSerializer archive(stream);
-  serialize(tempItem, archive);
-
-  T* item = prepare(index);
+  uint64_t itemSize = 0;
+  m_storage->read(index, [&tempItem, &itemSize](const void* data, size_t size) {
+    Common::MemoryInputStream stream(data, size);
+    CryptoNote::BinaryInputStreamSerializer archive(stream);
+    serialize(tempItem, archive);
+    itemSize = size;
+  });
+
+  T* item = prepare(index, itemSize);
   std::swap(tempItem, *item);
   ++m_cacheMisses;
   return *item;
@@ -291,102 +322,298 @@ template<class T> const T& SwappedVector<T>::front() {
 }
 
 template<class T> const T& SwappedVector<T>::back() {
-  return operator[](m_offsets.size() - 1);
+  return operator[](m_size - 1);
 }
 
 template<class T> void SwappedVector<T>::clear() {
-  if (!m_indexesFile) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_storage) {
     throw std::runtime_error("SwappedVector::clear");
   }
 
-  m_indexesFile.seekp(0);
-  uint64_t count = 0;
-  m_indexesFile.write(reinterpret_cast<char*>(&count), sizeof count);
-  if (!m_indexesFile) {
-    throw std::runtime_error("SwappedVector::clear");
-  }
-
-  m_offsets.clear();
-  m_itemsFileSize = 0;
-  m_items.clear();
-  m_cache.clear();
+  m_storage->clear();
+  m_size = 0;
+  resetCache();
 }
 
 template<class T> void SwappedVector<T>::pop_back() {
-  if (!m_indexesFile) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_storage) {
     throw std::runtime_error("SwappedVector::pop_back");
   }
 
-  m_indexesFile.seekp(0);
-  uint64_t count = m_offsets.size() - 1;
-  m_indexesFile.write(reinterpret_cast<char*>(&count), sizeof count);
-  if (!m_indexesFile) {
-    throw std::runtime_error("SwappedVector::pop_back");
-  }
+  m_storage->pop_back();
+  --m_size;
+  uint32_t slot = findSlot(m_size);
+  if (slot != NO_SLOT) {
+    if (m_slots[slot].queue == GHOSTS) {
+      unlink(slot);
+    } else {
+      erase(slot);
+    }
 
-  m_itemsFileSize = m_offsets.back();
-  m_offsets.pop_back();
-  auto itemIter = m_items.find(m_offsets.size());
-  if (itemIter != m_items.end()) {
-    m_cache.erase(itemIter->second.cacheIter);
-    m_items.erase(itemIter);
+    releaseSlot(slot);
   }
 }
 
 template<class T> void SwappedVector<T>::push_back(const T& item) {
-  uint64_t itemsFileSize;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_storage) {
+    throw std::runtime_error("SwappedVector::push_back");
+  }
 
+  std::vector<uint8_t> blob;
   {
-    if (!m_itemsFile) {
-      throw std::runtime_error("SwappedVector::push_back");
-    }
-
-    m_itemsFile.seekp(m_itemsFileSize);
-
-    Common::StdOutputStream stream(m_itemsFile);
+    Common::VectorOutputStream stream(blob);
     CryptoNote::BinaryOutputStreamSerializer archive(stream);
     serialize(const_cast<T&>(item), archive);
+  }
+
+  m_storage->push_back(blob);
+  ++m_size;
 
-    itemsFileSize = m_itemsFile.tellp();
+  T* newItem = prepare(m_size - 1, blob.size());
+  *newItem = item;
+}
+
+template<class T> void SwappedVector<T>::readBlob(uint64_t index, std::vector<uint8_t>& blob) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (index >= m_size || !m_storage) {
+    throw std::runtime_error("SwappedVector::readBlob");
   }
 
+  m_storage->read(index, [&blob](const void* data, size_t size) {
+    blob.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+  });
+}
+
+template<class T> template<class Visitor> void SwappedVector<T>::read(uint64_t index, Visitor visitor) {
+  std::vector<uint8_t> blob;
   {
-    if (!m_indexesFile) {
-      throw std::runtime_error("SwappedVector::push_back");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t slot = findSlot(index);
+    if (slot != NO_SLOT && m_slots[slot].queue != GHOSTS) {
+      visitor(static_cast<const T&>(m_slots[slot].item));
+      return;
     }
 
-    m_indexesFile.seekp(sizeof(uint64_t) + sizeof(uint32_t) * m_offsets.size());
-    uint32_t itemSize = static_cast<uint32_t>(itemsFileSize - m_itemsFileSize);
-    m_indexesFile.write(reinterpret_cast<char*>(&itemSize), sizeof itemSize);
-    if (!m_indexesFile) {
-      throw std::runtime_error("SwappedVector::push_back");
+    if (index >= m_size || !m_storage) {
+      throw std::runtime_error("SwappedVector::read");
     }
 
-    m_indexesFile.seekp(0);
-    uint64_t count = m_offsets.size() + 1;
-    m_indexesFile.write(reinterpret_cast<char*>(&count), sizeof count);
-    if (!m_indexesFile) {
-      throw std::runtime_error("SwappedVector::push_back");
+    m_storage->read(index, [&blob](const void* data, size_t size) {
+      blob.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    });
+  }
+
+  // a miss is deserialized outside the lock and dropped afterwards
+  T item;
+  Common::MemoryInputStream stream(blob.data(), blob.size());
+  CryptoNote::BinaryInputStreamSerializer archive(stream);
+  serialize(item, archive);
+  visitor(static_cast<const T&>(item));
+}
+
+template<class T> T* SwappedVector<T>::prepare(uint64_t index, uint64_t size) {
+  evict(size);
+
+  Queue queue = RECENT;
+  uint32_t slot = findSlot(index);
+  if (slot != NO_SLOT) {
+    // a ghost, the slot still carries its index
+    unlink(slot);
+    queue = FREQUENT;
+  } else {
+    slot = allocateSlot();
+    m_slots[slot].index = index;
+    insertSlotIndex(slot);
+  }
+
+  Slot& entry = m_slots[slot];
+  entry.size = size;
+  link(slot, queue);
+  if (queue == RECENT) {
+    m_recentBytes += size;
+  }
+
+  m_cachedBytes += size;
+  m_lastIndex = index;
+  return &entry.item;
+}
+
+template<class T> void SwappedVector<T>::evict(uint64_t incomingSize) {
+  // The item returned by the last operator[] stays, callers may still hold a reference to it while they look up
+  // another one. The pool can exceed its limits by that item.
+  uint32_t pinnedSlot = findSlot(m_lastIndex);
+  size_t pinnedCount = pinnedSlot != NO_SLOT && m_slots[pinnedSlot].queue != GHOSTS ? 1 : 0;
+  while (cachedCount() > pinnedCount && (cachedCount() >= m_poolSize || (m_poolBytes != 0 && m_cachedBytes + incomingSize > m_poolBytes))) {
+    bool recentOverflow = m_queues[RECENT].count > m_poolSize / 4 || (m_poolBytes != 0 && m_recentBytes > m_poolBytes / 4);
+    bool fromRecent = m_queues[RECENT].count != 0 && (recentOverflow || m_queues[FREQUENT].count == 0);
+    uint32_t victim = m_queues[fromRecent ? RECENT : FREQUENT].head;
+    if (victim != NO_SLOT && victim == pinnedSlot) {
+      victim = m_slots[victim].next;
+    }
+
+    if (victim == NO_SLOT) {
+      // the pinned item is all this queue holds
+      fromRecent = !fromRecent;
+      victim = m_queues[fromRecent ? RECENT : FREQUENT].head;
+      if (victim == pinnedSlot) {
+        victim = m_slots[victim].next;
+      }
+    }
+
+    erase(victim);
+    if (!fromRecent) {
+      releaseSlot(victim);
+      continue;
+    }
+
+    link(victim, GHOSTS);
+    if (m_queues[GHOSTS].count > cachedCount() / 2 + 1) {
+      uint32_t ghost = m_queues[GHOSTS].head;
+      unlink(ghost);
+      releaseSlot(ghost);
     }
   }
+}
 
-  m_offsets.push_back(m_itemsFileSize);
-  m_itemsFileSize = itemsFileSize;
+// Takes an item slot out of its queue and drops the item, the slot keeps its index for a ghost.
+template<class T> void SwappedVector<T>::erase(uint32_t slot) {
+  Slot& entry = m_slots[slot];
+  if (entry.queue == RECENT) {
+    m_recentBytes -= entry.size;
+  }
 
-  T* newItem = prepare(m_offsets.size() - 1);
-  *newItem = item;
+  unlink(slot);
+  m_cachedBytes -= entry.size;
+  entry.item = T();
+}
+
+template<class T> uint32_t SwappedVector<T>::allocateSlot() {
+  uint32_t slot = m_queues[FREE].head;
+  if (slot != NO_SLOT) {
+    unlink(slot);
+    return slot;
+  }
+
+  // only ghosts can fill the array, the oldest one gives up its slot
+  slot = m_queues[GHOSTS].head;
+  unlink(slot);
+  eraseSlotIndex(m_slots[slot].index);
+  return slot;
+}
+
+// Returns an unlinked slot to the free list.
+template<class T> void SwappedVector<T>::releaseSlot(uint32_t slot) {
+  eraseSlotIndex(m_slots[slot].index);
+  link(slot, FREE);
+}
+
+template<class T> size_t SwappedVector<T>::cachedCount() const {
+  return m_queues[RECENT].count + m_queues[FREQUENT].count;
 }
 
-template<class T> T* SwappedVector<T>::prepare(uint64_t index) {
-  if (m_items.size() == m_poolSize) {
-    auto cacheIter = m_cache.begin();
-    m_items.erase(cacheIter->itemIter);
-    m_cache.erase(cacheIter);
+template<class T> void SwappedVector<T>::link(uint32_t slot, Queue queue) {
+  Slot& entry = m_slots[slot];
+  QueueList& list = m_queues[queue];
+  entry.queue = queue;
+  entry.prev = list.tail;
+  entry.next = NO_SLOT;
+  if (list.tail != NO_SLOT) {
+    m_slots[list.tail].next = slot;
+  } else {
+    list.head = slot;
+  }
+
+  list.tail = slot;
+  ++list.count;
+}
+
+template<class T> void SwappedVector<T>::unlink(uint32_t slot) {
+  Slot& entry = m_slots[slot];
+  QueueList& list = m_queues[entry.queue];
+  if (entry.prev != NO_SLOT) {
+    m_slots[entry.prev].next = entry.next;
+  } else {
+    list.head = entry.next;
+  }
+
+  if (entry.next != NO_SLOT) {
+    m_slots[entry.next].prev = entry.prev;
+  } else {
+    list.tail = entry.prev;
+  }
+
+  --list.count;
+}
+
+template<class T> size_t SwappedVector<T>::bucketOf(uint64_t index) const {
+  return static_cast<size_t>((index * 0x9e3779b97f4a7c15ull) >> 32) & (m_buckets.size() - 1);
+}
+
+template<class T> uint32_t SwappedVector<T>::findSlot(uint64_t index) const {
+  if (m_buckets.empty()) {
+    return NO_SLOT;
+  }
+
+  for (size_t bucket = bucketOf(index);; bucket = (bucket + 1) & (m_buckets.size() - 1)) {
+    uint32_t slot = m_buckets[bucket];
+    if (slot == NO_SLOT || m_slots[slot].index == index) {
+      return slot;
+    }
+  }
+}
+
+template<class T> void SwappedVector<T>::insertSlotIndex(uint32_t slot) {
+  size_t bucket = bucketOf(m_slots[slot].index);
+  while (m_buckets[bucket] != NO_SLOT) {
+    bucket = (bucket + 1) & (m_buckets.size() - 1);
+  }
+
+  m_buckets[bucket] = slot;
+}
+
+template<class T> void SwappedVector<T>::eraseSlotIndex(uint64_t index) {
+  const size_t mask = m_buckets.size() - 1;
+  size_t hole = bucketOf(index);
+  while (m_slots[m_buckets[hole]].index != index) {
+    hole = (hole + 1) & mask;
+  }
+
+  // later entries of the probe run move back into the hole unless that would put them before their home bucket
+  m_buckets[hole] = NO_SLOT;
+  for (size_t bucket = (hole + 1) & mask; m_buckets[bucket] != NO_SLOT; bucket = (bucket + 1) & mask) {
+    size_t home = bucketOf(m_slots[m_buckets[bucket]].index);
+    if (((bucket - home) & mask) >= ((bucket - hole) & mask)) {
+      m_buckets[hole] = m_buckets[bucket];
+      m_buckets[bucket] = NO_SLOT;
+      hole = bucket;
+    }
+  }
+}
+
+template<class T> void SwappedVector<T>::resetCache() {
+  // room for the pool, the pinned item and the ghosts, which are kept to half the pool
+  size_t slotCount = m_storage ? m_poolSize + m_poolSize / 2 + 3 : 0;
+  size_t bucketCount = 1;
+  while (bucketCount < slotCount * 2) {
+    bucketCount *= 2;
+  }
+
+  std::vector<Slot>(slotCount).swap(m_slots);
+  m_buckets.assign(slotCount != 0 ? bucketCount : 0, NO_SLOT);
+  for (QueueList& list : m_queues) {
+    list.head = NO_SLOT;
+    list.tail = NO_SLOT;
+    list.count = 0;
+  }
+
+  for (uint32_t slot = 0; slot < slotCount; ++slot) {
+    link(slot, FREE);
   }
 
-  auto itemIter = m_items.insert(std::make_pair(index, ItemEntry()));
-  CacheEntry cacheEntry = { itemIter.first };
-  auto cacheIter = m_cache.insert(m_cache.end(), cacheEntry);
-  itemIter.first->second.cacheIter = cacheIter;
-  return &itemIter.first->second.item;
+  m_cachedBytes = 0;
+  m_recentBytes = 0;
+  m_lastIndex = std::numeric_limits<uint64_t>::max();
 }
@@ -0,0 +1,435 @@
+#include "SwappedVectorStorage.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/filesystem.hpp>
+
+#include "DataBaseBatch.h"
+
+namespace CryptoNote {
+
+namespace {
+
+const uint64_t IMPORT_CHUNK_SIZE = 1000;
+// Every chunk rewrites the offsets table, so the mapped import uses much larger chunks.
+const uint64_t MAPPED_IMPORT_CHUNK_SIZE = 100000;
+const uint64_t MAPPED_SEGMENT_SIZE = static_cast<uint64_t>(256) << 20;
+
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool ISwappedVectorStorage::import(ISwappedVectorStorage& source, const std::function<void(uint64_t, uint64_t)>& progress) {
+  try {
+    const uint64_t total = source.size();
+    while (size() < total) {
+      source.read(size(), [this](const void* data, size_t size) {
+        push_back(std::vector<uint8_t>(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size));
+      });
+
+      if (progress) {
+        progress(size(), total);
+      }
+    }
+  } catch (std::exception&) {
+    return false;
+  }
+
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+SwappedVectorFileStorage::SwappedVectorFileStorage() : m_itemsFileSize(0) {
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool SwappedVectorFileStorage::open(const std::string& itemFileName, const std::string& indexFileName) {
+  m_itemsFile.open(itemFileName, std::ios::in | std::ios::out | std::ios::binary);
+  m_indexesFile.open(indexFileName, std::ios::in | std::ios::out | std::ios::binary);
+  if (m_itemsFile && m_indexesFile) {
+    uint64_t count;
+    m_indexesFile.read(reinterpret_cast<char*>(&count), sizeof count);
+    if (!m_indexesFile) {
+      return false;
+    }
+
+    std::vector<uint64_t> offsets;
+    uint64_t itemsFileSize = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+      uint32_t itemSize;
+      m_indexesFile.read(reinterpret_cast<char*>(&itemSize), sizeof itemSize);
+      if (!m_indexesFile) {
+        return false;
+      }
+
+      offsets.emplace_back(itemsFileSize);
+      itemsFileSize += itemSize;
+    }
+
+    m_offsets.swap(offsets);
+    m_itemsFileSize = itemsFileSize;
+  } else {
+    m_itemsFile.open(itemFileName, std::ios::out | std::ios::binary);
+    m_itemsFile.close();
+    m_itemsFile.open(itemFileName, std::ios::in | std::ios::out | std::ios::binary);
+    m_indexesFile.open(indexFileName, std::ios::out | std::ios::binary);
+    uint64_t count = 0;
+    m_indexesFile.write(reinterpret_cast<char*>(&count), sizeof count);
+    if (!m_indexesFile) {
+      return false;
+    }
+
+    m_indexesFile.close();
+    m_indexesFile.open(indexFileName, std::ios::in | std::ios::out | std::ios::binary);
+    m_offsets.clear();
+    m_itemsFileSize = 0;
+  }
+
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+uint64_t SwappedVectorFileStorage::size() const {
+  return m_offsets.size();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorFileStorage::read(uint64_t index, const std::function<void(const void*, size_t)>& visitor) {
+  if (index >= m_offsets.size() || !m_itemsFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::read");
+  }
+
+  uint64_t end = index + 1 < m_offsets.size() ? m_offsets[index + 1] : m_itemsFileSize;
+  m_readBuffer.resize(static_cast<size_t>(end - m_offsets[index]));
+  m_itemsFile.seekg(m_offsets[index]);
+  m_itemsFile.read(reinterpret_cast<char*>(m_readBuffer.data()), m_readBuffer.size());
+  if (!m_itemsFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::read");
+  }
+
+  visitor(m_readBuffer.data(), m_readBuffer.size());
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorFileStorage::push_back(const std::vector<uint8_t>& blob) {
+  if (!m_itemsFile || !m_indexesFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::push_back");
+  }
+
+  m_itemsFile.seekp(m_itemsFileSize);
+  m_itemsFile.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+  if (!m_itemsFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::push_back");
+  }
+
+  m_indexesFile.seekp(sizeof(uint64_t) + sizeof(uint32_t) * m_offsets.size());
+  uint32_t itemSize = static_cast<uint32_t>(blob.size());
+  m_indexesFile.write(reinterpret_cast<char*>(&itemSize), sizeof itemSize);
+  if (!m_indexesFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::push_back");
+  }
+
+  m_indexesFile.seekp(0);
+  uint64_t count = m_offsets.size() + 1;
+  m_indexesFile.write(reinterpret_cast<char*>(&count), sizeof count);
+  if (!m_indexesFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::push_back");
+  }
+
+  m_offsets.push_back(m_itemsFileSize);
+  m_itemsFileSize += blob.size();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorFileStorage::pop_back() {
+  if (!m_indexesFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::pop_back");
+  }
+
+  m_indexesFile.seekp(0);
+  uint64_t count = m_offsets.size() - 1;
+  m_indexesFile.write(reinterpret_cast<char*>(&count), sizeof count);
+  if (!m_indexesFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::pop_back");
+  }
+
+  m_itemsFileSize = m_offsets.back();
+  m_offsets.pop_back();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorFileStorage::clear() {
+  if (!m_indexesFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::clear");
+  }
+
+  m_indexesFile.seekp(0);
+  uint64_t count = 0;
+  m_indexesFile.write(reinterpret_cast<char*>(&count), sizeof count);
+  if (!m_indexesFile) {
+    throw std::runtime_error("SwappedVectorFileStorage::clear");
+  }
+
+  m_offsets.clear();
+  m_itemsFileSize = 0;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+SwappedVectorLmdbStorage::SwappedVectorLmdbStorage(LmdbDataBase& dataBase, const std::string& keyPrefix) :
+  m_dataBase(dataBase), m_keyPrefix(keyPrefix), m_countKey(keyPrefix + "count"), m_size(0) {
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool SwappedVectorLmdbStorage::open() {
+  bool found;
+  uint64_t count = 0;
+  bool valid = true;
+  std::error_code ec = m_dataBase.read(m_countKey, [&](const void* data, size_t size) {
+    if (size != sizeof(count)) {
+      valid = false;
+      return;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < sizeof(count); ++i) {
+      count = (count << 8) | bytes[i];
+    }
+  }, found);
+
+  if (ec || !valid) {
+    return false;
+  }
+
+  m_size = found ? count : 0;
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool SwappedVectorLmdbStorage::import(ISwappedVectorStorage& source, const std::function<void(uint64_t, uint64_t)>& progress) {
+  const uint64_t total = source.size();
+  while (m_size < total) {
+    DataBaseWriteBatch batch;
+    uint64_t chunkEnd = std::min(total, m_size + IMPORT_CHUNK_SIZE);
+    for (uint64_t i = m_size; i < chunkEnd; ++i) {
+      source.read(i, [&](const void* data, size_t size) {
+        batch.insert(itemKey(i), std::string(static_cast<const char*>(data), size));
+      });
+    }
+
+    batch.insert(m_countKey, countValue(chunkEnd));
+    if (m_dataBase.write(batch)) {
+      return false;
+    }
+
+    m_size = chunkEnd;
+    if (progress) {
+      progress(m_size, total);
+    }
+  }
+
+  return !m_dataBase.sync();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+uint64_t SwappedVectorLmdbStorage::size() const {
+  return m_size;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorLmdbStorage::read(uint64_t index, const std::function<void(const void*, size_t)>& visitor) {
+  if (index >= m_size) {
+    throw std::runtime_error("SwappedVectorLmdbStorage::read");
+  }
+
+  bool found;
+  std::error_code ec = m_dataBase.read(itemKey(index), visitor, found);
+  if (ec || !found) {
+    throw std::runtime_error("SwappedVectorLmdbStorage::read");
+  }
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorLmdbStorage::push_back(const std::vector<uint8_t>& blob) {
+  DataBaseWriteBatch batch;
+  batch.insert(itemKey(m_size), std::string(blob.begin(), blob.end()));
+  batch.insert(m_countKey, countValue(m_size + 1));
+  if (m_dataBase.write(batch)) {
+    throw std::runtime_error("SwappedVectorLmdbStorage::push_back");
+  }
+
+  ++m_size;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorLmdbStorage::pop_back() {
+  if (m_size == 0) {
+    throw std::runtime_error("SwappedVectorLmdbStorage::pop_back");
+  }
+
+  DataBaseWriteBatch batch;
+  batch.remove(itemKey(m_size - 1));
+  batch.insert(m_countKey, countValue(m_size - 1));
+  if (m_dataBase.write(batch)) {
+    throw std::runtime_error("SwappedVectorLmdbStorage::pop_back");
+  }
+
+  --m_size;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorLmdbStorage::clear() {
+  DataBaseWriteBatch batch;
+  for (uint64_t i = 0; i < m_size; ++i) {
+    batch.remove(itemKey(i));
+  }
+
+  batch.insert(m_countKey, countValue(0));
+  if (m_dataBase.write(batch)) {
+    throw std::runtime_error("SwappedVectorLmdbStorage::clear");
+  }
+
+  m_size = 0;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::string SwappedVectorLmdbStorage::itemKey(uint64_t index) const {
+  return makeIndexKey(m_keyPrefix, index);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::string SwappedVectorLmdbStorage::countValue(uint64_t count) const {
+  return makeIndexKey(std::string(), count);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+SwappedVectorMappedStorage::SwappedVectorMappedStorage() : m_writeSegment(0), m_writeOffset(0) {
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool SwappedVectorMappedStorage::open(const std::string& itemFileName, const std::string& offsetsFileName) {
+  try {
+    m_itemFileName = itemFileName;
+    m_segments.clear();
+    for (size_t segment = 0; boost::filesystem::exists(segmentFileName(segment)); ++segment) {
+      std::unique_ptr<System::MemoryMappedFile> file(new System::MemoryMappedFile());
+      file->open(segmentFileName(segment));
+      m_segments.push_back(std::move(file));
+    }
+
+    if (m_offsets.isOpened()) {
+      m_offsets.close();
+    }
+
+    m_offsets.open(offsetsFileName);
+
+    // Items are flushed before their offsets, but segment files may have been removed by hand
+    while (!m_offsets.empty()) {
+      const ItemLocation& location = m_offsets.back();
+      if (location.segment < m_segments.size() && location.offset + location.size <= m_segments[location.segment]->size()) {
+        break;
+      }
+
+      m_offsets.pop_back();
+    }
+  } catch (std::exception&) {
+    return false;
+  }
+
+  updateWritePosition();
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+uint64_t SwappedVectorMappedStorage::size() const {
+  return m_offsets.isOpened() ? m_offsets.size() : 0;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorMappedStorage::read(uint64_t index, const std::function<void(const void*, size_t)>& visitor) {
+  if (index >= size()) {
+    throw std::runtime_error("SwappedVectorMappedStorage::read");
+  }
+
+  const ItemLocation& location = m_offsets[index];
+  visitor(m_segments[location.segment]->data() + location.offset, location.size);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorMappedStorage::push_back(const std::vector<uint8_t>& blob) {
+  if (!m_offsets.isOpened()) {
+    throw std::runtime_error("SwappedVectorMappedStorage::push_back");
+  }
+
+  ItemLocation location = write(blob.data(), blob.size());
+  m_segments[location.segment]->flush(m_segments[location.segment]->data() + location.offset, location.size);
+  m_offsets.push_back(location);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorMappedStorage::pop_back() {
+  if (size() == 0) {
+    throw std::runtime_error("SwappedVectorMappedStorage::pop_back");
+  }
+
+  m_offsets.pop_back();
+  updateWritePosition();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorMappedStorage::clear() {
+  if (!m_offsets.isOpened()) {
+    throw std::runtime_error("SwappedVectorMappedStorage::clear");
+  }
+
+  m_offsets.clear();
+  updateWritePosition();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool SwappedVectorMappedStorage::import(ISwappedVectorStorage& source, const std::function<void(uint64_t, uint64_t)>& progress) {
+  try {
+    const uint64_t total = source.size();
+    if (total > m_offsets.capacity()) {
+      m_offsets.reserve(total);
+    }
+
+    std::vector<ItemLocation> chunk;
+    while (size() < total) {
+      chunk.clear();
+      uint64_t chunkEnd = std::min(total, size() + MAPPED_IMPORT_CHUNK_SIZE);
+      for (uint64_t i = size(); i < chunkEnd; ++i) {
+        source.read(i, [&](const void* data, size_t size) {
+          chunk.push_back(write(data, size));
+        });
+      }
+
+      for (uint32_t segment = chunk.front().segment; segment <= chunk.back().segment; ++segment) {
+        m_segments[segment]->flush(m_segments[segment]->data(), m_segments[segment]->size());
+      }
+
+      m_offsets.insert(m_offsets.cend(), chunk.begin(), chunk.end());
+      if (progress) {
+        progress(size(), total);
+      }
+    }
+  } catch (std::exception&) {
+    updateWritePosition();
+    return false;
+  }
+
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+SwappedVectorMappedStorage::ItemLocation SwappedVectorMappedStorage::write(const void* data, size_t size) {
+  while (m_writeSegment >= m_segments.size() || m_writeOffset + size > m_segments[m_writeSegment]->size()) {
+    if (m_writeSegment < m_segments.size()) {
+      ++m_writeSegment;
+      m_writeOffset = 0;
+      continue;
+    }
+
+    std::unique_ptr<System::MemoryMappedFile> file(new System::MemoryMappedFile());
+    file->create(segmentFileName(m_segments.size()), std::max<uint64_t>(MAPPED_SEGMENT_SIZE, size), true);
+    m_segments.push_back(std::move(file));
+  }
+
+  if (size != 0) {
+    std::memcpy(m_segments[m_writeSegment]->data() + m_writeOffset, data, size);
+  }
+
+  ItemLocation location = { m_writeOffset, m_writeSegment, static_cast<uint32_t>(size) };
+  m_writeOffset += size;
+  return location;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void SwappedVectorMappedStorage::updateWritePosition() {
+  if (size() == 0) {
+    m_writeSegment = 0;
+    m_writeOffset = 0;
+  } else {
+    const ItemLocation& location = m_offsets.back();
+    m_writeSegment = location.segment;
+    m_writeOffset = location.offset + location.size;
+  }
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+std::string SwappedVectorMappedStorage::segmentFileName(size_t segment) const {
+  return m_itemFileName + "." + std::to_string(segment);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+} //namespace CryptoNote
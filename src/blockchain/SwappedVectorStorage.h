@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/FileMappedVector.h"
+#include "System/MemoryMappedFile.h"
+#include "LmdbDataBase.h"
+
+namespace CryptoNote {
+
+// Backend of SwappedVector: an append-only sequence of serialized items.
+class ISwappedVectorStorage {
+
+public:
+
+  virtual ~ISwappedVectorStorage() {
+  }
+
+  virtual uint64_t size() const = 0;
+  virtual void read(uint64_t index, const std::function<void(const void*, size_t)>& visitor) = 0;
+  virtual void push_back(const std::vector<uint8_t>& blob) = 0;
+  virtual void pop_back() = 0;
+  virtual void clear() = 0;
+  // Appends the items of source past size(), so an interrupted import resumes where it stopped.
+  virtual bool import(ISwappedVectorStorage& source, const std::function<void(uint64_t, uint64_t)>& progress);
+};
+
+// Flat items file plus an index file holding item count and item sizes.
+class SwappedVectorFileStorage : public ISwappedVectorStorage {
+
+public:
+
+  SwappedVectorFileStorage();
+
+  bool open(const std::string& itemFileName, const std::string& indexFileName);
+
+  virtual uint64_t size() const override;
+  virtual void read(uint64_t index, const std::function<void(const void*, size_t)>& visitor) override;
+  virtual void push_back(const std::vector<uint8_t>& blob) override;
+  virtual void pop_back() override;
+  virtual void clear() override;
+
+private:
+
+  std::fstream m_itemsFile;
+  std::fstream m_indexesFile;
+  std::vector<uint64_t> m_offsets;
+  uint64_t m_itemsFileSize;
+  std::vector<uint8_t> m_readBuffer;
+};
+
+// Items stored under "<prefix><big-endian index>" and the count under "<prefix>count"; every change is one transaction.
+class SwappedVectorLmdbStorage : public ISwappedVectorStorage {
+
+public:
+
+  SwappedVectorLmdbStorage(LmdbDataBase& dataBase, const std::string& keyPrefix);
+
+  bool open();
+
+  virtual uint64_t size() const override;
+  virtual void read(uint64_t index, const std::function<void(const void*, size_t)>& visitor) override;
+  virtual void push_back(const std::vector<uint8_t>& blob) override;
+  virtual void pop_back() override;
+  virtual void clear() override;
+  virtual bool import(ISwappedVectorStorage& source, const std::function<void(uint64_t, uint64_t)>& progress) override;
+
+private:
+
+  std::string itemKey(uint64_t index) const;
+  std::string countValue(uint64_t count) const;
+
+  LmdbDataBase& m_dataBase;
+  std::string m_keyPrefix;
+  std::string m_countKey;
+  uint64_t m_size;
+};
+
+// Items packed into memory-mapped segment files "<itemFileName>.<n>" and located through a mapped offsets table,
+// so reads hand out pointers into the page cache instead of copying through a stream.
+class SwappedVectorMappedStorage : public ISwappedVectorStorage {
+
+public:
+
+  SwappedVectorMappedStorage();
+
+  bool open(const std::string& itemFileName, const std::string& offsetsFileName);
+
+  virtual uint64_t size() const override;
+  virtual void read(uint64_t index, const std::function<void(const void*, size_t)>& visitor) override;
+  virtual void push_back(const std::vector<uint8_t>& blob) override;
+  virtual void pop_back() override;
+  virtual void clear() override;
+  virtual bool import(ISwappedVectorStorage& source, const std::function<void(uint64_t, uint64_t)>& progress) override;
+
+private:
+
+  struct ItemLocation {
+    uint64_t offset;
+    uint32_t segment;
+    uint32_t size;
+  };
+
+  // Copies an item after the last one without flushing it.
+  ItemLocation write(const void* data, size_t size);
+  void updateWritePosition();
+  std::string segmentFileName(size_t segment) const;
+
+  std::string m_itemFileName;
+  std::vector<std::unique_ptr<System::MemoryMappedFile>> m_segments;
+  Common::FileMappedVector<ItemLocation> m_offsets;
+  uint32_t m_writeSegment;
+  uint64_t m_writeOffset;
+};
+
+} //namespace CryptoNote
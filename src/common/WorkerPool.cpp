@@ -0,0 +1,117 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+namespace Tools {
+
+WorkerPool::WorkerPool(size_t threadCount) : m_job(nullptr), m_count(0), m_next(0), m_busy(0), m_generation(0), m_stopped(false) {
+  for (size_t i = 0; i < threadCount; ++i) {
+    m_threads.emplace_back(&WorkerPool::workerLoop, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+
+  m_workCondition.notify_all();
+  for (std::thread& thread : m_threads) {
+    thread.join();
+  }
+}
+
+size_t WorkerPool::threadCount() const {
+  return m_threads.size();
+}
+
+size_t WorkerPool::defaultThreadCount() {
+  return std::max<size_t>(1, std::thread::hardware_concurrency()) - 1;
+}
+
+void WorkerPool::forEach(size_t count, const std::function<void(size_t)>& job) {
+  if (count == 0) {
+    return;
+  }
+
+  // callers may hold locks the running jobs wait for, so a busy pool is never waited for; this covers a job calling forEach too
+  std::unique_lock<std::mutex> forEachLock(m_forEachMutex, std::try_to_lock);
+  if (!forEachLock.owns_lock()) {
+    for (size_t i = 0; i < count; ++i) {
+      job(i);
+    }
+
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_job = &job;
+    m_count = count;
+    m_next = 0;
+    m_error = nullptr;
+    m_busy = m_threads.size();
+    ++m_generation;
+  }
+
+  m_workCondition.notify_all();
+  runJobs();
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_busy == 0; });
+    m_job = nullptr;
+    error = m_error;
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void WorkerPool::workerLoop() {
+  uint64_t generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_workCondition.wait(lock, [&] { return m_stopped || m_generation != generation; });
+      if (m_stopped) {
+        return;
+      }
+
+      generation = m_generation;
+    }
+
+    runJobs();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (--m_busy == 0) {
+      m_doneCondition.notify_one();
+    }
+  }
+}
+
+void WorkerPool::runJobs() {
+  for (;;) {
+    size_t i = m_next++;
+    if (i >= m_count) {
+      return;
+    }
+
+    try {
+      (*m_job)(i);
+    } catch (...) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (!m_error) {
+        m_error = std::current_exception();
+      }
+
+      // the remaining jobs are skipped
+      m_next = m_count;
+    }
+  }
+}
+
+}
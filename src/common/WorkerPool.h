@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Tools {
+
+// Fixed set of threads for data parallel jobs. forEach() blocks the caller, which works on the job too. One pool is
+// shared by several callers; while it runs the jobs of one of them, the others run theirs on their own thread.
+class WorkerPool {
+public:
+  // threadCount is the number of threads besides the caller, 0 runs every job on the calling thread.
+  explicit WorkerPool(size_t threadCount);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  size_t threadCount() const;
+
+  // Calls job(i) for every i in [0, count). The first exception thrown by a job is rethrown once all threads are idle.
+  void forEach(size_t count, const std::function<void(size_t)>& job);
+
+  static size_t defaultThreadCount();
+
+private:
+  void workerLoop();
+  void runJobs();
+
+  std::vector<std::thread> m_threads;
+  std::mutex m_forEachMutex;
+  std::mutex m_mutex;
+  std::condition_variable m_workCondition;
+  std::condition_variable m_doneCondition;
+  const std::function<void(size_t)>* m_job;
+  size_t m_count;
+  std::atomic<size_t> m_next;
+  size_t m_busy;
+  uint64_t m_generation;
+  std::exception_ptr m_error;
+  bool m_stopped;
+};
+
+}
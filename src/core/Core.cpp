@@ -56,8 +56,9 @@ private:
 core::core(const Currency& currency, i_cryptonote_protocol* pprotocol, Logging::ILogger& logger, bool blockchainIndexesEnabled) :
   m_currency(currency),
   logger(logger, "core"),
+  m_workerPool(Tools::WorkerPool::defaultThreadCount()),
   m_mempool(currency, m_blockchain, m_timeProvider, logger, blockchainIndexesEnabled),
-  m_blockchain(currency, m_mempool, logger, blockchainIndexesEnabled),
+  m_blockchain(currency, m_mempool, m_workerPool, logger, blockchainIndexesEnabled),
   m_miner(new miner(currency, *this, logger)),
   m_starter_message_showed(false) {
 
@@ -91,12 +92,14 @@ bool core::handle_command_line(const boost::program_options::variables_map& vm)
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 uint32_t core::get_current_blockchain_height() {
-  return m_blockchain.getCurrentBlockchainHeight();
+  return m_blockchain.getTip()->height;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 void core::get_blockchain_top(uint32_t& height, Crypto::Hash& top_id) {
-  assert(m_blockchain.getCurrentBlockchainHeight() > 0);
-  top_id = m_blockchain.getTailId(height);
+  std::shared_ptr<const Blockchain::ChainTip> tip = m_blockchain.getTip();
+  assert(tip->height > 0);
+  height = tip->height - 1;
+  top_id = tip->id;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 bool core::get_blocks(uint32_t start_offset, uint32_t count, std::list<Block>& blocks, std::list<Transaction>& txs) {
@@ -125,6 +128,7 @@ std::time_t core::getStartTime() const {
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 bool core::init(const CoreConfig& config, const MinerConfig& minerConfig, bool load_existing) {
   m_config_folder = config.configFolder;
+  m_mempool.setMaxBytes(config.txPoolMaxBytes);
   bool r = m_mempool.init(m_config_folder);
 
   if (!(r)) {
@@ -132,7 +136,7 @@ bool core::init(const CoreConfig& config, const MinerConfig& minerConfig, bool l
     return false;
   }
 
-  r = m_blockchain.init(m_config_folder, load_existing);
+  r = m_blockchain.init(config, load_existing);
   if (!(r)) {
     logger(ERROR, BRIGHT_RED) << "Failed to initialize blockchain storage";
     return false;
@@ -224,19 +228,89 @@ bool core::handle_incoming_tx(const BinaryArray& tx_blob, tx_verification_contex
   }
   //std::cout << "!"<< tx.inputs.size() << std::endl;
 
+  return handle_incoming_tx(tx, tx_hash, tx_blob.size(), tvc, keeped_by_block);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool core::handle_incoming_tx(const Transaction& tx, const Crypto::Hash& txHash, size_t blobSize, tx_verification_context& tvc, bool keeped_by_block) {
+  tvc = boost::value_initialized<tx_verification_context>();
   Crypto::Hash blockId;
   uint32_t blockHeight;
-  bool ok = getBlockContainingTx(tx_hash, blockId, blockHeight);
+  bool ok = getBlockContainingTx(txHash, blockId, blockHeight);
   if (!ok) blockHeight = this->get_current_blockchain_height(); //this assumption fails for withdrawals
-  return handleIncomingTransaction(tx, tx_hash, tx_blob.size(), tvc, keeped_by_block, blockHeight);
+  return handleIncomingTransaction(tx, txHash, blobSize, tvc, keeped_by_block, blockHeight);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void core::handle_incoming_txs(const std::vector<BinaryArray>& tx_blobs, std::vector<tx_verification_context>& tvcs) {
+  struct IncomingTransaction {
+    Transaction tx;
+    Crypto::Hash hash;
+    uint32_t height;
+    bool checked;
+  };
+
+  tvcs.assign(tx_blobs.size(), boost::value_initialized<tx_verification_context>());
+  std::vector<IncomingTransaction> incoming(tx_blobs.size());
+  uint32_t height = get_current_blockchain_height();
+
+  // parsing and the checks which don't depend on the chain, the same transaction relayed again is dropped here
+  m_workerPool.forEach(tx_blobs.size(), [&](size_t i) {
+    IncomingTransaction& transaction = incoming[i];
+    transaction.height = height;
+    transaction.checked = false;
+
+    if (tx_blobs[i].size() > m_currency.maxTxSize()) {
+      logger(INFO) << "WRONG TRANSACTION BLOB, too big size " << tx_blobs[i].size() << ", rejected";
+      tvcs[i].m_verification_failed = true;
+      return;
+    }
+
+    Crypto::Hash prefixHash;
+    if (!parse_tx_from_blob(transaction.tx, transaction.hash, prefixHash, tx_blobs[i])) {
+      logger(INFO) << "WRONG TRANSACTION BLOB, Failed to parse, rejected";
+      tvcs[i].m_verification_failed = true;
+      return;
+    }
+
+    if (m_mempool.have_tx(transaction.hash) || m_blockchain.haveTransaction(transaction.hash)) {
+      logger(TRACE) << "tx " << transaction.hash << " is already known";
+      return;
+    }
+
+    transaction.checked = checkIncomingTransaction(transaction.tx, transaction.hash, tvcs[i], false, transaction.height);
+  });
+
+  std::vector<const Transaction*> checked;
+  std::vector<size_t> positions;
+  for (size_t i = 0; i < incoming.size(); ++i) {
+    if (incoming[i].checked) {
+      checked.push_back(&incoming[i].tx);
+      positions.push_back(i);
+    }
+  }
+
+  // ring signatures are verified here, add_tx() finds them in the cache under the pool lock
+  std::vector<bool> inputsValid;
+  m_blockchain.verifyTransactionsInputs(checked, inputsValid);
+
+  for (size_t k = 0; k < positions.size(); ++k) {
+    size_t i = positions[k];
+    if (!inputsValid[k]) {
+      logger(ERROR) << "Transaction verification failed: " << incoming[i].hash;
+      tvcs[i].m_verification_failed = true;
+      continue;
+    }
+
+    addIncomingTransaction(incoming[i].tx, incoming[i].hash, tx_blobs[i].size(), tvcs[i], false, incoming[i].height);
+  }
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 bool core::get_stat_info(core_stat_info& st_inf) {
   st_inf.mining_speed = m_miner->get_speed();
   st_inf.alternative_blocks = m_blockchain.getAlternativeBlocksCount();
-  st_inf.blockchain_height = m_blockchain.getCurrentBlockchainHeight();
+  std::shared_ptr<const Blockchain::ChainTip> tip = m_blockchain.getTip();
+  st_inf.blockchain_height = tip->height;
   st_inf.tx_pool_size = m_mempool.get_transactions_count();
-  st_inf.top_block_id_str = Common::podToHex(m_blockchain.getTailId());
+  st_inf.top_block_id_str = Common::podToHex(tip->id);
   return true;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
@@ -331,7 +405,7 @@ bool core::check_tx_inputs_keyimages_diff(const Transaction& tx) {
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 size_t core::get_blockchain_total_transactions() {
-  return m_blockchain.getTotalTransactions();
+  return m_blockchain.getTip()->transactionCount;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 bool core::add_new_tx(const Transaction& tx, const Crypto::Hash& tx_hash, size_t blob_size, tx_verification_context& tvc, bool keeped_by_block, uint32_t height) {
@@ -633,6 +707,10 @@ bool core::handle_incoming_block(const Block& b, block_verification_context& bvc
   return true;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void core::precomputeProofOfWork(const std::vector<const Block*>& blocks) {
+  m_blockchain.precomputeProofOfWork(blocks);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 Crypto::Hash core::get_tail_id() {
   return m_blockchain.getTailId();
 }
@@ -641,6 +719,10 @@ size_t core::get_pool_transactions_count() {
   return m_mempool.get_transactions_count();
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+tx_memory_pool::PoolStatistics core::getPoolStatistics() {
+  return m_mempool.getStatistics();
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 bool core::have_block(const Crypto::Hash& id) {
   return m_blockchain.haveBlock(id);
 }
@@ -665,6 +747,15 @@ std::vector<Transaction> core::getPoolTransactions() {
   return result;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+void core::getTransactionsMissingFromPool(const std::vector<Crypto::Hash>& txIds, std::vector<Crypto::Hash>& missedTxIds) {
+  std::lock_guard<decltype(m_mempool)> lk(m_mempool);
+  for (const auto& txId : txIds) {
+    if (!m_mempool.have_tx(txId)) {
+      missedTxIds.push_back(txId);
+    }
+  }
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 std::list<CryptoNote::tx_memory_pool::TransactionDetails> core::getMemoryPool() const {
   //std::list<CryptoNote::tx_memory_pool::TransactionDetails> txs;
   //m_mempool.getMemoryPool(txs);
@@ -678,7 +769,7 @@ std::vector<Crypto::Hash> core::buildSparseChain() {
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 std::vector<Crypto::Hash> core::buildSparseChain(const Crypto::Hash& startBlockId) {
-  LockedBlockchainStorage lbs(m_blockchain);
+  ReadLockedBlockchainStorage lbs(m_blockchain);
   assert(m_blockchain.haveBlock(startBlockId));
   return m_blockchain.buildSparseChain(startBlockId);
 }
@@ -687,8 +778,19 @@ bool core::handle_get_objects(NOTIFY_REQUEST_GET_OBJECTS::request& arg, NOTIFY_R
   return m_blockchain.handleGetObjects(arg, rsp);
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool core::getRawBlock(const Crypto::Hash& blockId, RawBlock& rawBlock) {
+  ReadLockedBlockchainStorage lbs(m_blockchain);
+  uint32_t height;
+  if (!lbs->getBlockHeight(blockId, height)) {
+    return false;
+  }
+
+  rawBlock = lbs->getRawBlock(height);
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 Crypto::Hash core::getBlockIdByHeight(uint32_t height) {
-  LockedBlockchainStorage lbs(m_blockchain);
+  ReadLockedBlockchainStorage lbs(m_blockchain);
   if (height < m_blockchain.getCurrentBlockchainHeight()) {
     return m_blockchain.getBlockIdByHeight(height);
   } else {
@@ -763,7 +865,7 @@ void core::poolUpdated() {
 bool core::queryBlocks(const std::vector<Crypto::Hash>& knownBlockIds, uint64_t timestamp,
   uint32_t& resStartHeight, uint32_t& resCurrentHeight, uint32_t& resFullOffset, std::vector<BlockFullInfo>& entries) {
 
-  LockedBlockchainStorage lbs(m_blockchain);
+  ReadLockedBlockchainStorage lbs(m_blockchain);
 
   uint32_t currentHeight = lbs->getCurrentBlockchainHeight();
   uint32_t startOffset = 0;
@@ -791,25 +893,19 @@ bool core::queryBlocks(const std::vector<Crypto::Hash>& knownBlockIds, uint64_t
     return true;
   }
 
-  std::list<Block> blocks;
-  lbs->getBlocks(startFullOffset, blocksLeft, blocks);
-
-  for (auto& b : blocks) {
+  uint32_t endHeight = std::min(currentHeight, startFullOffset + blocksLeft);
+  for (uint32_t height = startFullOffset; height < endHeight; ++height) {
     BlockFullInfo item;
 
-    item.block_id = get_block_hash(b);
-
-    if (b.timestamp >= timestamp) {
-      // query transactions
-      std::list<Transaction> txs;
-      std::list<Crypto::Hash> missedTxs;
-      lbs->getTransactions(b.transactionHashes, txs, missedTxs);
+    item.block_id = lbs->getBlockIdByHeight(height);
 
-      // fill data
+    if (lbs->getBlockTimestamp(height) >= timestamp) {
+      // stored blobs already hold the block and its transactions as they go over the wire
+      RawBlock rawBlock = lbs->getRawBlock(height);
       block_complete_entry& completeEntry = item;
-      completeEntry.block = asString(toBinaryArray(b));
-      for (auto& tx : txs) {
-        completeEntry.txs.push_back(asString(toBinaryArray(tx)));
+      completeEntry.block = asString(rawBlock.block);
+      for (const auto& tx : rawBlock.transactions) {
+        completeEntry.txs.push_back(asString(tx));
       }
     }
 
@@ -820,7 +916,7 @@ bool core::queryBlocks(const std::vector<Crypto::Hash>& knownBlockIds, uint64_t
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 bool core::findStartAndFullOffsets(const std::vector<Crypto::Hash>& knownBlockIds, uint64_t timestamp, uint32_t& startOffset, uint32_t& startFullOffset) {
-  LockedBlockchainStorage lbs(m_blockchain);
+  ReadLockedBlockchainStorage lbs(m_blockchain);
 
   if (knownBlockIds.empty()) {
     logger(ERROR, BRIGHT_RED) << "knownBlockIds is empty";
@@ -843,7 +939,7 @@ bool core::findStartAndFullOffsets(const std::vector<Crypto::Hash>& knownBlockId
 std::vector<Crypto::Hash> core::findIdsForShortBlocks(uint32_t startOffset, uint32_t startFullOffset) {
   assert(startOffset <= startFullOffset);
 
-  LockedBlockchainStorage lbs(m_blockchain);
+  ReadLockedBlockchainStorage lbs(m_blockchain);
 
   std::vector<Crypto::Hash> result;
   if (startOffset < startFullOffset) {
@@ -855,7 +951,7 @@ std::vector<Crypto::Hash> core::findIdsForShortBlocks(uint32_t startOffset, uint
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 bool core::queryBlocksLite(const std::vector<Crypto::Hash>& knownBlockIds, uint64_t timestamp, uint32_t& resStartHeight,
   uint32_t& resCurrentHeight, uint32_t& resFullOffset, std::vector<BlockShortInfo>& entries) {
-  LockedBlockchainStorage lbs(m_blockchain);
+  ReadLockedBlockchainStorage lbs(m_blockchain);
 
   resCurrentHeight = lbs->getCurrentBlockchainHeight();
   resStartHeight = 0;
@@ -930,15 +1026,16 @@ bool core::scanOutputkeysForIndices(const KeyInput& txInToKey, std::list<std::pa
   struct outputs_visitor
   {
     std::list<std::pair<Crypto::Hash, size_t>>& m_resultsCollector;
-    outputs_visitor(std::list<std::pair<Crypto::Hash, size_t>>& resultsCollector):m_resultsCollector(resultsCollector){}
-    bool handle_output(const Transaction& tx, const TransactionOutput& out, size_t transactionOutputIndex)
+    Blockchain& m_blockchain;
+    outputs_visitor(std::list<std::pair<Crypto::Hash, size_t>>& resultsCollector, Blockchain& blockchain):m_resultsCollector(resultsCollector), m_blockchain(blockchain){}
+    bool handle_output(const Blockchain::KeyOutputEntry& output)
     {
-      m_resultsCollector.push_back(std::make_pair(getObjectHash(tx), transactionOutputIndex));
+      m_resultsCollector.push_back(std::make_pair(m_blockchain.transactionHashByIndex(output.transactionIndex), output.outputIndex));
       return true;
     }
   };
 
-  outputs_visitor vi(outputReferences);
+  outputs_visitor vi(outputReferences, m_blockchain);
 
   return m_blockchain.scanOutputKeysForIndexes(txInToKey, vi);
 }
@@ -1043,15 +1140,15 @@ std::error_code core::executeLocked(const std::function<std::error_code()>& func
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 uint64_t core::getNextBlockDifficulty() {
-  return m_blockchain.getDifficultyForNextBlock();
+  return m_blockchain.getTip()->nextDifficulty;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 uint64_t core::getTotalGeneratedAmount() {
-  return m_blockchain.getCoinsInCirculation();
+  return m_blockchain.getTip()->alreadyGeneratedCoins;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 uint64_t core::fullDepositAmount() const {
-  return m_blockchain.fullDepositAmount();
+  return m_blockchain.getTip()->fullDepositAmount;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 uint64_t core::depositAmountAtHeight(size_t height) const {
@@ -1059,18 +1156,30 @@ uint64_t core::depositAmountAtHeight(size_t height) const {
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 uint64_t core::fullDepositInterest() const {
-  return m_blockchain.fullDepositInterest();
+  return m_blockchain.getTip()->fullDepositInterest;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 uint64_t core::depositInterestAtHeight(size_t height) const {
   return m_blockchain.depositInterestAtHeight(height);
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+Tools::WorkerPool& core::getWorkerPool() {
+  return m_workerPool;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 uint8_t core::getBlockMajorVersionForHeight(uint32_t height) const {
   return m_blockchain.getBlockMajorVersionForHeight(height);
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 bool core::handleIncomingTransaction(const Transaction& tx, const Crypto::Hash& txHash, size_t blobSize, tx_verification_context& tvc, bool keptByBlock, uint32_t height) {
+  if (!checkIncomingTransaction(tx, txHash, tvc, keptByBlock, height)) {
+    return false;
+  }
+
+  return addIncomingTransaction(tx, txHash, blobSize, tvc, keptByBlock, height);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool core::checkIncomingTransaction(const Transaction& tx, const Crypto::Hash& txHash, tx_verification_context& tvc, bool keptByBlock, uint32_t& height) {
   if (!check_tx_syntax(tx)) {
     logger(INFO) << "WRONG TRANSACTION BLOB, Failed to check tx " << txHash << " syntax, rejected";
     tvc.m_verification_failed = true;
@@ -1083,6 +1192,10 @@ bool core::handleIncomingTransaction(const Transaction& tx, const Crypto::Hash&
     return false;
   }
 
+  return true;
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+bool core::addIncomingTransaction(const Transaction& tx, const Crypto::Hash& txHash, size_t blobSize, tx_verification_context& tvc, bool keptByBlock, uint32_t height) {
   bool r = add_new_tx(tx, txHash, blobSize, tvc, keptByBlock, height);
   if (tvc.m_verification_failed) {
     if (!tvc.m_tx_fee_too_small) {
@@ -1104,7 +1217,7 @@ bool core::handleIncomingTransaction(const Transaction& tx, const Crypto::Hash&
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 std::unique_ptr<IBlock> core::getBlock(const Crypto::Hash& blockId) {
   std::lock_guard<decltype(m_mempool)> lk(m_mempool);
-  LockedBlockchainStorage lbs(m_blockchain);
+  ReadLockedBlockchainStorage lbs(m_blockchain);
 
   std::unique_ptr<BlockWithTransactions> blockPtr(new BlockWithTransactions());
   if (!lbs->getBlockByHash(blockId, blockPtr->block)) {
@@ -14,6 +14,7 @@
 #include "ICore.h"
 #include "ICoreObserver.h"
 #include "ObserverManager.h"
+#include "common/WorkerPool.h"
 
 #include "System/Dispatcher.h"
 #include "MessageQueue.h"
@@ -36,7 +37,11 @@ namespace CryptoNote {
 
      bool on_idle() override;
      virtual bool handle_incoming_tx(const BinaryArray& tx_blob, tx_verification_context& tvc, bool keeped_by_block) override; //Deprecated. Should be removed with CryptoNoteProtocolHandler.
+     virtual bool handle_incoming_tx(const Transaction& tx, const Crypto::Hash& txHash, size_t blobSize, tx_verification_context& tvc, bool keeped_by_block) override;
+     virtual void handle_incoming_txs(const std::vector<BinaryArray>& tx_blobs, std::vector<tx_verification_context>& tvcs) override;
      bool handle_incoming_block_blob(const BinaryArray& block_blob, block_verification_context& bvc, bool control_miner, bool relay_block) override;
+     virtual bool handle_incoming_block(const Block& b, block_verification_context& bvc, bool control_miner, bool relay_block) override;
+     virtual void precomputeProofOfWork(const std::vector<const Block*>& blocks) override;
      virtual i_cryptonote_protocol* get_protocol() override {return m_pprotocol;}
      virtual const Currency& currency() const override { return m_currency; }
 
@@ -98,6 +103,7 @@ namespace CryptoNote {
      void getTransactions(const std::vector<Crypto::Hash>& txs_ids, std::list<Transaction>& txs, std::list<Crypto::Hash>& missed_txs, bool checkTxPool = false) override;
      virtual bool getBlockByHash(const Crypto::Hash &h, Block &blk) override;
      virtual bool getBlockHeight(const Crypto::Hash& blockId, uint32_t& blockHeight) override;
+     bool getRawBlock(const Crypto::Hash& blockId, RawBlock& rawBlock);
      //void get_all_known_block_ids(std::list<Crypto::Hash> &main, std::list<Crypto::Hash> &alt, std::list<Crypto::Hash> &invalid);
 
      bool get_alternative_blocks(std::list<Block>& blocks);
@@ -109,7 +115,9 @@ namespace CryptoNote {
      void set_checkpoints(Checkpoints&& chk_pts);
 
      std::vector<Transaction> getPoolTransactions() override;
+     virtual void getTransactionsMissingFromPool(const std::vector<Crypto::Hash>& txIds, std::vector<Crypto::Hash>& missedTxIds) override;
      size_t get_pool_transactions_count();
+     tx_memory_pool::PoolStatistics getPoolStatistics();
      size_t get_blockchain_total_transactions();
      //bool get_outs(uint64_t amount, std::list<Crypto::PublicKey>& pkeys);
      virtual std::vector<Crypto::Hash> findBlockchainSupplement(const std::vector<Crypto::Hash>& remoteBlockIds, size_t maxCount,
@@ -142,17 +150,20 @@ namespace CryptoNote {
      uint64_t fullDepositInterest() const;
      uint64_t depositAmountAtHeight(size_t height) const;
      uint64_t depositInterestAtHeight(size_t height) const;
+     // Threads shared by the core, the blockchain and the protocol handler for data parallel work.
+     Tools::WorkerPool& getWorkerPool();
 
    private:
    
      bool add_new_tx(const Transaction& tx, const Crypto::Hash& tx_hash, size_t blob_size, tx_verification_context& tvc, bool keeped_by_block, uint32_t height);
      bool load_state_data();
      bool parse_tx_from_blob(Transaction& tx, Crypto::Hash& tx_hash, Crypto::Hash& tx_prefix_hash, const BinaryArray& blob);
-     bool handle_incoming_block(const Block& b, block_verification_context& bvc, bool control_miner, bool relay_block);
 
      bool check_tx_syntax(const Transaction& tx);
      //check correct values, amounts and all lightweight checks not related with database
      bool check_tx_semantic(const Transaction& tx, bool keeped_by_block, uint32_t &height);
+     bool checkIncomingTransaction(const Transaction& tx, const Crypto::Hash& txHash, tx_verification_context& tvc, bool keptByBlock, uint32_t& height);
+     bool addIncomingTransaction(const Transaction& tx, const Crypto::Hash& txHash, size_t blobSize, tx_verification_context& tvc, bool keptByBlock, uint32_t height);
      //check if tx already in memory pool or in main blockchain
 
      bool is_key_image_spent(const Crypto::KeyImage& key_im);
@@ -173,6 +184,7 @@ namespace CryptoNote {
      const Currency& m_currency;
      Logging::LoggerRef logger;
      CryptoNote::RealTimeProvider m_timeProvider;
+     Tools::WorkerPool m_workerPool; // must outlive m_blockchain
      tx_memory_pool m_mempool;
      Blockchain m_blockchain;
      i_cryptonote_protocol* m_pprotocol;
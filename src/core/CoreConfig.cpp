@@ -3,10 +3,23 @@
 #include "common/Util.h"
 #include "common/CommandLine.h"
 
+#include <stdexcept>
+
 namespace CryptoNote {
 
+namespace {
+const command_line::arg_descriptor<std::string> arg_db_type = {"db-type", "Specify blockchain storage engine: file, lmdb or mmap (existing blocks.dat is imported on first lmdb or mmap start)", "", true};
+const command_line::arg_descriptor<size_t> arg_block_cache_entries = {"block-cache-entries", "Maximum number of deserialized blocks kept in memory", 1024, true};
+const command_line::arg_descriptor<uint64_t> arg_block_cache_bytes = {"block-cache-bytes", "Maximum serialized size of blocks kept in memory, 0 for no limit", 0, true};
+const command_line::arg_descriptor<uint64_t> arg_txpool_max_bytes = {"txpool-max-bytes", "Maximum size of transactions in the pool, lowest fee rates are evicted beyond it, 0 for no limit", 256 * 1024 * 1024, true};
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 CoreConfig::CoreConfig() {
   configFolder = Tools::getDefaultDataDirectory();
+  dataBaseType = "file";
+  blockCacheEntries = 1024;
+  blockCacheBytes = 0;
+  txPoolMaxBytes = 256 * 1024 * 1024;
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 void CoreConfig::init(const boost::program_options::variables_map& options) {
@@ -14,9 +27,35 @@ void CoreConfig::init(const boost::program_options::variables_map& options) {
     configFolder = command_line::get_arg(options, command_line::arg_data_dir);
     configFolderDefaulted = options[command_line::arg_data_dir.name].defaulted();
   }
+
+  if (command_line::has_arg(options, arg_db_type)) {
+    dataBaseType = command_line::get_arg(options, arg_db_type);
+    if (dataBaseType != "file" && dataBaseType != "lmdb" && dataBaseType != "mmap") {
+      throw std::runtime_error("Unknown db-type: " + dataBaseType + ", expected file, lmdb or mmap");
+    }
+  }
+
+  if (command_line::has_arg(options, arg_block_cache_entries)) {
+    blockCacheEntries = command_line::get_arg(options, arg_block_cache_entries);
+    if (blockCacheEntries == 0) {
+      throw std::runtime_error("block-cache-entries must be positive");
+    }
+  }
+
+  if (command_line::has_arg(options, arg_block_cache_bytes)) {
+    blockCacheBytes = command_line::get_arg(options, arg_block_cache_bytes);
+  }
+
+  if (command_line::has_arg(options, arg_txpool_max_bytes)) {
+    txPoolMaxBytes = command_line::get_arg(options, arg_txpool_max_bytes);
+  }
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 void CoreConfig::initOptions(boost::program_options::options_description& desc) {
+  command_line::add_arg(desc, arg_db_type);
+  command_line::add_arg(desc, arg_block_cache_entries);
+  command_line::add_arg(desc, arg_block_cache_bytes);
+  command_line::add_arg(desc, arg_txpool_max_bytes);
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 } //namespace CryptoNote
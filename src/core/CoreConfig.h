@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <boost/program_options.hpp>
@@ -17,6 +19,10 @@ public:
 
   std::string configFolder;
   bool configFolderDefaulted = true;
+  std::string dataBaseType; // "file", "lmdb" or "mmap"
+  size_t blockCacheEntries;
+  uint64_t blockCacheBytes; // 0 means no byte limit
+  uint64_t txPoolMaxBytes; // 0 means no byte limit
 };
 
 } //namespace CryptoNote
@@ -65,6 +65,9 @@ bool Currency::init() {
     m_blockIndexesFileName = "testnet_" + m_blockIndexesFileName;
     m_txPoolFileName = "testnet_" + m_txPoolFileName;
     m_blockchainIndicesFileName = "testnet_" + m_blockchainIndicesFileName;
+    m_blockchainDataBaseFileName = "testnet_" + m_blockchainDataBaseFileName;
+    m_mappedBlocksFileName = "testnet_" + m_mappedBlocksFileName;
+    m_mappedBlockOffsetsFileName = "testnet_" + m_mappedBlockOffsetsFileName;
   }
 
   return true;
@@ -563,10 +566,8 @@ difficulty_type Currency::nextDifficulty1(std::vector<uint64_t> timestamps,
 difficulty_type Currency::nextDifficulty(std::vector<uint64_t> timestamps,
 	std::vector<difficulty_type> cumulativeDifficulties, uint64_t height) const {
 
-	int64_t T = m_difficultyTarget; // set to 20 temporarily
         int64_t N = m_difficultyWindowv1 - 1; //  N=45, 60, and 90 for T=600, 120, 60.
-        int64_t FTL = m_blockFutureTimeLimit; // < 3xT
-	int64_t L(0), ST, sum_3_ST(0), next_D, prev_D;
+	int64_t L(0), ST, sum_3_ST(0);
 
 	// Hardcode difficulty for 61 blocks after fork height: 
 	//if (height >= parameters::UPGRADE_HEIGHT_V4 && height <= parameters::UPGRADE_HEIGHT_V4 + N) {
@@ -583,48 +584,54 @@ difficulty_type Currency::nextDifficulty(std::vector<uint64_t> timestamps,
 
 	// N is most recently solved block. i must be signed
 	for (int64_t i = 1; i <= N; i++) {
-		// +/- FTL limits are bad timestamp protection.  6xT limits drop in D to reduce oscillations.
-		ST = std::max(-FTL, std::min((int64_t)(timestamps[i]) - (int64_t)(timestamps[i - 1]), 6 * T));
+		ST = lwmaSolveTime(timestamps[i], timestamps[i - 1]);
 		L += ST * i; // Give more weight to most recent blocks.
 					 // Do these inside loop to capture -FTL and +6*T limitations.
 		if (i > N - 3) { sum_3_ST += ST; }
 	}
 
+	return lwmaDifficulty(cumulativeDifficulties[N] - cumulativeDifficulties[0], cumulativeDifficulties[N] - cumulativeDifficulties[N - 1], L, sum_3_ST);
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+int64_t Currency::lwmaSolveTime(uint64_t timestamp, uint64_t previousTimestamp) const {
+	int64_t T = m_difficultyTarget;
+	int64_t FTL = m_blockFutureTimeLimit; // < 3xT
+
+	// +/- FTL limits are bad timestamp protection.  6xT limits drop in D to reduce oscillations.
+	return std::max(-FTL, std::min((int64_t)(timestamp) - (int64_t)(previousTimestamp), 6 * T));
+}
+//------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
+difficulty_type Currency::lwmaDifficulty(difficulty_type windowWork, difficulty_type lastDifficulty, int64_t weightedSolveTime, int64_t lastSolveTimes) const {
+	int64_t T = m_difficultyTarget; // set to 20 temporarily
+	int64_t N = m_difficultyWindowv1 - 1;
+
 	// Calculate next_D = avgD * T / LWMA(STs) using integer math
-	next_D = ((cumulativeDifficulties[N] - cumulativeDifficulties[0])*T*(N + 1) * 99) / (100 * 2 * L);
+	int64_t next_D = (windowWork*T*(N + 1) * 99) / (100 * 2 * weightedSolveTime);
 
 	// Implement LWMA-2 changes from LWMA
-	prev_D = cumulativeDifficulties[N] - cumulativeDifficulties[N - 1];
-	if (sum_3_ST < (8 * T) / 10) { next_D = (prev_D * 110) / 100; }
+	int64_t prev_D = lastDifficulty;
+	if (lastSolveTimes < (8 * T) / 10) { next_D = (prev_D * 110) / 100; }
 
 	return static_cast<uint64_t>(next_D); //turn to anata diff LWMA ~ Yuka
 
 	// next_Target = sumTargets*L*2/0.998/T/(N+1)/N/N; // To show the difference.
 }
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
-bool Currency::checkProofOfWorkV1(Crypto::cn_context& context, const Block& block, difficulty_type currentDiffic,
-		Crypto::Hash& proofOfWork) const {
+bool Currency::checkProofOfWorkV1(const Block& block, difficulty_type currentDiffic,
+		const Crypto::Hash& proofOfWork) const {
 		if (CURRENT_BLOCK_MAJOR != block.majorVersion) {
 			return false;
 		}
 
-		if (!get_block_longhash(context, block, proofOfWork)) {
-			return false;
-		}
-
 		return check_hash(proofOfWork, currentDiffic);
 	}
 
-	bool Currency::checkProofOfWorkV2(Crypto::cn_context& context, const Block& block, difficulty_type currentDiffic,
-		Crypto::Hash& proofOfWork) const {
+	bool Currency::checkProofOfWorkV2(const Block& block, difficulty_type currentDiffic,
+		const Crypto::Hash& proofOfWork) const {
 		if (block.majorVersion < (CURRENT_BLOCK_MAJOR + 1)) {
 			return false;
 		}
 
-		if (!get_block_longhash(context, block, proofOfWork)) {
-			return false;
-		}
-
 		if (!check_hash(proofOfWork, currentDiffic)) {
 			return false;
 		}
@@ -656,21 +663,29 @@ bool Currency::checkProofOfWorkV1(Crypto::cn_context& context, const Block& bloc
 		return true;
 	}
 
-	bool Currency::checkProofOfWork(Crypto::cn_context& context, const Block& block, difficulty_type currentDiffic, Crypto::Hash& proofOfWork) const {
+	bool Currency::checkProofOfWork(const Block& block, difficulty_type currentDiffic, const Crypto::Hash& proofOfWork) const {
 		switch (block.majorVersion) {
 		case CURRENT_BLOCK_MAJOR:
-			return checkProofOfWorkV1(context, block, currentDiffic, proofOfWork);
+			return checkProofOfWorkV1(block, currentDiffic, proofOfWork);
 
 		case CURRENT_BLOCK_MAJOR + 1:
 		case CURRENT_BLOCK_MAJOR + 2:
 		case CURRENT_BLOCK_MAJOR + 3:
                 case NEXT_BLOCK_MAJOR_LIMIT:
-			return checkProofOfWorkV2(context, block, currentDiffic, proofOfWork);
+			return checkProofOfWorkV2(block, currentDiffic, proofOfWork);
 		}
 
 		logger(ERROR, BRIGHT_RED) << "Unknown block major version: " << block.majorVersion << "." << block.minorVersion;
 		return false;
 	}
+
+	bool Currency::checkProofOfWork(Crypto::cn_context& context, const Block& block, difficulty_type currentDiffic, Crypto::Hash& proofOfWork) const {
+		if (!get_block_longhash(context, block, proofOfWork)) {
+			return false;
+		}
+
+		return checkProofOfWork(block, currentDiffic, proofOfWork);
+	}
 //------------------------------------------------------------- Seperator Code -------------------------------------------------------------//
 size_t Currency::getApproximateMaximumInputCount(size_t transactionSize, size_t outputCount, size_t mixinCount) const {
   const size_t KEY_IMAGE_SIZE = sizeof(Crypto::KeyImage);
@@ -767,6 +782,9 @@ CurrencyBuilder::CurrencyBuilder(Logging::ILogger& log) : m_currency(log) {
   blockIndexesFileName(CRYPTONOTE_BLOCKINDEXES_FILENAME);
   txPoolFileName(CRYPTONOTE_POOLDATA_FILENAME);
   blockchainIndicesFileName(CRYPTONOTE_BLOCKCHAIN_INDICES_FILENAME);
+  blockchainDataBaseFileName(CRYPTONOTE_BLOCKCHAIN_DB_FILENAME);
+  mappedBlocksFileName(CRYPTONOTE_MAPPED_BLOCKS_FILENAME);
+  mappedBlockOffsetsFileName(CRYPTONOTE_MAPPED_BLOCK_OFFSETS_FILENAME);
 
   testnet(false);
 }
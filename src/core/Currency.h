@@ -95,6 +95,9 @@ public:
   const std::string& blockIndexesFileName() const { return m_blockIndexesFileName; }
   const std::string& txPoolFileName() const { return m_txPoolFileName; }
   const std::string& blockchainIndicesFileName() const { return m_blockchainIndicesFileName; }
+  const std::string& blockchainDataBaseFileName() const { return m_blockchainDataBaseFileName; }
+  const std::string& mappedBlocksFileName() const { return m_mappedBlocksFileName; }
+  const std::string& mappedBlockOffsetsFileName() const { return m_mappedBlockOffsetsFileName; }
 
   bool isTestnet() const { return m_testnet; }
 
@@ -131,9 +134,14 @@ public:
 
   difficulty_type nextDifficulty(std::vector<uint64_t> timestamps, std::vector<difficulty_type> cumulativeDifficulties, uint64_t height) const;
   difficulty_type nextDifficulty1(std::vector<uint64_t> timestamps, std::vector<difficulty_type> cumulativeDifficulties) const;
+  // Clamped solve time and final step of the LWMA-2 algorithm, shared with the rolling difficulty state of the blockchain.
+  int64_t lwmaSolveTime(uint64_t timestamp, uint64_t previousTimestamp) const;
+  difficulty_type lwmaDifficulty(difficulty_type windowWork, difficulty_type lastDifficulty, int64_t weightedSolveTime, int64_t lastSolveTimes) const;
   
-  bool checkProofOfWorkV1(Crypto::cn_context& context, const Block& block, difficulty_type currentDiffic, Crypto::Hash& proofOfWork) const;
-  bool checkProofOfWorkV2(Crypto::cn_context& context, const Block& block, difficulty_type currentDiffic, Crypto::Hash& proofOfWork) const;
+  bool checkProofOfWorkV1(const Block& block, difficulty_type currentDiffic, const Crypto::Hash& proofOfWork) const;
+  bool checkProofOfWorkV2(const Block& block, difficulty_type currentDiffic, const Crypto::Hash& proofOfWork) const;
+  // Checks a proof of work hash already computed by get_block_longhash().
+  bool checkProofOfWork(const Block& block, difficulty_type currentDiffic, const Crypto::Hash& proofOfWork) const;
   bool checkProofOfWork(Crypto::cn_context& context, const Block& block, difficulty_type currentDiffic, Crypto::Hash& proofOfWork) const;
 
   size_t getApproximateMaximumInputCount(size_t transactionSize, size_t outputCount, size_t mixinCount) const;
@@ -225,6 +233,9 @@ private:
   std::string m_blockIndexesFileName;
   std::string m_txPoolFileName;
   std::string m_blockchainIndicesFileName; 
+  std::string m_blockchainDataBaseFileName;
+  std::string m_mappedBlocksFileName;
+  std::string m_mappedBlockOffsetsFileName;
 
   bool m_testnet;
   std::string m_genesisCoinbaseTxHex;
@@ -327,6 +338,9 @@ public:
   CurrencyBuilder& blockIndexesFileName(const std::string& val) { m_currency.m_blockIndexesFileName = val; return *this; }
   CurrencyBuilder& txPoolFileName(const std::string& val) { m_currency.m_txPoolFileName = val; return *this; }
   CurrencyBuilder& blockchainIndicesFileName(const std::string& val) { m_currency.m_blockchainIndicesFileName = val; return *this; }
+  CurrencyBuilder& blockchainDataBaseFileName(const std::string& val) { m_currency.m_blockchainDataBaseFileName = val; return *this; }
+  CurrencyBuilder& mappedBlocksFileName(const std::string& val) { m_currency.m_mappedBlocksFileName = val; return *this; }
+  CurrencyBuilder& mappedBlockOffsetsFileName(const std::string& val) { m_currency.m_mappedBlockOffsetsFileName = val; return *this; }
 
   CurrencyBuilder& genesisCoinbaseTxHex(const std::string& val) { m_currency.m_genesisCoinbaseTxHex = val; return *this; }
   CurrencyBuilder& testnet(bool val) { m_currency.m_testnet = val; return *this; }
@@ -1,5 +1,6 @@
 #include "Miner.h"
 
+#include <algorithm>
 #include <future>
 #include <numeric>
 #include <sstream>
@@ -29,13 +30,9 @@ namespace CryptoNote
     m_currency(currency),
     logger(log, "miner"),
     m_stop(true),
-    m_template(boost::value_initialized<Block>()),
-    m_template_no(0),
-    m_diffic(0),
     m_handler(handler),
     m_pausers_count(0),
     m_threads_total(0),
-    m_starter_nonce(0),
     m_last_hr_merge_time(0),
     m_hashes(0),
     m_do_print_hashrate(false),
@@ -51,25 +48,22 @@ namespace CryptoNote
   }
   //-----------------------------------------------------------------------------------------------------
   bool miner::set_block_template(const Block& bl, const difficulty_type& di) {
-    std::lock_guard<decltype(m_template_lock)> lk(m_template_lock);
-
-    m_template = bl;
-    if (m_template.majorVersion >= (CURRENT_BLOCK_MAJOR + 1)) {
+    Block block = bl;
+    if (block.majorVersion >= (CURRENT_BLOCK_MAJOR + 1)) {
       CryptoNote::TransactionExtraMergeMiningTag mm_tag;
       mm_tag.depth = 0;
-      if (!CryptoNote::get_aux_block_header_hash(m_template, mm_tag.merkleRoot)) {
+      if (!CryptoNote::get_aux_block_header_hash(block, mm_tag.merkleRoot)) {
         return false;
       }
 
-      m_template.parentBlock.baseTransaction.extra.clear();
-      if (!CryptoNote::appendMergeMiningTagToExtra(m_template.parentBlock.baseTransaction.extra, mm_tag)) {
+      block.parentBlock.baseTransaction.extra.clear();
+      if (!CryptoNote::appendMergeMiningTagToExtra(block.parentBlock.baseTransaction.extra, mm_tag)) {
         return false;
       }
     }
-    m_diffic = di;
-    ++m_template_no;
-    m_starter_nonce = Crypto::rand<uint32_t>();
-    return true;
+
+    // running threads move to the new template before their next hash
+    return m_scheduler.setJob(block, di);
   }
   //-----------------------------------------------------------------------------------------------------
   bool miner::on_block_chain_update() {
@@ -211,9 +205,8 @@ namespace CryptoNote
 
     m_mine_address = adr;
     m_threads_total = static_cast<uint32_t>(threads_count);
-    m_starter_nonce = Crypto::rand<uint32_t>();
 
-    if (!m_template_no) {
+    if (!m_scheduler.hasJob()) {
       request_block_template(); //lets update block template
     }
 
@@ -224,6 +217,7 @@ namespace CryptoNote
     }
 
     logger(INFO) << "Mining has started with " << threads_count << " threads, good luck!";
+    logger(DEBUGGING) << "Proof of work backend: " << Crypto::cn_pow_hash_backend() << ", lanes: " << Crypto::cn_slow_hash_lanes();
     return true;
   }
   
@@ -254,65 +248,59 @@ namespace CryptoNote
 
     m_threads.clear();
     logger(INFO) << "Mining has been stopped, " << m_threads.size() << " finished" ;
+
+    Crypto::cn_scratchpad_stats scratchpads = Crypto::get_scratchpad_stats();
+    logger(DEBUGGING) << "Hash scratchpads allocated: " << scratchpads.huge_pages << " on huge pages, " << scratchpads.transparent_huge_pages <<
+      " on transparent huge pages, " << scratchpads.regular_pages << " on regular pages (fallback), " << scratchpads.idle << " idle";
     return true;
   }
   //-----------------------------------------------------------------------------------------------------
   bool miner::find_nonce_for_given_block(Crypto::cn_context &context, Block& bl, const difficulty_type& diffic) {
+    NonceScheduler scheduler;
+    if (!scheduler.setJob(bl, diffic, bl.nonce)) {
+      return false;
+    }
+
+    std::atomic<uint32_t> foundNonce;
+    std::atomic<bool> found(false);
+    auto search = [&](Crypto::cn_context& searchContext) {
+      NonceWorker work(scheduler, Crypto::cn_slow_hash_lanes());
+      Crypto::Hash hashes[Crypto::SLOW_HASH_MAX_LANES];
+      while (!found && work.next()) {
+        work.hash(searchContext, hashes);
+        for (size_t lane = 0; lane < work.count(); ++lane) {
+          if (check_hash(hashes[lane], diffic)) {
+            foundNonce = work.nonce(lane);
+            found = true;
+            return;
+          }
+        }
+      }
+    };
 
     unsigned nthreads = std::thread::hardware_concurrency();
 
     if (nthreads > 0 && diffic > 5) {
       std::vector<std::future<void>> threads(nthreads);
-      std::atomic<uint32_t> foundNonce;
-      std::atomic<bool> found(false);
-      uint32_t startNonce = Crypto::rand<uint32_t>();
-
       for (unsigned i = 0; i < nthreads; ++i) {
-        threads[i] = std::async(std::launch::async, [&, i]() {
+        threads[i] = std::async(std::launch::async, [&]() {
           Crypto::cn_context localctx;
-          Crypto::Hash h;
-
-          Block lb(bl); // copy to local block
-
-          for (uint32_t nonce = startNonce + i; !found; nonce += nthreads) {
-            lb.nonce = nonce;
-
-            if (!get_block_longhash(localctx, lb, h)) {
-              return;
-            }
-
-            if (check_hash(h, diffic)) {
-              foundNonce = nonce;
-              found = true;
-              return;
-            }
-          }
+          search(localctx);
         });
       }
 
       for (auto& t : threads) {
         t.wait();
       }
-
-      if (found) {
-        bl.nonce = foundNonce.load();
-      }
-
-      return found;
     } else {
-      for (; bl.nonce != std::numeric_limits<uint32_t>::max(); bl.nonce++) {
-        Crypto::Hash h;
-        if (!get_block_longhash(context, bl, h)) {
-          return false;
-        }
+      search(context);
+    }
 
-        if (check_hash(h, diffic)) {
-          return true;
-        }
-      }
+    if (found) {
+      bl.nonce = foundNonce.load();
     }
 
-    return false;
+    return found;
   }
   //-----------------------------------------------------------------------------------------------------
   void miner::on_synchronized()
@@ -346,11 +334,9 @@ namespace CryptoNote
   bool miner::worker_thread(uint32_t th_local_index)
   {
     logger(INFO) << "Miner thread was started ["<< th_local_index << "]";
-    uint32_t nonce = m_starter_nonce + th_local_index;
-    difficulty_type local_diff = 0;
-    uint32_t local_template_ver = 0;
     Crypto::cn_context context;
-    Block b;
+    NonceWorker work(m_scheduler, Crypto::cn_slow_hash_lanes());
+    Crypto::Hash hashes[Crypto::SLOW_HASH_MAX_LANES];
 
     while(!m_stop)
     {
@@ -360,47 +346,38 @@ namespace CryptoNote
         continue;
       }
 
-      if(local_template_ver != m_template_no) {
-        std::unique_lock<std::mutex> lk(m_template_lock);
-        b = m_template;
-        local_diff = m_diffic;
-        lk.unlock();
-
-        local_template_ver = m_template_no;
-        nonce = m_starter_nonce + th_local_index;
-      }
-
-      if(!local_template_ver)//no any set_block_template call
+      if(!work.next())
       {
-        logger(TRACE) << "Block template not set yet";
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        logger(TRACE) << "Block template not set yet or its nonces are exhausted";
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
         continue;
       }
 
-      b.nonce = nonce;
-      Crypto::Hash h;
-      if (!m_stop && !get_block_longhash(context, b, h)) {
-        logger(ERROR) << "Failed to get block long hash";
-        m_stop = true;
-      }
+      work.hash(context, hashes);
+
+      for (size_t i = 0; i < work.count() && !m_stop; ++i) {
+        if (!check_hash(hashes[i], work.job().difficulty())) {
+          continue;
+        }
 
-      if (!m_stop && check_hash(h, local_diff))
-      {
         //we lucky!
         ++m_config.current_extra_message_index;
 
-        logger(INFO, GREEN) << "Found block for difficulty: " << local_diff;
+        logger(INFO, GREEN) << "Found block for difficulty: " << work.job().difficulty();
 
-        if(!m_handler.handle_block_found(b)) {
+        Block block = work.job().makeBlock(work.nonce(i));
+        if(!m_handler.handle_block_found(block)) {
           --m_config.current_extra_message_index;
         } else {
           //success update, lets update config
           Common::saveStringToFile(m_config_folder_path + "/" + MINER_CONFIG_FILE_NAME, storeToJson(m_config));
         }
+
+        // the other lanes mined the same template
+        break;
       }
 
-      nonce += m_threads_total;
-      ++m_hashes;
+      m_hashes += work.count();
     }
     logger(INFO) << "Miner thread stopped ["<< th_local_index << "]";
     return true;
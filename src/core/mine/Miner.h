@@ -6,6 +6,7 @@
 #include <thread>
 
 #include "base/CryptoNoteBasic.h"
+#include "base/NonceScheduler.h"
 #include "core/Currency.h"
 #include "core/Difficulty.h"
 #include "IMinerHandler.h"
@@ -55,11 +56,7 @@ namespace CryptoNote {
     Logging::LoggerRef logger;
 
     std::atomic<bool> m_stop;
-    std::mutex m_template_lock;
-    Block m_template;
-    std::atomic<uint32_t> m_template_no;
-    std::atomic<uint32_t> m_starter_nonce;
-    difficulty_type m_diffic;
+    NonceScheduler m_scheduler;
 
     std::atomic<uint32_t> m_threads_total;
     std::atomic<int32_t> m_pausers_count;
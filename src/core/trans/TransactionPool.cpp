@@ -1,7 +1,9 @@
 #include "TransactionPool.h"
 
 #include <algorithm>
+#include <cmath>
 #include <ctime>
+#include <limits>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
@@ -85,6 +87,14 @@ namespace CryptoNote {
 
   using CryptoNote::BlockInfo;
 
+  namespace {
+    // atomic units per kilobyte
+    uint64_t feeRate(uint64_t fee, size_t blobSize) {
+      uint64_t hi, lo = mul128(fee, 1000, &hi);
+      return hi != 0 ? std::numeric_limits<uint64_t>::max() : lo / std::max<size_t>(blobSize, 1);
+    }
+  }
+
   //---------------------------------------------------------------------------------
   tx_memory_pool::tx_memory_pool(
     const CryptoNote::Currency& currency,
@@ -97,6 +107,12 @@ namespace CryptoNote {
     m_timeProvider(timeProvider),
     m_txCheckInterval(60, timeProvider),
     m_fee_index(boost::get<1>(m_transactions)),
+    m_bytes(0),
+    m_maxBytes(0),
+    m_minimumFeeRate(0),
+    m_minimumFeeRateTime(0),
+    m_evictedTransactions(0),
+    m_evictedBytes(0),
     logger(log, "txpool"),
     m_paymentIdIndex(blockchainIndexesEnabled),
     m_timestampIndex(blockchainIndexesEnabled) {
@@ -135,6 +151,19 @@ namespace CryptoNote {
       return false;
     }
 
+    // fusion transactions pay no fee by design, the floor would shut them out entirely
+    if (!keptByBlock && !isFusionTransaction) {
+      std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
+      uint64_t minimumRate = minimumFeeRate();
+      if (feeRate(fee, blobSize) < minimumRate) {
+        logger(INFO) << "transaction fee rate is not enough for the full pool: " << feeRate(fee, blobSize) <<
+          " per kB, minimum: " << minimumRate << " per kB";
+        tvc.m_verification_failed = true;
+        tvc.m_tx_fee_too_small = true;
+        return false;
+      }
+    }
+
     if (ttl.ttl != 0 && !keptByBlock) {
       uint64_t now = static_cast<uint64_t>(time(nullptr));
       if (ttl.ttl <= now) {
@@ -166,8 +195,9 @@ namespace CryptoNote {
 
     BlockInfo maxUsedBlock;
 
-    // check inputs
-    bool inputsValid = m_validator.checkTransactionInputs(tx, maxUsedBlock);
+    // check inputs; a block's transactions are checked together by pushBlock() and leave the pool with the block,
+    // so they are only checked here when they have to become ready for a block template
+    bool inputsValid = !keptByBlock && m_validator.checkTransactionInputs(tx, maxUsedBlock);
 
     if (!inputsValid) {
       if (!keptByBlock) {
@@ -177,7 +207,6 @@ namespace CryptoNote {
       }
 
       maxUsedBlock.clear();
-      tvc.m_verification_impossible = true;
     }
 
     if (!keptByBlock) {
@@ -220,6 +249,8 @@ namespace CryptoNote {
       }
       m_paymentIdIndex.add(txd.tx);
       m_timestampIndex.add(txd.receiveTime, txd.id);
+      m_uncheckedTransactions.insert(id);
+      m_bytes += blobSize;
 
       if (ttl.ttl != 0) {
         m_ttlIndex.emplace(std::make_pair(id, ttl.ttl));
@@ -234,6 +265,19 @@ namespace CryptoNote {
       return false;
 
     tvc.m_verification_failed = false;
+
+    if (m_maxBytes != 0 && m_bytes > m_maxBytes) {
+      evictTransactions();
+      if (m_transactions.count(id) == 0) {
+        logger(INFO) << "transaction fee rate is the lowest in the full pool: " << id;
+        tvc.m_added_to_pool = false;
+        tvc.m_should_be_relayed = false;
+        tvc.m_verification_failed = true;
+        tvc.m_tx_fee_too_small = true;
+        return false;
+      }
+    }
+
     //succeed
     return true;
   }
@@ -263,6 +307,23 @@ namespace CryptoNote {
     return true;
   }
   //---------------------------------------------------------------------------------
+  void tx_memory_pool::setMaxBytes(uint64_t maxBytes) {
+    std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
+    m_maxBytes = maxBytes;
+  }
+  //---------------------------------------------------------------------------------
+  tx_memory_pool::PoolStatistics tx_memory_pool::getStatistics() {
+    std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
+    PoolStatistics statistics;
+    statistics.transactionCount = m_transactions.size();
+    statistics.bytes = m_bytes;
+    statistics.maxBytes = m_maxBytes;
+    statistics.minimumFeeRate = minimumFeeRate();
+    statistics.evictedTransactions = m_evictedTransactions;
+    statistics.evictedBytes = m_evictedBytes;
+    return statistics;
+  }
+  //---------------------------------------------------------------------------------
   size_t tx_memory_pool::get_transactions_count() const {
     std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
     return m_transactions.size();
@@ -318,11 +379,67 @@ namespace CryptoNote {
     deleted_tx_ids.assign(known_set.begin(), known_set.end());
   }
   //---------------------------------------------------------------------------------
-  bool tx_memory_pool::on_blockchain_inc(uint64_t new_block_height, const Crypto::Hash& top_block_id) {
+  bool tx_memory_pool::on_blockchain_inc(uint64_t new_block_height, const Crypto::Hash& top_block_id, const std::vector<Transaction>& blockTransactions) {
+    std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
+
+    // outputs used by ready transactions stay in the chain, only inputs spent by the new block can fail them
+    GlobalOutputsContainer spentOutputs;
+    for (const auto& tx : blockTransactions) {
+      for (const auto& in : tx.inputs) {
+        if (in.type() == typeid(KeyInput)) {
+          auto it = m_spent_key_images.find(boost::get<KeyInput>(in).keyImage);
+          if (it != m_spent_key_images.end()) {
+            for (const auto& id : it->second) {
+              m_readyTransactions.erase(id);
+            }
+          }
+        } else if (in.type() == typeid(MultisignatureInput)) {
+          const auto& msig = boost::get<MultisignatureInput>(in);
+          spentOutputs.insert(GlobalOutput(msig.amount, msig.outputIndex));
+        }
+      }
+    }
+
+    for (auto it = m_readyTransactions.begin(); !spentOutputs.empty() && it != m_readyTransactions.end();) {
+      auto txIt = m_transactions.find(*it);
+      bool conflicts = txIt != m_transactions.end() && std::any_of(txIt->tx.inputs.begin(), txIt->tx.inputs.end(), [&spentOutputs](const TransactionInput& in) {
+        if (in.type() != typeid(MultisignatureInput)) {
+          return false;
+        }
+
+        const auto& msig = boost::get<MultisignatureInput>(in);
+        return spentOutputs.count(GlobalOutput(msig.amount, msig.outputIndex)) != 0;
+      });
+
+      if (conflicts) {
+        it = m_readyTransactions.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    // failed transactions may be waiting for an unlock time or an output the new block brings, they are checked
+    // again with the next template; lastFailedBlock only spares repeated checks at one tail
+    for (const auto& txd : m_transactions) {
+      if (m_readyTransactions.count(txd.id) == 0) {
+        m_uncheckedTransactions.insert(txd.id);
+      }
+    }
+
     return true;
   }
   //---------------------------------------------------------------------------------
   bool tx_memory_pool::on_blockchain_dec(uint64_t new_block_height, const Crypto::Hash& top_block_id) {
+    std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
+
+    // popped blocks take the outputs above the new top with them and may unspend what failed transactions use
+    for (const auto& txd : m_transactions) {
+      if (m_readyTransactions.count(txd.id) == 0 || txd.maxUsedBlock.height >= new_block_height) {
+        m_readyTransactions.erase(txd.id);
+        m_uncheckedTransactions.insert(txd.id);
+      }
+    }
+
     return true;
   }
   //---------------------------------------------------------------------------------
@@ -363,6 +480,27 @@ namespace CryptoNote {
     return true;
   }
   //---------------------------------------------------------------------------------
+  void tx_memory_pool::updateTransactionsReadiness() {
+    for (const auto& id : m_uncheckedTransactions) {
+      auto it = m_transactions.find(id);
+      if (it == m_transactions.end()) {
+        continue;
+      }
+
+      TransactionCheckInfo checkInfo(*it);
+      if (is_transaction_ready_to_go(it->tx, checkInfo)) {
+        m_readyTransactions.insert(id);
+      }
+
+      // update item state
+      m_transactions.modify(it, [&checkInfo](TransactionCheckInfo& item) {
+        item = checkInfo;
+      });
+    }
+
+    m_uncheckedTransactions.clear();
+  }
+  //---------------------------------------------------------------------------------
   std::string tx_memory_pool::print_pool(bool short_format) const {
     std::stringstream ss;
     std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
@@ -408,6 +546,8 @@ namespace CryptoNote {
     size_t max_total_size = (125 * median_size) / 100;
     max_total_size = std::min(max_total_size, maxCumulativeSize) - m_currency.minerTxBlobReservedSize();
 
+    updateTransactionsReadiness();
+
     BlockTemplate blockTemplate;
 
     for (auto it = m_fee_index.rbegin(); it != m_fee_index.rend() && it->fee == 0; ++it) {
@@ -421,8 +561,7 @@ namespace CryptoNote {
         continue;
       }
 
-      TransactionCheckInfo checkInfo(txd);
-      if (is_transaction_ready_to_go(txd.tx, checkInfo) && blockTemplate.addTransaction(txd.id, txd.tx)) {
+      if (m_readyTransactions.count(txd.id) != 0 && blockTemplate.addTransaction(txd.id, txd.tx)) {
         total_size += txd.blobSize;
         logger(DEBUGGING) << "Fusion transaction " << txd.id << " included to block template";
       }
@@ -440,14 +579,7 @@ namespace CryptoNote {
         continue;
       }
 
-      TransactionCheckInfo checkInfo(txd);
-      bool ready = is_transaction_ready_to_go(txd.tx, checkInfo);
-
-      // update item state
-      m_fee_index.modify(i, [&checkInfo](TransactionCheckInfo& item) {
-        item = checkInfo;
-      });
-
+      bool ready = m_readyTransactions.count(txd.id) != 0;
       if (ready && blockTemplate.addTransaction(txd.id, txd.tx)) {
         total_size += txd.blobSize;
         fee += txd.fee;
@@ -477,6 +609,9 @@ namespace CryptoNote {
       m_transactions.clear();
       m_spent_key_images.clear();
       m_spentOutputs.clear();
+      m_readyTransactions.clear();
+      m_uncheckedTransactions.clear();
+      m_bytes = 0;
 
       m_paymentIdIndex.clear();
       m_timestampIndex.clear();
@@ -487,6 +622,10 @@ namespace CryptoNote {
 
     removeExpiredTransactions();
 
+    if (m_maxBytes != 0 && m_bytes > m_maxBytes) {
+      evictTransactions();
+    }
+
     // Ignore deserialization error
     return true;
   }
@@ -606,9 +745,67 @@ namespace CryptoNote {
     m_paymentIdIndex.remove(i->tx);
     m_timestampIndex.remove(i->receiveTime, i->id);
     m_ttlIndex.erase(i->id);
+    m_readyTransactions.erase(i->id);
+    m_uncheckedTransactions.erase(i->id);
+    m_bytes -= i->blobSize;
     return m_transactions.erase(i);
   }
 
+  void tx_memory_pool::evictTransactions() {
+    // observers aren't notified, the pool update is reported for the transaction that filled the pool
+    while (m_bytes > m_maxBytes) {
+      // fusion transactions go only once nothing else is left, they keep the pool bounded but don't set the floor
+      auto isFusion = [this](const TransactionDetails& txd) { return txd.fee == 0 && m_currency.isFusionTransaction(txd.tx, txd.blobSize); };
+      auto it = std::find_if(m_fee_index.rbegin(), m_fee_index.rend(), [&](const TransactionDetails& txd) { return !txd.keptByBlock && !isFusion(txd); });
+      bool fusion = false;
+      if (it == m_fee_index.rend()) {
+        it = std::find_if(m_fee_index.rbegin(), m_fee_index.rend(), [](const TransactionDetails& txd) { return !txd.keptByBlock; });
+        if (it == m_fee_index.rend()) {
+          break;
+        }
+
+        fusion = true;
+      }
+
+      // transactions paying no more than the evicted one would only replace each other, the step grows with the rate
+      uint64_t rate = feeRate(it->fee, it->blobSize);
+      if (!fusion) {
+        uint64_t raisedRate = rate < std::numeric_limits<uint64_t>::max() - rate / 8 ? rate + rate / 8 : std::numeric_limits<uint64_t>::max();
+        m_minimumFeeRate = std::max(minimumFeeRate(), raisedRate);
+        m_minimumFeeRateTime = m_timeProvider.now();
+      }
+
+      logger(DEBUGGING) << "Tx " << it->id << " evicted from full tx pool, fee rate: " << rate << " per kB";
+      ++m_evictedTransactions;
+      m_evictedBytes += it->blobSize;
+      removeTransaction(m_transactions.project<0>(std::prev(it.base())));
+    }
+  }
+
+  uint64_t tx_memory_pool::minimumFeeRate() {
+    time_t now = m_timeProvider.now();
+    if (m_minimumFeeRate == 0 || now <= m_minimumFeeRateTime) {
+      return m_minimumFeeRate;
+    }
+
+    // decays faster once the pool has room again
+    double halfLife = CRYPTONOTE_MEMPOOL_FEE_RATE_HALF_LIFE;
+    if (m_bytes < m_maxBytes / 4) {
+      halfLife /= 4;
+    } else if (m_bytes < m_maxBytes / 2) {
+      halfLife /= 2;
+    }
+
+    m_minimumFeeRate = static_cast<uint64_t>(m_minimumFeeRate / std::pow(2.0, (now - m_minimumFeeRateTime) / halfLife));
+    m_minimumFeeRateTime = now;
+    // below the rate of a minimum fee transaction of the largest size the floor rejects nothing
+    if (m_minimumFeeRate < feeRate(m_currency.minimumFee(), m_currency.maxTxSize())) {
+      m_minimumFeeRate = 0;
+    }
+
+    return m_minimumFeeRate;
+  }
+
   bool tx_memory_pool::removeTransactionInputs(const Crypto::Hash& tx_id, const Transaction& tx, bool keptByBlock) {
     for (const auto& in : tx.inputs) {
       if (in.type() == typeid(KeyInput)) {
@@ -704,6 +901,8 @@ namespace CryptoNote {
     for (auto it = m_transactions.begin(); it != m_transactions.end(); it++) {
       m_paymentIdIndex.add(it->tx);
       m_timestampIndex.add(it->receiveTime, it->id);
+      m_uncheckedTransactions.insert(it->id);
+      m_bytes += it->blobSize;
 
       std::vector<TransactionExtraField> txExtraFields;
       parseTransactionExtra(it->tx.extra, txExtraFields);
@@ -3,6 +3,7 @@
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <boost/utility.hpp>
 
@@ -76,6 +77,10 @@ namespace CryptoNote {
     bool addObserver(ITxPoolObserver* observer);
     bool removeObserver(ITxPoolObserver* observer);
 
+    // Caps the summed blob size of pool transactions, 0 for no limit. Transactions with the lowest fee rate are evicted
+    // once the cap is exceeded, transactions added by blocks are kept.
+    void setMaxBytes(uint64_t maxBytes);
+
     // load/store operations
     bool init(const std::string& config_folder);
     bool deinit();
@@ -86,7 +91,7 @@ namespace CryptoNote {
     //gets tx and remove it from pool
     bool take_tx(const Crypto::Hash &id, Transaction &tx, size_t& blobSize, uint64_t& fee);
 
-    bool on_blockchain_inc(uint64_t new_block_height, const Crypto::Hash& top_block_id);
+    bool on_blockchain_inc(uint64_t new_block_height, const Crypto::Hash& top_block_id, const std::vector<Transaction>& blockTransactions);
     bool on_blockchain_dec(uint64_t new_block_height, const Crypto::Hash& top_block_id);
 
     void lock() const;
@@ -134,6 +139,17 @@ namespace CryptoNote {
       time_t receiveTime;
     };
 
+    struct PoolStatistics {
+      size_t transactionCount;
+      uint64_t bytes;
+      uint64_t maxBytes;
+      uint64_t minimumFeeRate; // per kilobyte, 0 unless the pool was full recently
+      uint64_t evictedTransactions;
+      uint64_t evictedBytes;
+    };
+
+    PoolStatistics getStatistics();
+
     void getMemoryPool(std::list<CryptoNote::tx_memory_pool::TransactionDetails> txs) const;
     std::list<CryptoNote::tx_memory_pool::TransactionDetails> getMemoryPool() const;
 
@@ -180,6 +196,9 @@ namespace CryptoNote {
     tx_container_t::iterator removeTransaction(tx_container_t::iterator i);
     bool removeExpiredTransactions();
     bool is_transaction_ready_to_go(const Transaction& tx, TransactionCheckInfo& txd) const;
+    uint64_t minimumFeeRate();
+    void evictTransactions();
+    void updateTransactionsReadiness();
 
     void buildIndices();
 
@@ -198,6 +217,18 @@ namespace CryptoNote {
     tx_container_t::nth_index<1>::type& m_fee_index;
     std::unordered_map<Crypto::Hash, uint64_t> m_recentlyDeletedTransactions;
 
+    // Block template candidates. A transaction is ready, unchecked or, in neither set, failed at the current chain.
+    // Chain changes move only the transactions they affect, so templates check new and affected transactions only.
+    std::unordered_set<Crypto::Hash> m_readyTransactions;
+    std::unordered_set<Crypto::Hash> m_uncheckedTransactions;
+
+    uint64_t m_bytes;
+    uint64_t m_maxBytes;
+    uint64_t m_minimumFeeRate; // raised above the rate of evicted transactions, decays from m_minimumFeeRateTime on
+    time_t m_minimumFeeRateTime;
+    uint64_t m_evictedTransactions;
+    uint64_t m_evictedBytes;
+
     Logging::LoggerRef logger;
 
     PaymentIdIndex m_paymentIdIndex;
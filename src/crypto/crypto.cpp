@@ -464,4 +464,47 @@ namespace Crypto {
     sc_sub(reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&sum));
     return sc_isnonzero(reinterpret_cast<unsigned char*>(&h)) == 0;
   }
+
+  static_assert(sizeof(RingMemberTables::key) == sizeof(ge_dsmp) && sizeof(RingMemberTables::keyHash) == sizeof(ge_dsmp), "RingMemberTables layout");
+
+  bool crypto_ops::precompute_ring_member(const PublicKey &pub, RingMemberTables &tables) {
+    ge_p3 point;
+    if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char*>(&pub)) != 0) {
+      return false;
+    }
+    ge_dsm_precomp(reinterpret_cast<ge_cached*>(tables.key), &point);
+    hash_to_ec(pub, point);
+    ge_dsm_precomp(reinterpret_cast<ge_cached*>(tables.keyHash), &point);
+    return true;
+  }
+
+  bool crypto_ops::check_ring_signature(const Hash &prefix_hash, const KeyImage &image,
+    const RingMemberTables *const *members, size_t members_count,
+    const Signature *sig) {
+    size_t i;
+    ge_p3 image_unp;
+    ge_dsmp image_pre;
+    EllipticCurveScalar sum, h;
+    rs_comm *const buf = reinterpret_cast<rs_comm *>(alloca(rs_comm_size(members_count)));
+    if (ge_frombytes_vartime(&image_unp, reinterpret_cast<const unsigned char*>(&image)) != 0) {
+      return false;
+    }
+    ge_dsm_precomp(image_pre, &image_unp);
+    sc_0(reinterpret_cast<unsigned char*>(&sum));
+    buf->h = prefix_hash;
+    for (i = 0; i < members_count; i++) {
+      ge_p2 tmp2;
+      if (sc_check(reinterpret_cast<const unsigned char*>(&sig[i])) != 0 || sc_check(reinterpret_cast<const unsigned char*>(&sig[i]) + 32) != 0) {
+        return false;
+      }
+      ge_double_scalarmult_base_precomp_vartime(&tmp2, reinterpret_cast<const unsigned char*>(&sig[i]), reinterpret_cast<const ge_cached*>(members[i]->key), reinterpret_cast<const unsigned char*>(&sig[i]) + 32);
+      ge_tobytes(reinterpret_cast<unsigned char*>(&buf->ab[i].a), &tmp2);
+      ge_double_scalarmult_precomp_vartime2(&tmp2, reinterpret_cast<const unsigned char*>(&sig[i]) + 32, reinterpret_cast<const ge_cached*>(members[i]->keyHash), reinterpret_cast<const unsigned char*>(&sig[i]), image_pre);
+      ge_tobytes(reinterpret_cast<unsigned char*>(&buf->ab[i].b), &tmp2);
+      sc_add(reinterpret_cast<unsigned char*>(&sum), reinterpret_cast<unsigned char*>(&sum), reinterpret_cast<const unsigned char*>(&sig[i]));
+    }
+    hash_to_scalar(buf, rs_comm_size(members_count), h);
+    sc_sub(reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&sum));
+    return sc_isnonzero(reinterpret_cast<unsigned char*>(&h)) == 0;
+  }
 }
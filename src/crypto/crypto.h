@@ -27,6 +27,12 @@ struct EllipticCurveScalar {
   uint8_t data[32];
 };
 
+/* Decompressed form of a ring member key, see precompute_ring_member(). */
+struct RingMemberTables {
+  int32_t key[8 * 4 * 10];     // ge_dsmp of the key
+  int32_t keyHash[8 * 4 * 10]; // ge_dsmp of hash_to_ec(key)
+};
+
   class crypto_ops {
     crypto_ops();
     crypto_ops(const crypto_ops &);
@@ -81,6 +87,12 @@ struct EllipticCurveScalar {
       const PublicKey *const *, size_t, const Signature *);
     friend bool check_ring_signature(const Hash &, const KeyImage &,
       const PublicKey *const *, size_t, const Signature *);
+    static bool precompute_ring_member(const PublicKey &, RingMemberTables &);
+    friend bool precompute_ring_member(const PublicKey &, RingMemberTables &);
+    static bool check_ring_signature(const Hash &, const KeyImage &,
+      const RingMemberTables *const *, size_t, const Signature *);
+    friend bool check_ring_signature(const Hash &, const KeyImage &,
+      const RingMemberTables *const *, size_t, const Signature *);
   };
 
   /* Generate a value filled with random bytes.
@@ -236,6 +248,19 @@ struct EllipticCurveScalar {
     return crypto_ops::check_ring_signature(prefix_hash, image, pubs, pubs_count, sig);
   }
 
+  /* Ring signature checks spend most of their time decompressing the ring members. A key that is used in many rings
+   * can be decompressed once with precompute_ring_member() and then checked with the tables overload below, which
+   * gives the same result as check_ring_signature() on the keys. Returns false if the key is not a valid point.
+   */
+  inline bool precompute_ring_member(const PublicKey &pub, RingMemberTables &tables) {
+    return crypto_ops::precompute_ring_member(pub, tables);
+  }
+  inline bool check_ring_signature(const Hash &prefix_hash, const KeyImage &image,
+    const RingMemberTables *const *members, size_t members_count,
+    const Signature *sig) {
+    return crypto_ops::check_ring_signature(prefix_hash, image, members, members_count, sig);
+  }
+
   /* Variants with vector<const PublicKey *> parameters.
    */
   inline void generate_ring_signature(const Hash &prefix_hash, const KeyImage &image,
@@ -25,6 +25,24 @@ namespace Crypto {
     return h;
   }
 
+  // Scratchpad allocations since startup, by the kind of pages backing them.
+  struct cn_scratchpad_stats {
+    size_t huge_pages;             // MAP_HUGETLB, one TLB entry per scratchpad
+    size_t transparent_huge_pages; // 2MB aligned and madvised, the kernel may still back them with regular pages
+    size_t regular_pages;          // fallback
+    size_t idle;                   // pooled scratchpads not owned by a context right now
+  };
+
+  cn_scratchpad_stats get_scratchpad_stats();
+
+  // CryptoNight through the pow_hash/ engine, variant 0 is the original algorithm and anything above it variant 1.
+  // The backend is picked on first use: hardware AES when the CPU has it, else the software engine, each only if it
+  // reproduces known hashes, else the reference code in slow-hash.c.
+  void cn_pow_hash(void *scratchpad, const void *data, size_t length, Hash &hash, int variant);
+  // Up to SLOW_HASH_MAX_LANES inputs, interleaved by the engine when the backend has a multi-lane path.
+  void cn_pow_hash_multi(void *const *scratchpads, const void *const *data, const size_t *length, const int *variants, size_t count, Hash *hashes);
+  const char *cn_pow_hash_backend();
+
   class cn_context {
   public:
 
@@ -37,12 +55,31 @@ namespace Crypto {
 
   private:
 
-    void *data;
+    // Scratchpads come from a process wide pool on first use and go back to it with the context.
+    void *scratchpad(size_t lane);
+
+    void *data[SLOW_HASH_MAX_LANES];
     friend inline void cn_slow_hash(cn_context &, const void *, size_t, Hash &, int);
+    friend inline void cn_slow_hash_multi(cn_context &, const void *const *, const size_t *, const int *, size_t, Hash *);
   };
 
   inline void cn_slow_hash(cn_context &context, const void *data, size_t length, Hash &hash, int variant = 0) {
-	cn_slow_hash(data, length, reinterpret_cast<char *>(&hash), variant);
+    cn_pow_hash(context.scratchpad(0), data, length, hash, variant);
+  }
+
+  // Hashes up to SLOW_HASH_MAX_LANES inputs in one interleaved pass, cn_slow_hash_lanes() is the count worth batching on this CPU.
+  inline void cn_slow_hash_multi(cn_context &context, const void *const *data, const size_t *length, const int *variants, size_t count, Hash *hashes) {
+    if (count == 1) {
+      cn_pow_hash(context.scratchpad(0), data[0], length[0], hashes[0], variants[0]);
+      return;
+    }
+
+    void *scratchpads[SLOW_HASH_MAX_LANES];
+    for (size_t i = 0; i < count; ++i) {
+      scratchpads[i] = context.scratchpad(i);
+    }
+
+    cn_pow_hash_multi(scratchpads, data, length, variants, count, hashes);
   }
 
   inline void tree_hash(const Hash *hashes, size_t count, Hash &root_hash) {
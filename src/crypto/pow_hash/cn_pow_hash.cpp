@@ -0,0 +1,204 @@
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include "../hash.h"
+#include "cn_slow_hash.hpp"
+
+namespace Crypto {
+
+  namespace {
+
+  typedef void (*pow_hash_fn)(void *scratchpad, const void *data, size_t length, char *hash);
+  typedef void (*pow_hash_lanes_fn)(void *const *scratchpads, const void *const *data, const size_t *length, size_t count, char (*hash)[HASH_SIZE]);
+
+  struct PowBackend {
+    const char *name;
+    bool hardware;
+    pow_hash_fn variants[2]; // original CryptoNight, variant 1
+    pow_hash_lanes_fn lanes[2]; // interleaved hashing of several inputs, nullptr hashes them one by one
+  };
+
+  template<class Engine>
+  void hardware_pow_hash(void *scratchpad, const void *data, size_t length, char *hash) {
+    Engine(scratchpad).hardware_hash(data, length, hash);
+  }
+
+  template<class Engine>
+  void software_pow_hash(void *scratchpad, const void *data, size_t length, char *hash) {
+    Engine(scratchpad).software_hash(data, length, hash);
+  }
+
+#ifdef HAS_INTEL_HW
+  template<class Engine>
+  void hardware_pow_hash_lanes(void *const *scratchpads, const void *const *data, const size_t *length, size_t count, char (*hash)[HASH_SIZE]) {
+    // the engines only borrow the scratchpads, there is nothing to destroy
+    typename std::aligned_storage<sizeof(Engine), alignof(Engine)>::type storage[SLOW_HASH_MAX_LANES];
+    Engine *lanes[SLOW_HASH_MAX_LANES];
+    for (size_t i = 0; i < count; ++i) {
+      lanes[i] = new (&storage[i]) Engine(scratchpads[i]);
+    }
+
+    Engine::hardware_hash_lanes(lanes, count, data, length, hash);
+  }
+#endif
+
+  template<int VARIANT>
+  void reference_pow_hash(void *scratchpad, const void *data, size_t length, char *hash) {
+    cn_slow_hash_scratchpad(scratchpad, data, length, hash, VARIANT);
+  }
+
+  // In order of preference, the reference implementation in slow-hash.c is always usable.
+  const PowBackend BACKENDS[] = {
+#if defined(HAS_INTEL_HW)
+    { "hardware AES", true, { hardware_pow_hash<cn_pow_hash_v0>, hardware_pow_hash<cn_pow_hash_v1> },
+      { hardware_pow_hash_lanes<cn_pow_hash_v0>, hardware_pow_hash_lanes<cn_pow_hash_v1> } },
+#elif defined(HAS_ARM_HW)
+    { "hardware AES", true, { hardware_pow_hash<cn_pow_hash_v0>, hardware_pow_hash<cn_pow_hash_v1> }, { nullptr, nullptr } },
+#endif
+    { "software AES", false, { software_pow_hash<cn_pow_hash_v0>, software_pow_hash<cn_pow_hash_v1> }, { nullptr, nullptr } },
+    { "reference", false, { reference_pow_hash<0>, reference_pow_hash<1> }, { nullptr, nullptr } }
+  };
+
+  const size_t BACKEND_COUNT = sizeof(BACKENDS) / sizeof(BACKENDS[0]);
+
+  // Known answers: the empty input for the original algorithm, 43 zero bytes for variant 1
+  const uint8_t KNOWN_HASH_V0[HASH_SIZE] = {
+    0xeb, 0x14, 0xe8, 0xa8, 0x33, 0xfa, 0xc6, 0xfe, 0x9a, 0x43, 0xb5, 0x7b, 0x33, 0x67, 0x89, 0xc4,
+    0x6f, 0xfe, 0x93, 0xf2, 0x86, 0x84, 0x52, 0x24, 0x07, 0x20, 0x60, 0x7b, 0x14, 0x38, 0x7e, 0x11
+  };
+
+  const uint8_t KNOWN_HASH_V1[HASH_SIZE] = {
+    0xb5, 0xa7, 0xf6, 0x3a, 0xbb, 0x94, 0xd0, 0x7d, 0x1a, 0x64, 0x45, 0xc3, 0x6c, 0x07, 0xc7, 0xe8,
+    0x32, 0x7f, 0xe6, 0x1b, 0x16, 0x47, 0xe3, 0x91, 0xb4, 0xc7, 0xed, 0xae, 0x5d, 0xe5, 0x7a, 0x3d
+  };
+
+  bool force_software_aes() {
+    // same switch as slow-hash.c
+    const char *env = getenv("MONERO_USE_SOFTWARE_AES");
+    return env != nullptr && strcmp(env, "0") != 0 && strcmp(env, "no") != 0;
+  }
+
+  // scratchpad holds SLOW_HASH_MAX_LANES scratchpads, the multi-lane path is checked with all of them
+  bool passes_known_answers(const PowBackend &backend, void *scratchpad) {
+    const uint8_t input[43] = {};
+    const uint8_t *known[2] = { KNOWN_HASH_V0, KNOWN_HASH_V1 };
+    const size_t length[2] = { 0, sizeof(input) };
+    char hash[SLOW_HASH_MAX_LANES][HASH_SIZE];
+    for (size_t variant = 0; variant < 2; ++variant) {
+      backend.variants[variant](scratchpad, input, length[variant], hash[0]);
+      if (memcmp(hash[0], known[variant], HASH_SIZE) != 0) {
+        return false;
+      }
+
+      if (backend.lanes[variant] == nullptr) {
+        continue;
+      }
+
+      void *scratchpads[SLOW_HASH_MAX_LANES];
+      const void *data[SLOW_HASH_MAX_LANES];
+      size_t lengths[SLOW_HASH_MAX_LANES];
+      for (size_t i = 0; i < SLOW_HASH_MAX_LANES; ++i) {
+        scratchpads[i] = static_cast<uint8_t *>(scratchpad) + i * SLOW_HASH_SCRATCHPAD_SIZE;
+        data[i] = input;
+        lengths[i] = length[variant];
+      }
+
+      backend.lanes[variant](scratchpads, data, lengths, SLOW_HASH_MAX_LANES, hash);
+      for (size_t i = 0; i < SLOW_HASH_MAX_LANES; ++i) {
+        if (memcmp(hash[i], known[variant], HASH_SIZE) != 0) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  const PowBackend &select_backend() {
+    void *scratchpad = nullptr;
+    size_t i = 0;
+    for (; i + 1 < BACKEND_COUNT; ++i) {
+      if (BACKENDS[i].hardware && (force_software_aes() || !hw_check_aes())) {
+        continue;
+      }
+
+      if (scratchpad == nullptr) {
+        scratchpad = malloc(SLOW_HASH_SCRATCHPAD_SIZE * SLOW_HASH_MAX_LANES);
+        if (scratchpad == nullptr) {
+          i = BACKEND_COUNT - 1;
+          break;
+        }
+      }
+
+      if (passes_known_answers(BACKENDS[i], scratchpad)) {
+        break;
+      }
+    }
+
+    free(scratchpad);
+    return BACKENDS[i];
+  }
+
+  const PowBackend &backend() {
+    static const PowBackend &selected = select_backend();
+    return selected;
+  }
+
+  }
+
+  void cn_pow_hash(void *scratchpad, const void *data, size_t length, Hash &hash, int variant) {
+    if (variant > 0 && length < 43) {
+      // the reference reports the misuse
+      cn_slow_hash_scratchpad(scratchpad, data, length, reinterpret_cast<char *>(&hash), variant);
+      return;
+    }
+
+    backend().variants[variant > 0 ? 1 : 0](scratchpad, data, length, reinterpret_cast<char *>(&hash));
+  }
+
+  void cn_pow_hash_multi(void *const *scratchpads, const void *const *data, const size_t *length, const int *variants, size_t count, Hash *hashes) {
+    // lanes are interleaved only with lanes of the same variant, a batch across an upgrade is split in two
+    for (size_t variant = 0; variant < 2; ++variant) {
+      void *laneScratchpads[SLOW_HASH_MAX_LANES];
+      const void *laneData[SLOW_HASH_MAX_LANES];
+      size_t laneLength[SLOW_HASH_MAX_LANES];
+      size_t laneIndex[SLOW_HASH_MAX_LANES];
+      size_t laneCount = 0;
+      for (size_t i = 0; i < count; ++i) {
+        if ((variants[i] > 0 ? 1u : 0u) != variant) {
+          continue;
+        }
+
+        if (variant > 0 && length[i] < 43) {
+          cn_pow_hash(scratchpads[i], data[i], length[i], hashes[i], variants[i]);
+          continue;
+        }
+
+        laneScratchpads[laneCount] = scratchpads[i];
+        laneData[laneCount] = data[i];
+        laneLength[laneCount] = length[i];
+        laneIndex[laneCount] = i;
+        ++laneCount;
+      }
+
+      if (laneCount > 1 && backend().lanes[variant] != nullptr) {
+        char laneHashes[SLOW_HASH_MAX_LANES][HASH_SIZE];
+        backend().lanes[variant](laneScratchpads, laneData, laneLength, laneCount, laneHashes);
+        for (size_t k = 0; k < laneCount; ++k) {
+          memcpy(&hashes[laneIndex[k]], laneHashes[k], HASH_SIZE);
+        }
+      } else {
+        for (size_t k = 0; k < laneCount; ++k) {
+          backend().variants[variant](laneScratchpads[k], laneData[k], laneLength[k], reinterpret_cast<char *>(&hashes[laneIndex[k]]));
+        }
+      }
+    }
+  }
+
+  const char *cn_pow_hash_backend() {
+    return backend().name;
+  }
+
+}
@@ -135,125 +135,63 @@ private:
 	void* base_ptr;
 };
 
-template<size_t MEMORY, size_t ITER, size_t VERSION> class cn_slow_hash;
-using cn_pow_hash_v1 = cn_slow_hash<2*1024*1024, 0x80000, 0>;
-using cn_pow_hash_v2 = cn_slow_hash<4*1024*1024, 0x40000, 1>;
+// Variant 1 (block major version 1 and later) tweaks byte 11 of the block written by the AES step
+inline void variant1_1(cn_sptr p)
+{
+	const uint8_t tmp = p.as_byte(11);
+	static const uint32_t table = 0x75310;
+	const uint8_t index = (((tmp >> 3) & 6) | (tmp & 1)) << 1;
+	p.as_byte(11) = tmp ^ ((table >> index) & 0x30);
+}
+
+// VARIANT 0 is the original CryptoNight, VARIANT 1 adds the tweaks keyed by the nonce (monero v7)
+template<size_t MEMORY, size_t ITER, size_t VARIANT> class cn_slow_hash;
+using cn_pow_hash_v0 = cn_slow_hash<2*1024*1024, 0x80000, 0>;
+using cn_pow_hash_v1 = cn_slow_hash<2*1024*1024, 0x80000, 1>;
 
-template<size_t MEMORY, size_t ITER, size_t VERSION>
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
 class cn_slow_hash
 {
 public:
-	cn_slow_hash() : borrowed_pad(false)
-	{
-#if !defined(HAS_WIN_INTRIN_API)
-		lpad.set(aligned_alloc(4096, MEMORY));
-		spad.set(aligned_alloc(4096, 4096));
-#else
-		lpad.set(_aligned_malloc(MEMORY, 4096));
-		spad.set(_aligned_malloc(4096, 4096));
-#endif
-	}
-
-	cn_slow_hash (cn_slow_hash&& other) noexcept : lpad(other.lpad.as_byte()), spad(other.spad.as_byte()), borrowed_pad(other.borrowed_pad)
+	// The scratchpad is borrowed, MEMORY bytes aligned to 16, usually a pooled one of a Crypto::cn_context
+	explicit cn_slow_hash(void* scratchpad)
 	{
-		other.lpad.set(nullptr);
-		other.spad.set(nullptr);
+		lpad.set(scratchpad);
+		spad.set(state);
 	}
 
-	// Factory function enabling to temporaliy turn v2 object into v1
-	// It is caller's responsibility to ensure that v2 object is not hashing at the same time!!
-	static cn_pow_hash_v1 make_borrowed(cn_pow_hash_v2& t)
-	{
-		return cn_pow_hash_v1(t.lpad.as_void(), t.spad.as_void());
-	}
-
-	cn_slow_hash& operator= (cn_slow_hash&& other) noexcept
-    {
-		if(this == &other)
-			return *this;
-
-		free_mem();
-		lpad.set(other.lpad.as_void());
-		spad.set(other.spad.as_void());
-		borrowed_pad = other.borrowed_pad;
-		return *this;
-	}
-
-	// Copying is going to be really inefficient
 	cn_slow_hash(const cn_slow_hash& other) = delete;
 	cn_slow_hash& operator= (const cn_slow_hash& other) = delete;
 
-	~cn_slow_hash()
-	{
-		free_mem();
-	}
-
-	void hash(const void* in, size_t len, void* out)
-	{
-		if(hw_check_aes() && !check_override())
-			hardware_hash(in, len, out);
-		else
-			software_hash(in, len, out);
-	}
-
+	// Variants above 0 read the nonce, len must be at least 43 for them
 	void software_hash(const void* in, size_t len, void* out);
-	
+
 #if !defined(HAS_INTEL_HW) && !defined(HAS_ARM_HW)
 	inline void hardware_hash(const void* in, size_t len, void* out) { assert(false); }
 #else
 	void hardware_hash(const void* in, size_t len, void* out);
 #endif
 
+#ifdef HAS_INTEL_HW
+	// Hashes count inputs side by side, one engine per input. The lanes' main loops are independent, so the CPU
+	// overlaps their scratchpad reads. count is at most Crypto::SLOW_HASH_MAX_LANES
+	static void hardware_hash_lanes(cn_slow_hash* const* lanes, size_t count, const void* const* in, const size_t* len, char (*out)[32]);
+#endif
+
 private:
 	static constexpr size_t MASK = ((MEMORY-1) >> 4) << 4;
-	friend cn_pow_hash_v1;
-	friend cn_pow_hash_v2;
-
-	// Constructor enabling v1 hash to borrow v2's buffer
-	cn_slow_hash(void* lptr, void* sptr)
-	{
-		lpad.set(lptr);
-		spad.set(sptr);
-		borrowed_pad = true;
-	}
 
-	inline bool check_override()
-	{
-		const char *env = getenv("SUMO_USE_SOFTWARE_AES");
-		if (!env) {
-			return false;
-		}
-		else if (!strcmp(env, "0") || !strcmp(env, "no")) {
-			return false;
-		}
-		else {
-			return true;
-		}
-	}
+	inline cn_sptr scratchpad_ptr(uint32_t idx) { return lpad.as_byte() + (idx & MASK); }
 
-	inline void free_mem()
+	inline uint64_t variant1_init(const void* in, size_t len)
 	{
-		if(!borrowed_pad)
-		{
-#if !defined(HAS_WIN_INTRIN_API)
-			if(lpad.as_void() != nullptr)
-				free(lpad.as_void());
-			if(lpad.as_void() != nullptr)
-				free(spad.as_void());
-#else
-			if(lpad.as_void() != nullptr)
-				_aligned_free(lpad.as_void());
-			if(lpad.as_void() != nullptr)
-				_aligned_free(spad.as_void());
-#endif
-		}
-
-		lpad.set(nullptr);
-		spad.set(nullptr);
+		assert(VARIANT == 0 || len >= 43);
+		uint64_t nonce = 0;
+		if(VARIANT > 0)
+			memcpy(&nonce, reinterpret_cast<const uint8_t*>(in) + 35, sizeof(nonce));
+		return VARIANT > 0 ? spad.as_uqword(24) ^ nonce : 0;
 	}
 
-	inline cn_sptr scratchpad_ptr(uint32_t idx) { return lpad.as_byte() + (idx & MASK); }
-
 #if !defined(HAS_INTEL_HW) && !defined(HAS_ARM_HW)
 	inline void explode_scratchpad_hard() { assert(false); }
 	inline void implode_scratchpad_hard() { assert(false); }
@@ -267,8 +205,8 @@ private:
 
 	cn_sptr lpad;
 	cn_sptr spad;
-	bool borrowed_pad;
+	alignas(16) uint64_t state[25];
 };
 
 extern template class cn_slow_hash<2*1024*1024, 0x80000, 0>;
-extern template class cn_slow_hash<4*1024*1024, 0x40000, 1>;
+extern template class cn_slow_hash<2*1024*1024, 0x80000, 1>;
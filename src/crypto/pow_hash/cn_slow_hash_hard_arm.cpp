@@ -30,7 +30,11 @@
 // Parts of this file are originally copyright (c) 2012-2013, The Cryptonote developers
 
 #include "cn_slow_hash.hpp"
-#include "../crypto/keccak.h"
+#include "../hash.h"
+
+extern "C" {
+#include "../keccak.h"
+}
 
 #ifdef HAS_ARM_HW
 
@@ -139,19 +143,6 @@ inline void aes_round10(uint8x16_t& x, const uint8x16_t& k0, const uint8x16_t& k
 	x = veorq_u8(x, k9);
 }
 
-inline void xor_shift(uint8x16_t& x0, uint8x16_t& x1, uint8x16_t& x2, uint8x16_t& x3, uint8x16_t& x4, uint8x16_t& x5, uint8x16_t& x6, uint8x16_t& x7)
-{
-	uint8x16_t tmp0 = x0;
-	x0 ^= x1;
-	x1 ^= x2;
-	x2 ^= x3;
-	x3 ^= x4;
-	x4 ^= x5;
-	x5 ^= x6;
-	x6 ^= x7;
-	x7 ^= tmp0;
-}
-
 inline void mem_load(cn_sptr& lpad, size_t i,uint8x16_t& x0, uint8x16_t& x1, uint8x16_t& x2, uint8x16_t& x3, uint8x16_t& x4, uint8x16_t& x5, uint8x16_t& x6, uint8x16_t& x7)
 {
 	x0 ^= vld1q_u8(lpad.as_byte() + i);
@@ -164,8 +155,8 @@ inline void mem_load(cn_sptr& lpad, size_t i,uint8x16_t& x0, uint8x16_t& x1, uin
 	x7 ^= vld1q_u8(lpad.as_byte() + i + 112);
 }
 
-template<size_t MEMORY, size_t ITER, size_t VERSION>
-void cn_slow_hash<MEMORY,ITER,VERSION>::implode_scratchpad_hard()
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::implode_scratchpad_hard()
 {
 	uint8x16_t x0, x1, x2, x3, x4, x5, x6, x7;
 	uint8x16_t k0, k1, k2, k3, k4, k5, k6, k7, k8, k9;
@@ -193,39 +184,6 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::implode_scratchpad_hard()
 		aes_round10(x5, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
 		aes_round10(x6, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
 		aes_round10(x7, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-
-		if(VERSION > 0)
-			xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
-	}
-
-	for (size_t i = 0; VERSION > 0 && i < MEMORY; i += 128)
-	{
-		mem_load(lpad, i, x0, x1, x2, x3, x4, x5, x6, x7);
-
-		aes_round10(x0, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x1, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x2, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x3, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x4, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x5, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x6, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x7, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-
-		xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
-	}
-
-	for (size_t i = 0; VERSION > 0 && i < 16; i++)
-	{
-		aes_round10(x0, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x1, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x2, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x3, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x4, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x5, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x6, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x7, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-
-		xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
 	}
 
 	vst1q_u8(spad.as_byte() + 64, x0);
@@ -238,8 +196,8 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::implode_scratchpad_hard()
 	vst1q_u8(spad.as_byte() + 176, x7);
 }
 
-template<size_t MEMORY, size_t ITER, size_t VERSION>
-void cn_slow_hash<MEMORY,ITER,VERSION>::explode_scratchpad_hard()
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::explode_scratchpad_hard()
 {
 	uint8x16_t x0, x1, x2, x3, x4, x5, x6, x7;
 	uint8x16_t k0, k1, k2, k3, k4, k5, k6, k7, k8, k9;
@@ -255,20 +213,6 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::explode_scratchpad_hard()
 	x6 = vld1q_u8(spad.as_byte() + 160);
 	x7 = vld1q_u8(spad.as_byte() + 176);
 
-	for (size_t i = 0; VERSION > 0 && i < 16; i++)
-	{
-		aes_round10(x0, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x1, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x2, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x3, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x4, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x5, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x6, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-		aes_round10(x7, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
-
-		xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
-	}
-
 	for(size_t i = 0; i < MEMORY; i += 128)
 	{
 		aes_round10(x0, k0, k1, k2, k3, k4, k5, k6, k7, k8, k9);
@@ -298,20 +242,16 @@ inline uint64_t _umul128(uint64_t a, uint64_t b, uint64_t* hi)
 	return (uint64_t)r;
 }
 
-extern "C" void blake256_hash(uint8_t*, const uint8_t*, uint64_t);
-extern "C" void groestl(const unsigned char*, unsigned long long, unsigned char*);
-extern "C" size_t jh_hash(int, const unsigned char*, unsigned long long, unsigned char*);
-extern "C" size_t skein_hash(int, const unsigned char*, size_t, unsigned char*);
-
 inline uint8x16_t _mm_set_epi64x(const uint64_t a, const uint64_t b)
 {
     return vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(b), vcreate_u64(a)));
 }
 
-template<size_t MEMORY, size_t ITER, size_t VERSION>
-void cn_slow_hash<MEMORY,ITER,VERSION>::hardware_hash(const void* in, size_t len, void* out)
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::hardware_hash(const void* in, size_t len, void* out)
 {
 	keccak((const uint8_t *)in, len, spad.as_byte(), 200);
+	const uint64_t tweak1_2 = variant1_init(in, len);
 
 	explode_scratchpad_hard();
 	
@@ -333,6 +273,8 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::hardware_hash(const void* in, size_t len
 		cx = vaesmcq_u8(vaeseq_u8(cx, zero)) ^ _mm_set_epi64x(ah0, al0);
 
 		vst1q_u8(scratchpad_ptr(idx0).as_byte(), bx0 ^ cx);
+		if(VARIANT > 0)
+			variant1_1(scratchpad_ptr(idx0));
 
 		idx0 = vgetq_lane_u64(vreinterpretq_u64_u8(cx), 0);
 		bx0 = cx;
@@ -346,43 +288,25 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::hardware_hash(const void* in, size_t len
 		al0 += hi;
 		ah0 += lo;
 		scratchpad_ptr(idx0).as_uqword(0) = al0;
-		scratchpad_ptr(idx0).as_uqword(1) = ah0;
+		scratchpad_ptr(idx0).as_uqword(1) = ah0 ^ tweak1_2;
 		ah0 ^= ch;
 		al0 ^= cl;
 		idx0 = al0;
-		
-		if(VERSION > 0)
-		{
-			int64_t n  = scratchpad_ptr(idx0).as_qword(0);
-			int32_t d  = scratchpad_ptr(idx0).as_dword(2);
-			int64_t q = n / (d | 5);
-			scratchpad_ptr(idx0).as_qword(0) = n ^ q;
-			idx0 = d ^ q;
-		}
 	}
 
 	implode_scratchpad_hard();
 
 	keccakf(spad.as_uqword(), 24);
 
-	switch(spad.as_byte(0) & 3)
+	static void (*const extra_hashes[4])(const void *, size_t, char *) =
 	{
-	case 0:
-		blake256_hash((uint8_t*)out, spad.as_byte(), 200);
-		break;
-	case 1:
-		groestl(spad.as_byte(), 200 * 8, (uint8_t*)out);
-		break;
-	case 2:
-		jh_hash(32 * 8, spad.as_byte(), 8 * 200, (uint8_t*)out);
-		break;
-	case 3:
-		skein_hash(8 * 32, spad.as_byte(), 8 * 200, (uint8_t*)out);
-		break;
-	}
+		Crypto::hash_extra_blake, Crypto::hash_extra_groestl, Crypto::hash_extra_jh, Crypto::hash_extra_skein
+	};
+
+	extra_hashes[spad.as_byte(0) & 3](spad.as_void(), 200, reinterpret_cast<char*>(out));
 }
 
 template class cn_slow_hash<2*1024*1024, 0x80000, 0>;
-template class cn_slow_hash<4*1024*1024, 0x40000, 1>;
+template class cn_slow_hash<2*1024*1024, 0x80000, 1>;
 
 #endif
@@ -30,7 +30,11 @@
 // Parts of this file are originally copyright (c) 2012-2013, The Cryptonote developers
 
 #include "cn_slow_hash.hpp"
-#include "../crypto/keccak.h"
+#include "../hash.h"
+
+extern "C" {
+#include "../keccak.h"
+}
 
 #ifdef HAS_INTEL_HW
 
@@ -103,21 +107,8 @@ inline void aes_round8(const __m128i& key, __m128i& x0, __m128i& x1, __m128i& x2
 	x7 = _mm_aesenc_si128(x7, key);
 }
 
-inline void xor_shift(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3, __m128i& x4, __m128i& x5, __m128i& x6, __m128i& x7)
-{
-    __m128i tmp0 = x0;
-    x0 = _mm_xor_si128(x0, x1);
-    x1 = _mm_xor_si128(x1, x2);
-    x2 = _mm_xor_si128(x2, x3);
-    x3 = _mm_xor_si128(x3, x4);
-    x4 = _mm_xor_si128(x4, x5);
-    x5 = _mm_xor_si128(x5, x6);
-    x6 = _mm_xor_si128(x6, x7);
-    x7 = _mm_xor_si128(x7, tmp0);
-}
-
-template<size_t MEMORY, size_t ITER, size_t VERSION>
-void cn_slow_hash<MEMORY,ITER,VERSION>::implode_scratchpad_hard()
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::implode_scratchpad_hard()
 {
 	__m128i x0, x1, x2, x3, x4, x5, x6, x7;
 	__m128i k0, k1, k2, k3, k4, k5, k6, k7, k8, k9;
@@ -154,50 +145,6 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::implode_scratchpad_hard()
 		aes_round8(k7, x0, x1, x2, x3, x4, x5, x6, x7);
 		aes_round8(k8, x0, x1, x2, x3, x4, x5, x6, x7);
 		aes_round8(k9, x0, x1, x2, x3, x4, x5, x6, x7);
-
-		if(VERSION > 0)
-			xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
-	}
-
-	for (size_t i = 0; VERSION > 0 && i < MEMORY / sizeof(__m128i); i +=8)
-	{
-		x0 = _mm_xor_si128(_mm_load_si128(lpad.as_xmm() + i + 0), x0);
-		x1 = _mm_xor_si128(_mm_load_si128(lpad.as_xmm() + i + 1), x1);
-		x2 = _mm_xor_si128(_mm_load_si128(lpad.as_xmm() + i + 2), x2);
-		x3 = _mm_xor_si128(_mm_load_si128(lpad.as_xmm() + i + 3), x3);
-		x4 = _mm_xor_si128(_mm_load_si128(lpad.as_xmm() + i + 4), x4);
-		x5 = _mm_xor_si128(_mm_load_si128(lpad.as_xmm() + i + 5), x5);
-		x6 = _mm_xor_si128(_mm_load_si128(lpad.as_xmm() + i + 6), x6);
-		x7 = _mm_xor_si128(_mm_load_si128(lpad.as_xmm() + i + 7), x7);
-
-		aes_round8(k0, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k1, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k2, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k3, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k4, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k5, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k6, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k7, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k8, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k9, x0, x1, x2, x3, x4, x5, x6, x7);
-
-		xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
-	}
-
-	for (size_t i = 0; VERSION > 0 && i < 16; i++)
-	{
-		aes_round8(k0, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k1, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k2, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k3, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k4, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k5, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k6, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k7, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k8, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k9, x0, x1, x2, x3, x4, x5, x6, x7);
-
-		xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
 	}
 
 	_mm_store_si128(spad.as_xmm() + 4, x0);
@@ -210,8 +157,8 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::implode_scratchpad_hard()
 	_mm_store_si128(spad.as_xmm() + 11, x7);
 }
 
-template<size_t MEMORY, size_t ITER, size_t VERSION>
-void cn_slow_hash<MEMORY,ITER,VERSION>::explode_scratchpad_hard()
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::explode_scratchpad_hard()
 {
 	__m128i x0, x1, x2, x3, x4, x5, x6, x7;
 	__m128i k0, k1, k2, k3, k4, k5, k6, k7, k8, k9;
@@ -227,22 +174,6 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::explode_scratchpad_hard()
 	x6 = _mm_load_si128(spad.as_xmm() + 10);
 	x7 = _mm_load_si128(spad.as_xmm() + 11);
 
-	for (size_t i = 0; VERSION > 0 && i < 16; i++)
-	{
-		aes_round8(k0, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k1, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k2, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k3, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k4, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k5, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k6, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k7, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k8, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k9, x0, x1, x2, x3, x4, x5, x6, x7);
-
-		xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
-	}
-
 	for(size_t i = 0; i < MEMORY / sizeof(__m128i); i += 8)
 	{
 		aes_round8(k0, x0, x1, x2, x3, x4, x5, x6, x7);
@@ -304,11 +235,6 @@ inline uint64_t _umul128(uint64_t a, uint64_t b, uint64_t* hi)
 #endif
 #endif
 
-extern "C" void blake256_hash(uint8_t*, const uint8_t*, uint64_t);
-extern "C" void groestl(const unsigned char*, unsigned long long, unsigned char*);
-extern "C" size_t jh_hash(int, const unsigned char*, unsigned long long, unsigned char*);
-extern "C" size_t skein_hash(int, const unsigned char*, size_t, unsigned char*);
-
 inline uint64_t xmm_extract_64(__m128i x)
 {
 #ifdef BUILD32
@@ -321,10 +247,11 @@ inline uint64_t xmm_extract_64(__m128i x)
 #endif
 }
 
-template<size_t MEMORY, size_t ITER, size_t VERSION>
-void cn_slow_hash<MEMORY,ITER,VERSION>::hardware_hash(const void* in, size_t len, void* out)
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::hardware_hash(const void* in, size_t len, void* out)
 {
 	keccak((const uint8_t *)in, len, spad.as_byte(), 200);
+	const uint64_t tweak1_2 = variant1_init(in, len);
 
 	explode_scratchpad_hard();
 	
@@ -345,6 +272,8 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::hardware_hash(const void* in, size_t len
 		cx = _mm_aesenc_si128(cx, _mm_set_epi64x(ah0, al0));
 
 		_mm_store_si128(scratchpad_ptr(idx0).as_xmm(), _mm_xor_si128(bx0, cx));
+		if(VARIANT > 0)
+			variant1_1(scratchpad_ptr(idx0));
 		idx0 = xmm_extract_64(cx);
 		bx0 = cx;
 
@@ -357,43 +286,97 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::hardware_hash(const void* in, size_t len
 		al0 += hi;
 		ah0 += lo;
 		scratchpad_ptr(idx0).as_uqword(0) = al0;
-		scratchpad_ptr(idx0).as_uqword(1) = ah0;
+		scratchpad_ptr(idx0).as_uqword(1) = ah0 ^ tweak1_2;
 		ah0 ^= ch;
 		al0 ^= cl;
 		idx0 = al0;
-		
-		if(VERSION > 0)
-		{
-			int64_t n  = scratchpad_ptr(idx0).as_qword(0);
-			int32_t d  = scratchpad_ptr(idx0).as_dword(2);
-			int64_t q = n / (d | 5);
-			scratchpad_ptr(idx0).as_qword(0) = n ^ q;
-			idx0 = d ^ q;
-		}
 	}
 
 	implode_scratchpad_hard();
 
 	keccakf(spad.as_uqword(), 24);
 
-	switch(spad.as_byte(0) & 3)
+	static void (*const extra_hashes[4])(const void *, size_t, char *) =
+	{
+		Crypto::hash_extra_blake, Crypto::hash_extra_groestl, Crypto::hash_extra_jh, Crypto::hash_extra_skein
+	};
+
+	extra_hashes[spad.as_byte(0) & 3](spad.as_void(), 200, reinterpret_cast<char*>(out));
+}
+
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::hardware_hash_lanes(cn_slow_hash* const* lanes, size_t count, const void* const* in, const size_t* len, char (*out)[32])
+{
+	uint64_t al[Crypto::SLOW_HASH_MAX_LANES];
+	uint64_t ah[Crypto::SLOW_HASH_MAX_LANES];
+	__m128i bx[Crypto::SLOW_HASH_MAX_LANES];
+	uint64_t idx[Crypto::SLOW_HASH_MAX_LANES];
+	uint64_t tweak1_2[Crypto::SLOW_HASH_MAX_LANES];
+
+	assert(count <= Crypto::SLOW_HASH_MAX_LANES);
+	for(size_t k = 0; k < count; k++)
+	{
+		cn_slow_hash& lane = *lanes[k];
+		keccak((const uint8_t *)in[k], len[k], lane.spad.as_byte(), 200);
+		tweak1_2[k] = lane.variant1_init(in[k], len[k]);
+
+		lane.explode_scratchpad_hard();
+
+		uint64_t* h0 = lane.spad.as_uqword();
+		al[k] = h0[0] ^ h0[4];
+		ah[k] = h0[1] ^ h0[5];
+		bx[k] = _mm_set_epi64x(h0[3] ^ h0[7], h0[2] ^ h0[6]);
+		idx[k] = h0[0] ^ h0[4];
+	}
+
+	// the single lane loop of hardware_hash(), each step of it taken for every lane in turn
+	for(size_t i = 0; i < ITER; i++)
+	{
+		for(size_t k = 0; k < count; k++)
+		{
+			cn_slow_hash& lane = *lanes[k];
+			__m128i cx;
+			cx = _mm_load_si128(lane.scratchpad_ptr(idx[k]).as_xmm());
+
+			cx = _mm_aesenc_si128(cx, _mm_set_epi64x(ah[k], al[k]));
+
+			_mm_store_si128(lane.scratchpad_ptr(idx[k]).as_xmm(), _mm_xor_si128(bx[k], cx));
+			if(VARIANT > 0)
+				variant1_1(lane.scratchpad_ptr(idx[k]));
+			idx[k] = xmm_extract_64(cx);
+			bx[k] = cx;
+
+			uint64_t hi, lo, cl, ch;
+			cl = lane.scratchpad_ptr(idx[k]).as_uqword(0);
+			ch = lane.scratchpad_ptr(idx[k]).as_uqword(1);
+
+			lo = _umul128(idx[k], cl, &hi);
+
+			al[k] += hi;
+			ah[k] += lo;
+			lane.scratchpad_ptr(idx[k]).as_uqword(0) = al[k];
+			lane.scratchpad_ptr(idx[k]).as_uqword(1) = ah[k] ^ tweak1_2[k];
+			ah[k] ^= ch;
+			al[k] ^= cl;
+			idx[k] = al[k];
+		}
+	}
+
+	static void (*const extra_hashes[4])(const void *, size_t, char *) =
+	{
+		Crypto::hash_extra_blake, Crypto::hash_extra_groestl, Crypto::hash_extra_jh, Crypto::hash_extra_skein
+	};
+
+	for(size_t k = 0; k < count; k++)
 	{
-	case 0:
-		blake256_hash((uint8_t*)out, spad.as_byte(), 200);
-		break;
-	case 1:
-		groestl(spad.as_byte(), 200 * 8, (uint8_t*)out);
-		break;
-	case 2:
-		jh_hash(32 * 8, spad.as_byte(), 8 * 200, (uint8_t*)out);
-		break;
-	case 3:
-		skein_hash(8 * 32, spad.as_byte(), 8 * 200, (uint8_t*)out);
-		break;
+		cn_slow_hash& lane = *lanes[k];
+		lane.implode_scratchpad_hard();
+		keccakf(lane.spad.as_uqword(), 24);
+		extra_hashes[lane.spad.as_byte(0) & 3](lane.spad.as_void(), 200, out[k]);
 	}
 }
 
 template class cn_slow_hash<2*1024*1024, 0x80000, 0>;
-template class cn_slow_hash<4*1024*1024, 0x40000, 1>;
+template class cn_slow_hash<2*1024*1024, 0x80000, 1>;
 
 #endif
@@ -29,7 +29,11 @@
 // Parts of this file are originally copyright (c) 2012-2013, The Cryptonote developers
 
 #include "cn_slow_hash.hpp"
-#include "../crypto/keccak.h"
+#include "../hash.h"
+
+extern "C" {
+#include "../keccak.h"
+}
 
 /*
 AES Tables Implementation is
@@ -253,21 +257,8 @@ inline void aes_round8(const aesdata& key, aesdata& x0, aesdata& x1, aesdata& x2
 	aes_round(x7, key);
 }
 
-inline void xor_shift(aesdata& x0, aesdata& x1, aesdata& x2, aesdata& x3, aesdata& x4, aesdata& x5, aesdata& x6, aesdata& x7)
-{
-	aesdata tmp = x0;
-	x0 ^= x1;
-	x1 ^= x2;
-	x2 ^= x3;
-	x3 ^= x4;
-	x4 ^= x5;
-	x5 ^= x6;
-	x6 ^= x7;
-	x7 ^= tmp;
-}
-
-template<size_t MEMORY, size_t ITER, size_t VERSION>
-void cn_slow_hash<MEMORY,ITER,VERSION>::implode_scratchpad_soft()
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::implode_scratchpad_soft()
 {
 	aesdata x0, x1, x2, x3, x4, x5, x6, x7;
 	aesdata k0, k1, k2, k3, k4, k5, k6, k7, k8, k9;
@@ -304,52 +295,6 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::implode_scratchpad_soft()
 		aes_round8(k7, x0, x1, x2, x3, x4, x5, x6, x7);
 		aes_round8(k8, x0, x1, x2, x3, x4, x5, x6, x7);
 		aes_round8(k9, x0, x1, x2, x3, x4, x5, x6, x7);
-
-		if(VERSION > 0)
-			xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
-	}
-
-	// Note, this loop is only executed if VERSION > 0
-	for (size_t i = 0; VERSION > 0 && i < MEMORY / sizeof(uint64_t); i += 16)
-	{
-		x0.xor_load(lpad.as_uqword() + i + 0);
-		x1.xor_load(lpad.as_uqword() + i + 2);
-		x2.xor_load(lpad.as_uqword() + i + 4);
-		x3.xor_load(lpad.as_uqword() + i + 6);
-		x4.xor_load(lpad.as_uqword() + i + 8);
-		x5.xor_load(lpad.as_uqword() + i + 10);
-		x6.xor_load(lpad.as_uqword() + i + 12);
-		x7.xor_load(lpad.as_uqword() + i + 14);
-
-		aes_round8(k0, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k1, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k2, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k3, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k4, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k5, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k6, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k7, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k8, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k9, x0, x1, x2, x3, x4, x5, x6, x7);
-
-		xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
-	}
-
-	// Note, this loop is only executed if VERSION > 0
-	for (size_t i = 0; VERSION > 0 && i < 16; i++)
-	{
-		aes_round8(k0, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k1, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k2, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k3, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k4, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k5, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k6, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k7, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k8, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k9, x0, x1, x2, x3, x4, x5, x6, x7);
-
-		xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
 	}
 
 	x0.write(spad.as_uqword() + 8);
@@ -362,8 +307,8 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::implode_scratchpad_soft()
 	x7.write(spad.as_uqword() + 22);
 }
 
-template<size_t MEMORY, size_t ITER, size_t VERSION>
-void cn_slow_hash<MEMORY,ITER,VERSION>::explode_scratchpad_soft()
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::explode_scratchpad_soft()
 {
 	aesdata x0, x1, x2, x3, x4, x5, x6, x7;
 	aesdata k0, k1, k2, k3, k4, k5, k6, k7, k8, k9;
@@ -379,23 +324,6 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::explode_scratchpad_soft()
 	x6.load(spad.as_uqword() + 20);
 	x7.load(spad.as_uqword() + 22);
 
-	// Note, this loop is only executed if VERSION > 0
-	for (size_t i = 0; VERSION > 0 && i < 16; i++)
-	{
-		aes_round8(k0, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k1, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k2, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k3, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k4, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k5, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k6, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k7, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k8, x0, x1, x2, x3, x4, x5, x6, x7);
-		aes_round8(k9, x0, x1, x2, x3, x4, x5, x6, x7);
-
-		xor_shift(x0, x1, x2, x3, x4, x5, x6, x7);
-	}
-
 	for (size_t i = 0; i < MEMORY / sizeof(uint64_t); i += 16)
 	{
 		aes_round8(k0, x0, x1, x2, x3, x4, x5, x6, x7);
@@ -457,15 +385,11 @@ inline uint64_t _umul128(uint64_t a, uint64_t b, uint64_t* hi)
 #endif 
 #endif
 
-extern "C" void blake256_hash(uint8_t*, const uint8_t*, uint64_t);
-extern "C" void groestl(const unsigned char*, unsigned long long, unsigned char*);
-extern "C" size_t jh_hash(int, const unsigned char*, unsigned long long, unsigned char*);
-extern "C" size_t skein_hash(int, const unsigned char*, size_t, unsigned char*);
-
-template<size_t MEMORY, size_t ITER, size_t VERSION>
-void cn_slow_hash<MEMORY,ITER,VERSION>::software_hash(const void* in, size_t len, void* out)
+template<size_t MEMORY, size_t ITER, size_t VARIANT>
+void cn_slow_hash<MEMORY,ITER,VARIANT>::software_hash(const void* in, size_t len, void* out)
 {
 	keccak((const uint8_t *)in, len, spad.as_byte(), 200);
+	const uint64_t tweak1_2 = variant1_init(in, len);
 
 	explode_scratchpad_soft();
 	
@@ -491,6 +415,8 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::software_hash(const void* in, size_t len
 
 		bx ^= cx;
 		bx.write(idx);
+		if(VARIANT > 0)
+			variant1_1(idx);
 		idx = scratchpad_ptr(cx.v64x0);
 		bx.load(idx);
 
@@ -499,22 +425,10 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::software_hash(const void* in, size_t len
 		ax.v64x0 += hi;
 		ax.v64x1 += lo;
 		ax.write(idx);
+		idx.as_uqword(1) ^= tweak1_2;
 
 		ax ^= bx;
 		idx = scratchpad_ptr(ax.v64x0);
-		if(VERSION > 0)
-		{
-			int64_t n  = idx.as_qword(0);
-			int32_t d  = idx.as_dword(2);
-
-#if defined(__arm__)
-			asm volatile ("nop"); //Fix for RasPi3 ARM - maybe needed on armv8 
-#endif
-
-			int64_t q = n / (d | 5);
-			idx.as_qword(0) = n ^ q;
-			idx = scratchpad_ptr(d ^ q);
-		}
 
 		bx.load(idx);
 
@@ -522,6 +436,8 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::software_hash(const void* in, size_t len
 
 		cx ^= bx;
 		cx.write(idx);
+		if(VARIANT > 0)
+			variant1_1(idx);
 		idx = scratchpad_ptr(bx.v64x0);
 		cx.load(idx);
 
@@ -530,43 +446,22 @@ void cn_slow_hash<MEMORY,ITER,VERSION>::software_hash(const void* in, size_t len
 		ax.v64x0 += hi;
 		ax.v64x1 += lo;
 		ax.write(idx);
+		idx.as_uqword(1) ^= tweak1_2;
 		ax ^= cx;
 		idx = scratchpad_ptr(ax.v64x0);
-		if(VERSION > 0)
-		{
-			int64_t n  = idx.as_qword(0); // read bytes 0 - 7
-			int32_t d  = idx.as_dword(2); // read bytes 8 - 11
-
-#if defined(__arm__)
-			asm volatile ("nop"); //Fix for RasPi3 ARM - maybe needed on armv8 
-#endif
-
-			int64_t q = n / (d | 5);
-			idx.as_qword(0) = n ^ q;
-			idx = scratchpad_ptr(d ^ q);
-		}
 	}
 
 	implode_scratchpad_soft();
 
 	keccakf(spad.as_uqword(), 24);
 
-	switch(spad.as_byte(0) & 3)
+	static void (*const extra_hashes[4])(const void *, size_t, char *) =
 	{
-	case 0:
-		blake256_hash((uint8_t*)out, spad.as_byte(), 200);
-		break;
-	case 1:
-		groestl(spad.as_byte(), 200 * 8, (uint8_t*)out);
-		break;
-	case 2:
-		jh_hash(32 * 8, spad.as_byte(), 8 * 200, (uint8_t*)out);
-		break;
-	case 3:
-		skein_hash(8 * 32, spad.as_byte(), 8 * 200, (uint8_t*)out);
-		break;
-	}
+		Crypto::hash_extra_blake, Crypto::hash_extra_groestl, Crypto::hash_extra_jh, Crypto::hash_extra_skein
+	};
+
+	extra_hashes[spad.as_byte(0) & 3](spad.as_void(), 200, reinterpret_cast<char*>(out));
 }
 
 template class cn_slow_hash<2*1024*1024, 0x80000, 0>;
-template class cn_slow_hash<4*1024*1024, 0x40000, 1>;
+template class cn_slow_hash<2*1024*1024, 0x80000, 1>;
@@ -173,9 +173,9 @@ THREADV uint8_t *hp_state = NULL;
 THREADV int hp_allocated = 0;
 
 #if defined(_MSC_VER)
-#define cpuid(info,x)    __cpuidex(info,x,0)
+#define cpuid_count(info,x,y)    __cpuidex(info,x,y)
 #else
-void cpuid(int CPUInfo[4], int InfoType)
+void cpuid_count(int CPUInfo[4], int InfoType, int SubType)
 {
     ASM __volatile__
     (
@@ -184,10 +184,11 @@ void cpuid(int CPUInfo[4], int InfoType)
         "=b" (CPUInfo[1]),
         "=c" (CPUInfo[2]),
         "=d" (CPUInfo[3]) :
-            "a" (InfoType), "c" (0)
+            "a" (InfoType), "c" (SubType)
         );
 }
 #endif
+#define cpuid(info,x)    cpuid_count(info,x,0)
 
 /**
  * @brief a = (a xor b), where a and b point to 128 bit values
@@ -538,7 +539,7 @@ void slow_hash_free_state(void)
  */
 
 
-void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
+void cn_slow_hash_scratchpad(void *scratchpad, const void *data, size_t length, char *hash, int variant)
 {
     RDATA_ALIGN16 uint8_t expandedKey[240];  /* These buffers are aligned to use later with SSE functions */
 
@@ -553,6 +554,7 @@ void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
     size_t i, j;
     uint64_t *p = NULL;
     oaes_ctx *aes_ctx = NULL;
+    uint8_t *hp_state = (uint8_t *) scratchpad;
     int useAes = !force_software_aes() && check_aes_hw();
 
     static void (*const extra_hashes[4])(const void *, size_t, char *) =
@@ -560,12 +562,6 @@ void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
         hash_extra_blake, hash_extra_groestl, hash_extra_jh, hash_extra_skein
     };
 
-	// hp_state is supposed to be managed externally with respect to the 2MB scratchpad reusage logic.
-	// However, if it is not managed, it needs to be locally allocated/freed.
-    int bLocalStateAllocation = (hp_state == NULL);
-	if (bLocalStateAllocation)
-        slow_hash_allocate_state();
-
     /* CryptoNight Step 1:  Use Keccak1600 to initialize the 'state' (and 'text') buffers from the data. */
 
     hash_process(&state.hs, data, length);
@@ -669,11 +665,99 @@ void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
     memcpy(state.init, text, INIT_SIZE_BYTE);
     hash_permutation(&state.hs);
     extra_hashes[state.hs.b[0] & 3](&state, 200, hash);
+}
 
+void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
+{
+	// hp_state is supposed to be managed externally with respect to the 2MB scratchpad reusage logic.
+	// However, if it is not managed, it needs to be locally allocated/freed.
+    int bLocalStateAllocation = (hp_state == NULL);
+	if (bLocalStateAllocation)
+        slow_hash_allocate_state();
+    cn_slow_hash_scratchpad(hp_state, data, length, hash, variant);
 	if (bLocalStateAllocation)
 		slow_hash_free_state();
 }
 
+
+/**
+ * @brief cache sizes available to one logical processor
+ *
+ * Walks the deterministic cache parameters reported by cpuid (leaf 4 on Intel,
+ * 0x8000001D on AMD) and divides each cache by the number of logical
+ * processors sharing it.
+ *
+ * @param l2 receives the L2 share in bytes, 0 if the CPU doesn't report it
+ * @param last receives the share of the largest cache in bytes, 0 if unknown
+ */
+
+STATIC INLINE void cache_shares_per_thread(size_t *l2, size_t *last)
+{
+    int info[4];
+    int leaf = 4;
+    int i;
+
+    *l2 = 0;
+    *last = 0;
+    cpuid(info, 0);
+    if(info[1] == 0x68747541) /* "Auth"enticAMD */
+    {
+        cpuid(info, 0x80000000);
+        if((unsigned int) info[0] < 0x8000001D)
+            return;
+        leaf = 0x8000001D;
+    }
+    else if(info[0] < 4)
+        return;
+
+    for(i = 0; i < 16; i++)
+    {
+        size_t size, shared;
+        cpuid_count(info, leaf, i);
+        if((info[0] & 0x1f) == 0)
+            break;
+        size = (size_t) (((unsigned int) info[1] >> 22) + 1) * ((((unsigned int) info[1] >> 12) & 0x3ff) + 1) *
+               (((unsigned int) info[1] & 0xfff) + 1) * ((size_t) (unsigned int) info[2] + 1);
+        shared = (((unsigned int) info[0] >> 14) & 0xfff) + 1;
+        if(((info[0] >> 5) & 7) == 2)
+            *l2 = size / shared;
+        if(size / shared > *last)
+            *last = size / shared;
+    }
+}
+
+/**
+ * @brief how many hashes Crypto::cn_slow_hash_multi should interleave on this CPU
+ *
+ * Interleaving needs AES-NI and pays off when the scratchpad accesses go to
+ * the last level cache: the lanes hide each other's latency there.  When a
+ * whole scratchpad fits in the L2 cache a single hash is faster, and each
+ * lane needs its own 2MB of the last level cache.
+ *
+ * @return 1..SLOW_HASH_MAX_LANES
+ */
+
+size_t cn_slow_hash_lanes(void)
+{
+    static size_t lanes = 0;
+    size_t l2, last;
+
+    if(lanes != 0)
+        return lanes;
+
+    if(force_software_aes() || !check_aes_hw())
+        return lanes = 1;
+
+    cache_shares_per_thread(&l2, &last);
+    if(l2 >= MEMORY || last < 2 * MEMORY)
+        return lanes = 1;
+
+    lanes = last / MEMORY;
+    if(lanes > SLOW_HASH_MAX_LANES)
+        lanes = SLOW_HASH_MAX_LANES;
+    return lanes;
+}
+
 #elif !defined NO_AES && (defined(__arm__) || defined(__aarch64__))
 void slow_hash_allocate_state(void)
 {
@@ -881,10 +965,10 @@ STATIC INLINE void aes_pseudo_round_xor(const uint8_t *in, uint8_t *out, const u
 	}
 }
 
-void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
+void cn_slow_hash_scratchpad(void *scratchpad, const void *data, size_t length, char *hash, int variant)
 {
     RDATA_ALIGN16 uint8_t expandedKey[240];
-    RDATA_ALIGN16 uint8_t hp_state[MEMORY];
+    uint8_t *hp_state = (uint8_t *) scratchpad;
 
     uint8_t text[INIT_SIZE_BYTE];
     RDATA_ALIGN16 uint64_t a[2];
@@ -966,6 +1050,13 @@ void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
     hash_permutation(&state.hs);
     extra_hashes[state.hs.b[0] & 3](&state, 200, hash);
 }
+
+void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
+{
+    void *scratchpad = malloc(MEMORY);
+    cn_slow_hash_scratchpad(scratchpad, data, length, hash, variant);
+    free(scratchpad);
+}
 #else /* aarch64 && crypto */
 
 // ND: Some minor optimizations for ARMv7 (raspberrry pi 2), effect seems to be ~40-50% faster.
@@ -1077,7 +1168,7 @@ STATIC INLINE void xor_blocks(uint8_t* a, const uint8_t* b)
   U64(a)[1] ^= U64(b)[1];
 }
 
-void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
+void cn_slow_hash_scratchpad(void *scratchpad, const void *data, size_t length, char *hash, int variant)
 {
     uint8_t text[INIT_SIZE_BYTE];
     uint8_t a[AES_BLOCK_SIZE];
@@ -1096,7 +1187,7 @@ void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
         hash_extra_blake, hash_extra_groestl, hash_extra_jh, hash_extra_skein
     };
 
-    uint8_t *long_state = (uint8_t*)malloc(MEMORY);
+    uint8_t *long_state = (uint8_t *) scratchpad;
 
     hash_process(&state.hs, data, length);
     memcpy(text, state.init, INIT_SIZE_BYTE);
@@ -1161,8 +1252,13 @@ void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
     memcpy(state.init, text, INIT_SIZE_BYTE);
     hash_permutation(&state.hs);
     extra_hashes[state.hs.b[0] & 3](&state, 200, hash);
+}
 
-	free(long_state);
+void cn_slow_hash(const void *data, size_t length, char *hash, int variant)
+{
+    void *scratchpad = malloc(MEMORY);
+    cn_slow_hash_scratchpad(scratchpad, data, length, hash, variant);
+    free(scratchpad);
 }
 #endif /* !aarch64 || !crypto */
 
@@ -1252,8 +1348,8 @@ union cn_slow_hash_state {
 };
 #pragma pack(pop)
 
-void cn_slow_hash(const void *data, size_t length, char *hash, int variant) {
-  uint8_t* long_state = (uint8_t*)malloc(MEMORY);
+void cn_slow_hash_scratchpad(void *scratchpad, const void *data, size_t length, char *hash, int variant) {
+  uint8_t* long_state = (uint8_t*) scratchpad;
   union cn_slow_hash_state state;
   uint8_t text[INIT_SIZE_BYTE];
   uint8_t a[AES_BLOCK_SIZE];
@@ -1325,7 +1421,19 @@ void cn_slow_hash(const void *data, size_t length, char *hash, int variant) {
   /*memcpy(hash, &state, 32);*/
   extra_hashes[state.hs.b[0] & 3](&state, 200, hash);
   oaes_free((OAES_CTX **) &aes_ctx);
-  free(long_state);
 }
 
+void cn_slow_hash(const void *data, size_t length, char *hash, int variant) {
+  void *scratchpad = malloc(MEMORY);
+  cn_slow_hash_scratchpad(scratchpad, data, length, hash, variant);
+  free(scratchpad);
+}
+
+#endif
+
+#if defined NO_AES || !(defined(__x86_64__) || (defined(_MSC_VER) && defined(_WIN64)))
+size_t cn_slow_hash_lanes(void)
+{
+    return 1;
+}
 #endif
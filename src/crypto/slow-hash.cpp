@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
 #include <new>
+#include <thread>
+#include <vector>
 
 #include "hash.h"
 
@@ -13,44 +18,179 @@ using std::bad_alloc;
 namespace Crypto {
 
   enum {
-    MAP_SIZE = SLOW_HASH_CONTEXT_SIZE + ((-SLOW_HASH_CONTEXT_SIZE) & 0xfff)
+    MAP_SIZE = SLOW_HASH_SCRATCHPAD_SIZE,
+    HUGE_PAGE_SIZE = 1 << 21
   };
 
+  namespace {
+
+  enum class PageKind { HUGE_PAGES, TRANSPARENT_HUGE_PAGES, REGULAR_PAGES };
+
 #ifdef _WIN32
 
-  cn_context::cn_context() {
-    data = VirtualAlloc(nullptr, MAP_SIZE, MEM_COMMIT, PAGE_READWRITE);
-    if (data == nullptr) {
-      throw bad_alloc();
-    }
+  void *map_scratchpad(PageKind &kind) {
+    kind = PageKind::REGULAR_PAGES;
+    return VirtualAlloc(nullptr, MAP_SIZE, MEM_COMMIT, PAGE_READWRITE);
   }
 
-  cn_context::~cn_context() {
-    if (!VirtualFree(data, 0, MEM_RELEASE)) {
-      throw bad_alloc();
-    }
+  void unmap_scratchpad(void *data) {
+    VirtualFree(data, 0, MEM_RELEASE);
   }
 
 #else
 
-  cn_context::cn_context() {
+  void *map_scratchpad(PageKind &kind) {
+#if defined(MAP_HUGETLB)
+    // needs huge pages reserved by the administrator (vm.nr_hugepages)
+    void *data = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+    if (data != MAP_FAILED) {
+      kind = PageKind::HUGE_PAGES;
+      return data;
+    }
+#endif
+
+#if defined(MADV_HUGEPAGE)
+    // transparent huge pages only back 2MB aligned ranges, so map a page more and trim it
+    uint8_t *raw = static_cast<uint8_t *>(mmap(nullptr, MAP_SIZE + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (raw != MAP_FAILED) {
+      uint8_t *aligned = reinterpret_cast<uint8_t *>((reinterpret_cast<uintptr_t>(raw) + HUGE_PAGE_SIZE - 1) & ~static_cast<uintptr_t>(HUGE_PAGE_SIZE - 1));
+      size_t head = aligned - raw;
+      if (head != 0) {
+        munmap(raw, head);
+      }
+
+      if (head != HUGE_PAGE_SIZE) {
+        munmap(aligned + MAP_SIZE, HUGE_PAGE_SIZE - head);
+      }
+
+      kind = madvise(aligned, MAP_SIZE, MADV_HUGEPAGE) == 0 ? PageKind::TRANSPARENT_HUGE_PAGES : PageKind::REGULAR_PAGES;
+      // fault the scratchpad in now rather than during the first hash
+      mlock(aligned, MAP_SIZE);
+      for (size_t i = 0; i < MAP_SIZE; i += 4096) {
+        aligned[i] = 0;
+      }
+
+      return aligned;
+    }
+#endif
+
+    kind = PageKind::REGULAR_PAGES;
 #if !defined(__APPLE__)
-    data = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    void *fallback = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
 #else
-    data = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    void *fallback = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
 #endif
-    if (data == MAP_FAILED) {
-      throw bad_alloc();
+    if (fallback == MAP_FAILED) {
+      return nullptr;
     }
-    mlock(data, MAP_SIZE);
+
+    mlock(fallback, MAP_SIZE);
+    return fallback;
   }
 
-  cn_context::~cn_context() {
-    //if (munmap(data, MAP_SIZE) != 0) {
-    //  throw bad_alloc();
-    //}
+  void unmap_scratchpad(void *data) {
+    munmap(data, MAP_SIZE);
   }
 
 #endif
 
+  // Scratchpads released by contexts are kept for the next context, so short lived contexts don't map and fault in
+  // 2MB each time. Idle scratchpads beyond what every hardware thread can use at once are unmapped.
+  class ScratchpadPool {
+  public:
+    ScratchpadPool() : m_maxIdle(std::max<size_t>(1, std::thread::hardware_concurrency()) * SLOW_HASH_MAX_LANES), m_stats() {
+    }
+
+    void *acquire() {
+      {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (!m_idle.empty()) {
+          void *data = m_idle.back();
+          m_idle.pop_back();
+          return data;
+        }
+      }
+
+      PageKind kind;
+      void *data = map_scratchpad(kind);
+      if (data == nullptr) {
+        throw bad_alloc();
+      }
+
+      std::lock_guard<std::mutex> lk(m_mutex);
+      switch (kind) {
+      case PageKind::HUGE_PAGES:
+        ++m_stats.huge_pages;
+        break;
+      case PageKind::TRANSPARENT_HUGE_PAGES:
+        ++m_stats.transparent_huge_pages;
+        break;
+      default:
+        ++m_stats.regular_pages;
+        break;
+      }
+
+      return data;
+    }
+
+    void release(void *data) {
+      {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (m_idle.size() < m_maxIdle) {
+          m_idle.push_back(data);
+          return;
+        }
+      }
+
+      unmap_scratchpad(data);
+    }
+
+    cn_scratchpad_stats stats() {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      cn_scratchpad_stats stats = m_stats;
+      stats.idle = m_idle.size();
+      return stats;
+    }
+
+  private:
+    const size_t m_maxIdle;
+    std::mutex m_mutex;
+    std::vector<void *> m_idle;
+    cn_scratchpad_stats m_stats;
+  };
+
+  ScratchpadPool &scratchpad_pool() {
+    // never destroyed, contexts may still be released by other static destructors
+    static ScratchpadPool *pool = new ScratchpadPool();
+    return *pool;
+  }
+
+  }
+
+  cn_scratchpad_stats get_scratchpad_stats() {
+    return scratchpad_pool().stats();
+  }
+
+  cn_context::cn_context() {
+    for (size_t i = 0; i < SLOW_HASH_MAX_LANES; ++i) {
+      data[i] = nullptr;
+    }
+  }
+
+  cn_context::~cn_context() {
+    for (size_t i = 0; i < SLOW_HASH_MAX_LANES; ++i) {
+      if (data[i] != nullptr) {
+        scratchpad_pool().release(data[i]);
+      }
+    }
+  }
+
+  void *cn_context::scratchpad(size_t lane) {
+    if (data[lane] == nullptr) {
+      data[lane] = scratchpad_pool().acquire();
+    }
+
+    return data[lane];
+  }
+
 }
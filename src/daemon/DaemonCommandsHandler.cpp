@@ -335,7 +335,11 @@ bool DaemonCommandsHandler::print_diff(const std::vector<std::string>& args)
 //--------------------------------------------------------------------------------
 bool DaemonCommandsHandler::print_pool_count(const std::vector<std::string>& args)
 {
-  logger(Logging::INFO) << "Pending transactions in mempool: " << m_core.get_pool_transactions_count() << std::endl;
+  CryptoNote::tx_memory_pool::PoolStatistics statistics = m_core.getPoolStatistics();
+  logger(Logging::INFO) << "Pending transactions in mempool: " << statistics.transactionCount << ", size: " << statistics.bytes <<
+    (statistics.maxBytes != 0 ? " of " + std::to_string(statistics.maxBytes) : std::string()) << " bytes" << std::endl <<
+    "Minimum fee rate: " << m_core.currency().formatAmount(statistics.minimumFeeRate) << " per kB" << std::endl <<
+    "Evicted: " << statistics.evictedTransactions << " transactions, " << statistics.evictedBytes << " bytes" << std::endl;
   return true;
 }
 //--------------------------------------------------------------------------------
@@ -0,0 +1,133 @@
+#include "HashBenchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+#include "crypto/crypto.h"
+#include "crypto/hash.h"
+
+namespace Miner {
+
+namespace {
+
+// Block hashing blobs are about this long, the nonce sits at the offset the variant 1 tweak reads.
+const size_t BLOB_SIZE = 76;
+const size_t NONCE_OFFSET = 39;
+const int VARIANT = 1;
+
+struct HashInput {
+  uint8_t blob[BLOB_SIZE];
+};
+
+HashInput makeInput(uint32_t nonce) {
+  HashInput input;
+  std::memset(input.blob, 0x5a, sizeof(input.blob));
+  std::memcpy(input.blob + NONCE_OFFSET, &nonce, sizeof(nonce));
+  return input;
+}
+
+void hashLanes(Crypto::cn_context& context, const HashInput* inputs, size_t lanes, Crypto::Hash* hashes) {
+  if (lanes == 1) {
+    Crypto::cn_slow_hash(context, inputs[0].blob, BLOB_SIZE, hashes[0], VARIANT);
+    return;
+  }
+
+  const void* data[Crypto::SLOW_HASH_MAX_LANES];
+  size_t length[Crypto::SLOW_HASH_MAX_LANES];
+  int variants[Crypto::SLOW_HASH_MAX_LANES];
+  for (size_t i = 0; i < lanes; ++i) {
+    data[i] = inputs[i].blob;
+    length[i] = BLOB_SIZE;
+    variants[i] = VARIANT;
+  }
+
+  Crypto::cn_slow_hash_multi(context, data, length, variants, lanes, hashes);
+}
+
+double measure(size_t threadCount, size_t lanes, size_t seconds) {
+  std::atomic<uint64_t> hashCount(0);
+  std::atomic<bool> stop(false);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < threadCount; ++t) {
+    threads.emplace_back([&, t] {
+      Crypto::cn_context context;
+      std::vector<HashInput> inputs(lanes);
+      std::vector<Crypto::Hash> hashes(lanes);
+      uint32_t nonce = static_cast<uint32_t>(t) << 24;
+      uint64_t count = 0;
+      while (!stop) {
+        for (size_t i = 0; i < lanes; ++i) {
+          inputs[i] = makeInput(nonce++);
+        }
+
+        hashLanes(context, inputs.data(), lanes, hashes.data());
+        count += lanes;
+      }
+
+      hashCount += count;
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  stop = true;
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return static_cast<double>(hashCount.load()) / elapsed;
+}
+
+}
+
+bool runHashBenchmark(size_t threadCount, size_t seconds, std::ostream& out) {
+  Crypto::cn_context context;
+  std::vector<HashInput> inputs;
+  for (uint32_t nonce = 0; nonce < Crypto::SLOW_HASH_MAX_LANES; ++nonce) {
+    inputs.push_back(makeInput(nonce));
+  }
+
+  std::vector<Crypto::Hash> expected(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    hashLanes(context, &inputs[i], 1, &expected[i]);
+  }
+
+  for (size_t lanes = 2; lanes <= Crypto::SLOW_HASH_MAX_LANES; ++lanes) {
+    std::vector<Crypto::Hash> hashes(lanes);
+    hashLanes(context, inputs.data(), lanes, hashes.data());
+    if (!std::equal(hashes.begin(), hashes.end(), expected.begin())) {
+      out << "Interleaved hashing with " << lanes << " lanes doesn't match single hashing" << std::endl;
+      return false;
+    }
+  }
+
+  out << "Threads: " << threadCount << ", preferred lanes on this CPU: " << Crypto::cn_slow_hash_lanes() << ", single lane backend: " <<
+    Crypto::cn_pow_hash_backend() << std::endl;
+  double single = 0;
+  for (size_t lanes = 1; lanes <= Crypto::SLOW_HASH_MAX_LANES; ++lanes) {
+    double rate = measure(threadCount, lanes, seconds);
+    if (lanes == 1) {
+      single = rate;
+    }
+
+    out << lanes << (lanes == 1 ? " lane:  " : " lanes: ") << std::fixed << std::setprecision(2) << rate << " H/s";
+    if (lanes > 1 && single > 0) {
+      out << " (" << std::setprecision(2) << rate / single << "x)";
+    }
+
+    out << std::endl;
+  }
+
+  Crypto::cn_scratchpad_stats scratchpads = Crypto::get_scratchpad_stats();
+  out << "Scratchpads: " << scratchpads.huge_pages << " on huge pages, " << scratchpads.transparent_huge_pages << " on transparent huge pages, " <<
+    scratchpads.regular_pages << " on regular pages (fallback)" << std::endl;
+  return true;
+}
+
+} //namespace Miner
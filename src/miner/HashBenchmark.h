@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+namespace Miner {
+
+// Measures CryptoNight hash rates on threadCount threads, first one hash per call, then every interleaved lane count
+// up to Crypto::SLOW_HASH_MAX_LANES. Checks that all paths produce the same hashes before timing them.
+bool runHashBenchmark(size_t threadCount, size_t seconds, std::ostream& out);
+
+} //namespace Miner
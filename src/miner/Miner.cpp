@@ -1,6 +1,8 @@
 #include "Miner.h"
 
+#include <chrono>
 #include <functional>
+#include <thread>
 
 #include "crypto/crypto.h"
 #include "base/CryptoNoteFormatUtils.h"
@@ -29,10 +31,16 @@ Block Miner::mine(const BlockMiningParameters& blockMiningParameters, size_t thr
     throw std::runtime_error("Mining is already in progress");
   }
 
+  if (!m_scheduler.setJob(blockMiningParameters.blockTemplate, blockMiningParameters.difficulty)) {
+    throw std::runtime_error("Couldn't serialize block template");
+  }
+
   m_state = MiningState::MINING_IN_PROGRESS;
   m_miningStopped.clear();
 
-  runWorkers(blockMiningParameters, threadCount);
+  m_logger(Logging::INFO) << "Starting mining for difficulty " << blockMiningParameters.difficulty;
+  runWorkers(threadCount);
+  m_scheduler.clearJob();
 
   assert(m_state != MiningState::MINING_IN_PROGRESS);
   if (m_state == MiningState::MINING_STOPPED) {
@@ -44,6 +52,19 @@ Block Miner::mine(const BlockMiningParameters& blockMiningParameters, size_t thr
   return m_block;
 }
 
+bool Miner::updateBlockTemplate(const BlockMiningParameters& blockMiningParameters) {
+  if (m_state == MiningState::MINING_STOPPED) {
+    return false;
+  }
+
+  if (!m_scheduler.setJob(blockMiningParameters.blockTemplate, blockMiningParameters.difficulty)) {
+    throw std::runtime_error("Couldn't serialize block template");
+  }
+
+  m_logger(Logging::INFO) << "Switched mining to a new template, difficulty " << blockMiningParameters.difficulty;
+  return true;
+}
+
 void Miner::stop() {
   MiningState state = MiningState::MINING_IN_PROGRESS;
 
@@ -53,20 +74,14 @@ void Miner::stop() {
   }
 }
 
-void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount) {
+void Miner::runWorkers(size_t threadCount) {
   assert(threadCount > 0);
 
-  m_logger(Logging::INFO) << "Starting mining for difficulty " << blockMiningParameters.difficulty;
-
   try {
-    blockMiningParameters.blockTemplate.nonce = Crypto::rand<uint32_t>();
-
     for (size_t i = 0; i < threadCount; ++i) {
       m_workers.emplace_back(std::unique_ptr<System::RemoteContext<void>> (
-        new System::RemoteContext<void>(m_dispatcher, std::bind(&Miner::workerFunc, this, blockMiningParameters.blockTemplate, blockMiningParameters.difficulty, threadCount)))
+        new System::RemoteContext<void>(m_dispatcher, std::bind(&Miner::workerFunc, this)))
       );
-
-      blockMiningParameters.blockTemplate.nonce++;
     }
 
     m_workers.clear();
@@ -79,33 +94,35 @@ void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threa
   m_miningStopped.set();
 }
 
-void Miner::workerFunc(const Block& blockTemplate, difficulty_type difficulty, uint32_t nonceStep) {
+void Miner::workerFunc() {
   try {
-    Block block = blockTemplate;
     Crypto::cn_context cryptoContext;
+    // nonces are taken from m_scheduler in ranges and hashed Crypto::cn_slow_hash_lanes() at a time
+    NonceWorker work(m_scheduler, Crypto::cn_slow_hash_lanes());
+    Crypto::Hash hashes[Crypto::SLOW_HASH_MAX_LANES];
 
     while (m_state == MiningState::MINING_IN_PROGRESS) {
-      Crypto::Hash hash;
-      if (!get_block_longhash(cryptoContext, block, hash)) {
-        //error occured
-        m_logger(Logging::DEBUGGING) << "calculating long hash error occured";
-        m_state = MiningState::MINING_STOPPED;
-        return;
+      if (!work.next()) {
+        // every nonce of this template is taken, wait for the next one
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        continue;
       }
 
-      if (check_hash(hash, difficulty)) {
-        m_logger(Logging::INFO) << "Found block for difficulty " << difficulty;
+      work.hash(cryptoContext, hashes);
 
-        if (!setStateBlockFound()) {
-          m_logger(Logging::DEBUGGING) << "block is already found or mining stopped";
+      for (size_t i = 0; i < work.count(); ++i) {
+        if (check_hash(hashes[i], work.job().difficulty())) {
+          m_logger(Logging::INFO) << "Found block for difficulty " << work.job().difficulty();
+
+          if (!setStateBlockFound()) {
+            m_logger(Logging::DEBUGGING) << "block is already found or mining stopped";
+            return;
+          }
+
+          m_block = work.job().makeBlock(work.nonce(i));
           return;
         }
-
-        m_block = block;
-        return;
       }
-
-      block.nonce += nonceStep;
     }
   } catch (std::exception& e) {
     m_logger(Logging::ERROR) << "Miner got error: " << e.what();
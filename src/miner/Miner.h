@@ -8,6 +8,7 @@
 #include <System/RemoteContext.h>
 
 #include "CryptoNote.h"
+#include "base/NonceScheduler.h"
 #include "core/Difficulty.h"
 
 #include "log/LoggerRef.h"
@@ -26,6 +27,10 @@ public:
 
   Block mine(const BlockMiningParameters& blockMiningParameters, size_t threadCount);
 
+  // Hands a new template to the running workers, they switch before their next hash. Returns false if mining isn't
+  // in progress, true also when a block was just found and mine() is about to return it.
+  bool updateBlockTemplate(const BlockMiningParameters& blockMiningParameters);
+
   //NOTE! this is blocking method
   void stop();
 
@@ -38,12 +43,13 @@ private:
 
   std::vector<std::unique_ptr<System::RemoteContext<void>>>  m_workers;
 
+  NonceScheduler m_scheduler;
   Block m_block;
 
   Logging::LoggerRef m_logger;
 
-  void runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount);
-  void workerFunc(const Block& blockTemplate, difficulty_type difficulty, uint32_t nonceStep);
+  void runWorkers(size_t threadCount);
+  void workerFunc();
   bool setStateBlockFound();
 };
 
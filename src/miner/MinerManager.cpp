@@ -122,13 +122,15 @@ void MinerManager::eventLoop() {
 
       case MinerEventType::BLOCKCHAIN_UPDATED: {
         m_logger(Logging::DEBUGGING) << "got BLOCKCHAIN_UPDATED event";
-        stopMining();
         stopBlockchainMonitoring();
+        // the workers keep hashing the old template until the new one is in
         BlockMiningParameters params = requestMiningParameters(m_dispatcher, m_config.daemonHost, m_config.daemonPort, m_config.miningAddress);
         adjustBlockTemplate(params.blockTemplate);
 
         startBlockchainMonitoring();
-        startMining(params);
+        if (!m_miner.updateBlockTemplate(params)) {
+          startMining(params);
+        }
         break;
       }
 
@@ -168,10 +170,6 @@ void MinerManager::startMining(const CryptoNote::BlockMiningParameters& params)
   });
 }
 
-void MinerManager::stopMining() {
-  m_miner.stop();
-}
-
 void MinerManager::startBlockchainMonitoring() {
   m_contextGroup.spawn([this] () {
     try {
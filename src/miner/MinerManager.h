@@ -45,7 +45,6 @@ private:
   void pushEvent(MinerEvent&& event);
 
   void startMining(const CryptoNote::BlockMiningParameters& params);
-  void stopMining();
 
   void startBlockchainMonitoring();
   void stopBlockchainMonitoring();
@@ -18,6 +18,7 @@ namespace CryptoNote {
 namespace {
 
 const size_t DEFAULT_SCANT_PERIOD = 30;
+const size_t DEFAULT_BENCHMARK_SECONDS = 10;
 const char* DEFAULT_DAEMON_HOST = "127.0.0.1";
 const size_t CONCURRENCY_LEVEL = std::thread::hardware_concurrency();
 
@@ -46,7 +47,7 @@ void parseDaemonAddress(const std::string& daemonAddress, std::string& daemonHos
 
 }
 
-MiningConfig::MiningConfig(): help(false) {
+MiningConfig::MiningConfig(): help(false), benchmark(false) {
   cmdOptions.add_options()
       ("help,h", "produce this help message and exit")
       ("address", po::value<std::string>(), "Valid cryptonote miner's address")
@@ -59,7 +60,9 @@ MiningConfig::MiningConfig(): help(false) {
       ("limit", po::value<size_t>()->default_value(0), "Mine exact quantity of blocks. 0 means no limit")
       ("first-block-timestamp", po::value<uint64_t>()->default_value(0), "Set timestamp to the first mined block. 0 means leave timestamp unchanged")
       ("block-timestamp-interval", po::value<int64_t>()->default_value(0), "Timestamp step for each subsequent block. May be set only if --first-block-timestamp has been set."
-                                                         " If not set blocks' timestamps remain unchanged");
+                                                         " If not set blocks' timestamps remain unchanged")
+      ("benchmark", "Measure single and interleaved hash rates with --threads threads and exit")
+      ("benchmark-time", po::value<size_t>()->default_value(DEFAULT_BENCHMARK_SECONDS), "Seconds each hashing mode is measured for by --benchmark");
 }
 
 void MiningConfig::parse(int argc, char** argv) {
@@ -72,6 +75,21 @@ void MiningConfig::parse(int argc, char** argv) {
     return;
   }
 
+  threadCount = options["threads"].as<size_t>();
+  if (threadCount == 0 || threadCount > CONCURRENCY_LEVEL) {
+    throw std::runtime_error("--threads option must be 1.." + std::to_string(CONCURRENCY_LEVEL));
+  }
+
+  if (options.count("benchmark") != 0) {
+    benchmark = true;
+    benchmarkSeconds = options["benchmark-time"].as<size_t>();
+    if (benchmarkSeconds == 0) {
+      throw std::runtime_error("--benchmark-time must not be zero");
+    }
+
+    return;
+  }
+
   if (options.count("address") == 0) {
     throw std::runtime_error("Specify --address option");
   }
@@ -89,11 +107,6 @@ void MiningConfig::parse(int argc, char** argv) {
     daemonPort = options["daemon-rpc-port"].as<uint16_t>();
   }
 
-  threadCount = options["threads"].as<size_t>();
-  if (threadCount == 0 || threadCount > CONCURRENCY_LEVEL) {
-    throw std::runtime_error("--threads option must be 1.." + std::to_string(CONCURRENCY_LEVEL));
-  }
-
   scanPeriod = options["scan-time"].as<size_t>();
   if (scanPeriod == 0) {
     throw std::runtime_error("--scan-time must not be zero");
@@ -20,7 +20,9 @@ struct MiningConfig {
   size_t blocksLimit;
   uint64_t firstBlockTimestamp;
   int64_t blockTimestampInterval;
+  size_t benchmarkSeconds;
   bool help;
+  bool benchmark;
 };
 
 } //namespace CryptoNote
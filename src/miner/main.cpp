@@ -4,6 +4,7 @@
 #include "log/ConsoleLogger.h"
 #include "log/LoggerRef.h"
 
+#include "HashBenchmark.h"
 #include "MinerManager.h"
 
 #include <System/Dispatcher.h>
@@ -18,6 +19,10 @@ int main(int argc, char** argv) {
       return 0;
     }
 
+    if (config.benchmark) {
+      return Miner::runHashBenchmark(config.threadCount, config.benchmarkSeconds, std::cout) ? 0 : 1;
+    }
+
     Logging::LoggerGroup loggerGroup;
     Logging::ConsoleLogger consoleLogger(static_cast<Logging::Level>(config.logLevel));
     loggerGroup.addLogger(consoleLogger);
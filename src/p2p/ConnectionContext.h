@@ -1,8 +1,10 @@
 #pragma once
 
+#include <deque>
 #include <list>
 #include <ostream>
 #include <unordered_set>
+#include <vector>
 
 #include <boost/uuid/uuid.hpp>
 #include "common/StringTools.h"
@@ -33,6 +35,18 @@ struct CryptoNoteConnectionContext {
   std::unordered_set<Crypto::Hash> m_requested_objects;
   uint32_t m_remote_blockchain_height = 0;
   uint32_t m_last_response_height = 0;
+
+  // compact block waiting for the transactions asked with NOTIFY_REQUEST_BLOCK_TXS
+  std::string m_pending_block;
+  Crypto::Hash m_pending_block_id = {};
+  uint32_t m_pending_block_hop = 0;
+  std::unordered_set<Crypto::Hash> m_pending_block_txs;
+
+  // transactions the peer has, from either side, the oldest are forgotten first
+  std::unordered_set<Crypto::Hash> m_known_txs;
+  std::deque<Crypto::Hash> m_known_txs_order;
+  // announcements waiting for the next NOTIFY_TX_INVENTORY to the peer
+  std::vector<Crypto::Hash> m_tx_announcements;
 };
 
 inline std::string get_protocol_state_string(CryptoNoteConnectionContext::state s) {
@@ -145,7 +145,7 @@ void PaymentGateService::runInProcess(Logging::LoggerRef& log) {
   CryptoNote::Currency currency = currencyBuilder.currency();
   CryptoNote::core core(currency, NULL, logger, false);
 
-  CryptoNote::CryptoNoteProtocolHandler protocol(currency, *dispatcher, core, NULL, logger);
+  CryptoNote::CryptoNoteProtocolHandler protocol(currency, *dispatcher, core, core.getWorkerPool(), NULL, logger);
   CryptoNote::NodeServer p2pNode(*dispatcher, protocol, logger);
 
   protocol.set_p2p_endpoint(&p2pNode);
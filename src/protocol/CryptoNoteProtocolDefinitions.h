@@ -192,4 +192,97 @@ namespace CryptoNote
     const static int ID = BC_COMMANDS_POOL_BASE + 8;
     typedef NOTIFY_REQUEST_TX_POOL_request request;
   };
+
+  /************************************************************************/
+  /*                                                                      */
+  /************************************************************************/
+  // NOTIFY_NEW_BLOCK without the transactions, the block only carries their hashes. Peers take them from their pools
+  // and ask for the rest with NOTIFY_REQUEST_BLOCK_TXS.
+  struct NOTIFY_NEW_COMPACT_BLOCK_request
+  {
+    std::string block;
+    uint32_t current_blockchain_height;
+    uint32_t hop;
+
+    void serialize(ISerializer& s) {
+      KV_MEMBER(block)
+      KV_MEMBER(current_blockchain_height)
+      KV_MEMBER(hop)
+    }
+  };
+
+  struct NOTIFY_NEW_COMPACT_BLOCK
+  {
+    const static int ID = BC_COMMANDS_POOL_BASE + 9;
+    typedef NOTIFY_NEW_COMPACT_BLOCK_request request;
+  };
+
+  struct NOTIFY_REQUEST_BLOCK_TXS_request
+  {
+    Crypto::Hash block_id;
+    std::vector<Crypto::Hash> txs;
+
+    void serialize(ISerializer& s) {
+      KV_MEMBER(block_id)
+      serializeAsBinary(txs, "txs", s);
+    }
+  };
+
+  struct NOTIFY_REQUEST_BLOCK_TXS
+  {
+    const static int ID = BC_COMMANDS_POOL_BASE + 10;
+    typedef NOTIFY_REQUEST_BLOCK_TXS_request request;
+  };
+
+  struct NOTIFY_RESPONSE_BLOCK_TXS_request
+  {
+    Crypto::Hash block_id;
+    std::vector<std::string> txs;
+
+    void serialize(ISerializer& s) {
+      KV_MEMBER(block_id)
+      KV_MEMBER(txs)
+    }
+  };
+
+  struct NOTIFY_RESPONSE_BLOCK_TXS
+  {
+    const static int ID = BC_COMMANDS_POOL_BASE + 11;
+    typedef NOTIFY_RESPONSE_BLOCK_TXS_request request;
+  };
+
+  /************************************************************************/
+  /*                                                                      */
+  /************************************************************************/
+  // Hashes of new transactions, the peer asks the ones it misses with NOTIFY_REQUEST_TXS and gets them in
+  // NOTIFY_NEW_TRANSACTIONS.
+  struct NOTIFY_TX_INVENTORY_request
+  {
+    std::vector<Crypto::Hash> txs;
+
+    void serialize(ISerializer& s) {
+      serializeAsBinary(txs, "txs", s);
+    }
+  };
+
+  struct NOTIFY_TX_INVENTORY
+  {
+    const static int ID = BC_COMMANDS_POOL_BASE + 12;
+    typedef NOTIFY_TX_INVENTORY_request request;
+  };
+
+  struct NOTIFY_REQUEST_TXS_request
+  {
+    std::vector<Crypto::Hash> txs;
+
+    void serialize(ISerializer& s) {
+      serializeAsBinary(txs, "txs", s);
+    }
+  };
+
+  struct NOTIFY_REQUEST_TXS
+  {
+    const static int ID = BC_COMMANDS_POOL_BASE + 13;
+    typedef NOTIFY_REQUEST_TXS_request request;
+  };
 }
@@ -1,5 +1,6 @@
 #include "CryptoNoteProtocolHandler.h"
 
+#include <algorithm>
 #include <future>
 #include <boost/scope_exit.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -24,14 +25,21 @@ bool post_notify(IP2pEndpoint& p2p, typename t_parametr::request& arg, const Cry
   return p2p.invoke_notify_to_peer(t_parametr::ID, LevinProtocol::encode(arg), context);
 }
 
-template<class t_parametr>
-void relay_post_notify(IP2pEndpoint& p2p, typename t_parametr::request& arg, const net_connection_id* excludeConnection = nullptr) {
-  p2p.relay_notify_to_all(t_parametr::ID, LevinProtocol::encode(arg), excludeConnection);
+void addKnownTransaction(CryptoNoteConnectionContext& context, const Crypto::Hash& transactionHash) {
+  if (!context.m_known_txs.insert(transactionHash).second) {
+    return;
+  }
+
+  context.m_known_txs_order.push_back(transactionHash);
+  if (context.m_known_txs_order.size() > P2P_TX_KNOWN_INVENTORY_SIZE) {
+    context.m_known_txs.erase(context.m_known_txs_order.front());
+    context.m_known_txs_order.pop_front();
+  }
 }
 
 }
 
-CryptoNoteProtocolHandler::CryptoNoteProtocolHandler(const Currency& currency, System::Dispatcher& dispatcher, ICore& rcore, IP2pEndpoint* p_net_layout, Logging::ILogger& log) :
+CryptoNoteProtocolHandler::CryptoNoteProtocolHandler(const Currency& currency, System::Dispatcher& dispatcher, ICore& rcore, Tools::WorkerPool& workerPool, IP2pEndpoint* p_net_layout, Logging::ILogger& log) :
   m_dispatcher(dispatcher),
   m_currency(currency),
   m_core(rcore),
@@ -40,6 +48,7 @@ CryptoNoteProtocolHandler::CryptoNoteProtocolHandler(const Currency& currency, S
   m_stop(false),
   m_observedHeight(0),
   m_peersCount(0),
+  m_workerPool(workerPool),
   logger(log, "protocol") {
 
   if (!m_p2p) {
@@ -77,12 +86,39 @@ void CryptoNoteProtocolHandler::onConnectionClosed(CryptoNoteConnectionContext&
     m_observerManager.notify(&ICryptoNoteProtocolObserver::lastKnownBlockHeightUpdated, m_observedHeight);
   }
 
+  removeTransactionAnnouncer(context.m_connection_id);
+
   if (context.m_state != CryptoNoteConnectionContext::state_befor_handshake) {
     m_peersCount--;
     m_observerManager.notify(&ICryptoNoteProtocolObserver::peerCountUpdated, m_peersCount.load());
   }
 }
 
+void CryptoNoteProtocolHandler::removeTransactionAnnouncer(const net_connection_id& connectionId) {
+  // a request asked from the peer is lost with it, the next retry pass asks the next announcer
+  for (auto it = m_transactionRequests.begin(); it != m_transactionRequests.end();) {
+    auto& announcers = it->second.announcers;
+    auto announcer = std::find(announcers.begin(), announcers.end(), connectionId);
+    if (announcer == announcers.end()) {
+      ++it;
+      continue;
+    }
+
+    if (announcer == announcers.begin()) {
+      it->second.requested = false;
+    }
+
+    announcers.erase(announcer);
+    if (announcers.empty()) {
+      it = m_transactionRequests.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  m_transactionAnnouncers.erase(connectionId);
+}
+
 void CryptoNoteProtocolHandler::stop() {
   m_stop = true;
 }
@@ -208,6 +244,11 @@ int CryptoNoteProtocolHandler::handleCommand(bool is_notify, int command, const
     HANDLE_NOTIFY(NOTIFY_REQUEST_CHAIN, &CryptoNoteProtocolHandler::handle_request_chain)
     HANDLE_NOTIFY(NOTIFY_RESPONSE_CHAIN_ENTRY, &CryptoNoteProtocolHandler::handle_response_chain_entry)
     HANDLE_NOTIFY(NOTIFY_REQUEST_TX_POOL, &CryptoNoteProtocolHandler::handleRequestTxPool)
+    HANDLE_NOTIFY(NOTIFY_NEW_COMPACT_BLOCK, &CryptoNoteProtocolHandler::handle_notify_new_compact_block)
+    HANDLE_NOTIFY(NOTIFY_REQUEST_BLOCK_TXS, &CryptoNoteProtocolHandler::handle_request_block_txs)
+    HANDLE_NOTIFY(NOTIFY_RESPONSE_BLOCK_TXS, &CryptoNoteProtocolHandler::handle_response_block_txs)
+    HANDLE_NOTIFY(NOTIFY_TX_INVENTORY, &CryptoNoteProtocolHandler::handle_notify_tx_inventory)
+    HANDLE_NOTIFY(NOTIFY_REQUEST_TXS, &CryptoNoteProtocolHandler::handle_request_txs)
 
   default:
     handled = false;
@@ -243,18 +284,166 @@ int CryptoNoteProtocolHandler::handle_notify_new_block(int command, NOTIFY_NEW_B
     }
   }
 
+  processNewBlock(arg, std::vector<Crypto::Hash>(), context);
+  return 1;
+}
+
+int CryptoNoteProtocolHandler::handle_notify_new_compact_block(int command, NOTIFY_NEW_COMPACT_BLOCK::request& arg, CryptoNoteConnectionContext& context) {
+  logger(Logging::TRACE) << context << "NOTIFY_NEW_COMPACT_BLOCK (hop " << arg.hop << ")";
+
+  updateObservedHeight(arg.current_blockchain_height, context);
+
+  context.m_remote_blockchain_height = arg.current_blockchain_height;
+
+  if (context.m_state != CryptoNoteConnectionContext::state_normal) {
+    return 1;
+  }
+
+  Block block;
+  if (!fromBinaryArray(block, asBinaryArray(arg.block))) {
+    logger(Logging::INFO) << context << "Failed to parse compact block, dropping connection";
+    context.m_state = CryptoNoteConnectionContext::state_shutdown;
+    return 1;
+  }
+
+  Crypto::Hash blockId = get_block_hash(block);
+  if (m_core.have_block(blockId)) {
+    return 1;
+  }
+
+  std::vector<Crypto::Hash> missedTxs;
+  m_core.getTransactionsMissingFromPool(block.transactionHashes, missedTxs);
+
+  NOTIFY_NEW_BLOCK::request blockArg;
+  if (missedTxs.empty()) {
+    blockArg.b.block = std::move(arg.block);
+    blockArg.current_blockchain_height = arg.current_blockchain_height;
+    blockArg.hop = arg.hop;
+    processNewBlock(blockArg, block.transactionHashes, context);
+    return 1;
+  }
+
+  // a newer block replaces the one still waiting for its transactions
+  context.m_pending_block = std::move(arg.block);
+  context.m_pending_block_id = blockId;
+  context.m_pending_block_hop = arg.hop;
+  context.m_pending_block_txs.clear();
+  context.m_pending_block_txs.insert(missedTxs.begin(), missedTxs.end());
+
+  NOTIFY_REQUEST_BLOCK_TXS::request request;
+  request.block_id = blockId;
+  request.txs = std::move(missedTxs);
+  logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_BLOCK_TXS: " << request.txs.size() << " of " << block.transactionHashes.size() << " transactions";
+  post_notify<NOTIFY_REQUEST_BLOCK_TXS>(*m_p2p, request, context);
+  return 1;
+}
+
+int CryptoNoteProtocolHandler::handle_request_block_txs(int command, NOTIFY_REQUEST_BLOCK_TXS::request& arg, CryptoNoteConnectionContext& context) {
+  logger(Logging::TRACE) << context << "NOTIFY_REQUEST_BLOCK_TXS: txs.size()=" << arg.txs.size();
+
+  if (arg.txs.size() > P2P_TX_INVENTORY_MAX_COUNT) {
+    logger(Logging::INFO) << context << "NOTIFY_REQUEST_BLOCK_TXS with " << arg.txs.size() << " transactions, dropping connection";
+    context.m_state = CryptoNoteConnectionContext::state_shutdown;
+    return 1;
+  }
+
+  // compact blocks are only relayed once added, so the block is known; only its own transactions are served
+  std::vector<Crypto::Hash> blockTxs;
+  Block block;
+  if (m_core.getBlockByHash(arg.block_id, block)) {
+    std::unordered_set<Crypto::Hash> blockTxHashes(block.transactionHashes.begin(), block.transactionHashes.end());
+    for (const auto& transactionHash : arg.txs) {
+      if (blockTxHashes.count(transactionHash) != 0) {
+        blockTxs.push_back(transactionHash);
+      }
+    }
+  }
+
+  std::list<Transaction> txs;
+  std::list<Crypto::Hash> missedTxs;
+  m_core.getTransactions(blockTxs, txs, missedTxs, true);
+
+  NOTIFY_RESPONSE_BLOCK_TXS::request response;
+  response.block_id = arg.block_id;
+  for (const auto& tx : txs) {
+    response.txs.push_back(asString(toBinaryArray(tx)));
+  }
+
+  post_notify<NOTIFY_RESPONSE_BLOCK_TXS>(*m_p2p, response, context);
+  return 1;
+}
+
+int CryptoNoteProtocolHandler::handle_response_block_txs(int command, NOTIFY_RESPONSE_BLOCK_TXS::request& arg, CryptoNoteConnectionContext& context) {
+  logger(Logging::TRACE) << context << "NOTIFY_RESPONSE_BLOCK_TXS: txs.size()=" << arg.txs.size();
+
+  if (context.m_pending_block.empty() || arg.block_id != context.m_pending_block_id) {
+    return 1;
+  }
+
+  NOTIFY_NEW_BLOCK::request blockArg;
+  blockArg.b.block = std::move(context.m_pending_block);
+  blockArg.current_blockchain_height = context.m_remote_blockchain_height;
+  blockArg.hop = context.m_pending_block_hop;
+  std::unordered_set<Crypto::Hash> pendingTxs = std::move(context.m_pending_block_txs);
+  context.m_pending_block.clear();
+  context.m_pending_block_txs.clear();
+
+  if (context.m_state != CryptoNoteConnectionContext::state_normal) {
+    return 1;
+  }
+
+  for (const auto& txBlob : arg.txs) {
+    CryptoNote::tx_verification_context tvc = boost::value_initialized<decltype(tvc)>();
+    auto transactionBinary = asBinaryArray(txBlob);
+    Crypto::Hash transactionHash = Crypto::cn_fast_hash(transactionBinary.data(), transactionBinary.size());
+    if (pendingTxs.count(transactionHash) == 0) {
+      logger(Logging::INFO) << context << "Transaction " << transactionHash << " wasn't requested for block " << arg.block_id << ", dropping connection";
+      context.m_state = CryptoNoteConnectionContext::state_shutdown;
+      return 1;
+    }
+
+    logger(DEBUGGING) << "transaction " << transactionHash << " came in NOTIFY_RESPONSE_BLOCK_TXS";
+    m_core.handle_incoming_tx(transactionBinary, tvc, true);
+    if (tvc.m_verification_failed) {
+      logger(Logging::INFO) << context << "Block verification failed: transaction verification failed, dropping connection";
+      context.m_state = CryptoNoteConnectionContext::state_shutdown;
+      return 1;
+    }
+  }
+
+  Block block;
+  if (!fromBinaryArray(block, asBinaryArray(blockArg.b.block))) {
+    return 1;
+  }
+
+  // the peer lost some of them or our pool dropped others meanwhile, the block comes with the regular synchronization
+  std::vector<Crypto::Hash> missedTxs;
+  m_core.getTransactionsMissingFromPool(block.transactionHashes, missedTxs);
+  if (!missedTxs.empty()) {
+    logger(Logging::DEBUGGING) << context << "Block " << arg.block_id << " still misses " << missedTxs.size() << " transactions, synchronizing";
+    context.m_state = CryptoNoteConnectionContext::state_synchronizing;
+    NOTIFY_REQUEST_CHAIN::request r = boost::value_initialized<NOTIFY_REQUEST_CHAIN::request>();
+    r.block_ids = m_core.buildSparseChain();
+    logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_CHAIN: m_block_ids.size()=" << r.block_ids.size();
+    post_notify<NOTIFY_REQUEST_CHAIN>(*m_p2p, r, context);
+    return 1;
+  }
+
+  processNewBlock(blockArg, block.transactionHashes, context);
+  return 1;
+}
+
+void CryptoNoteProtocolHandler::processNewBlock(NOTIFY_NEW_BLOCK::request& arg, const std::vector<Crypto::Hash>& transactionHashes, CryptoNoteConnectionContext& context) {
   block_verification_context bvc = boost::value_initialized<block_verification_context>();
   m_core.handle_incoming_block_blob(asBinaryArray(arg.b.block), bvc, true, false);
   if (bvc.m_verification_failed) {
     logger(Logging::DEBUGGING) << context << "Block verification failed, dropping connection";
     context.m_state = CryptoNoteConnectionContext::state_shutdown;
-    return 1;
+    return;
   }
   if (bvc.m_added_to_main_chain) {
     ++arg.hop;
-    //TODO: Add here announce protocol usage
-    relay_post_notify<NOTIFY_NEW_BLOCK>(*m_p2p, arg, &context.m_connection_id);
-    // relay_block(arg, context);
+    relayNewBlock(arg, transactionHashes, &context.m_connection_id);
 
     if (bvc.m_switched_to_alt_chain) {
       requestMissingPoolTransactions(context);
@@ -266,8 +455,174 @@ int CryptoNoteProtocolHandler::handle_notify_new_block(int command, NOTIFY_NEW_B
     logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_CHAIN: m_block_ids.size()=" << r.block_ids.size();
     post_notify<NOTIFY_REQUEST_CHAIN>(*m_p2p, r, context);
   }
+}
 
-  return 1;
+void CryptoNoteProtocolHandler::relayTransactions(NOTIFY_NEW_TRANSACTIONS::request& arg, const std::vector<Crypto::Hash>& transactionHashes, const net_connection_id* excludeConnection) {
+  BinaryArray buffer;
+  m_p2p->for_each_connection([&](CryptoNoteConnectionContext& ctx, PeerIdType peerId) {
+    if (peerId == 0 || (excludeConnection != nullptr && ctx.m_connection_id == *excludeConnection) ||
+        (ctx.m_state != CryptoNoteConnectionContext::state_normal && ctx.m_state != CryptoNoteConnectionContext::state_synchronizing)) {
+      return;
+    }
+
+    if (ctx.version >= P2PProtocolVersion::V3) {
+      for (const auto& transactionHash : transactionHashes) {
+        if (ctx.m_known_txs.count(transactionHash) == 0) {
+          ctx.m_tx_announcements.push_back(transactionHash);
+          addKnownTransaction(ctx, transactionHash);
+        }
+      }
+
+      return;
+    }
+
+    if (buffer.empty()) {
+      buffer = LevinProtocol::encode(arg);
+    }
+
+    m_p2p->invoke_notify_to_peer(NOTIFY_NEW_TRANSACTIONS::ID, buffer, ctx);
+  });
+}
+
+void CryptoNoteProtocolHandler::announceTransactions() {
+  m_p2p->for_each_connection([&](CryptoNoteConnectionContext& ctx, PeerIdType peerId) {
+    if (ctx.m_tx_announcements.empty()) {
+      return;
+    }
+
+    std::vector<Crypto::Hash> announcements;
+    announcements.swap(ctx.m_tx_announcements);
+    for (size_t i = 0; i < announcements.size(); i += P2P_TX_INVENTORY_MAX_COUNT) {
+      NOTIFY_TX_INVENTORY::request notification;
+      size_t count = std::min<size_t>(P2P_TX_INVENTORY_MAX_COUNT, announcements.size() - i);
+      notification.txs.assign(announcements.begin() + i, announcements.begin() + i + count);
+      post_notify<NOTIFY_TX_INVENTORY>(*m_p2p, notification, ctx);
+    }
+  });
+}
+
+void CryptoNoteProtocolHandler::retryTransactionRequests(std::chrono::steady_clock::time_point now) {
+  std::map<net_connection_id, std::vector<Crypto::Hash>> requests;
+  for (auto it = m_transactionRequests.begin(); it != m_transactionRequests.end();) {
+    TransactionRequest& transactionRequest = it->second;
+    if (transactionRequest.requested) {
+      if (now - transactionRequest.time < std::chrono::seconds(P2P_TX_REQUEST_TIMEOUT)) {
+        ++it;
+        continue;
+      }
+
+      // the asked peer didn't send the transaction in time, the next peer that announced it is asked
+      TransactionAnnouncer& announcer = m_transactionAnnouncers[transactionRequest.announcers.front()];
+      --announcer.pending;
+      --announcer.inFlight;
+      transactionRequest.announcers.pop_front();
+      transactionRequest.requested = false;
+      if (transactionRequest.announcers.empty()) {
+        it = m_transactionRequests.erase(it);
+        continue;
+      }
+    }
+
+    const net_connection_id& connectionId = transactionRequest.announcers.front();
+    TransactionAnnouncer& announcer = m_transactionAnnouncers[connectionId];
+    if (announcer.inFlight < P2P_TX_REQUEST_MAX_IN_FLIGHT) {
+      ++announcer.inFlight;
+      transactionRequest.requested = true;
+      transactionRequest.time = now;
+      requests[connectionId].push_back(it->first);
+    }
+
+    ++it;
+  }
+
+  if (requests.empty()) {
+    return;
+  }
+
+  m_p2p->for_each_connection([&](CryptoNoteConnectionContext& ctx, PeerIdType peerId) {
+    auto it = requests.find(ctx.m_connection_id);
+    if (it != requests.end()) {
+      NOTIFY_REQUEST_TXS::request request;
+      request.txs = std::move(it->second);
+      logger(Logging::TRACE) << ctx << "-->>NOTIFY_REQUEST_TXS: txs.size()=" << request.txs.size();
+      post_notify<NOTIFY_REQUEST_TXS>(*m_p2p, request, ctx);
+    }
+  });
+}
+
+void CryptoNoteProtocolHandler::eraseTransactionRequest(const Crypto::Hash& transactionHash) {
+  auto it = m_transactionRequests.find(transactionHash);
+  if (it == m_transactionRequests.end()) {
+    return;
+  }
+
+  for (const auto& connectionId : it->second.announcers) {
+    --m_transactionAnnouncers[connectionId].pending;
+  }
+
+  if (it->second.requested) {
+    --m_transactionAnnouncers[it->second.announcers.front()].inFlight;
+  }
+
+  m_transactionRequests.erase(it);
+}
+
+void CryptoNoteProtocolHandler::addRejectedTransaction(const Crypto::Hash& transactionHash) {
+  if (!m_rejectedTransactions.insert(transactionHash).second) {
+    return;
+  }
+
+  m_rejectedTransactionsOrder.push_back(transactionHash);
+  if (m_rejectedTransactionsOrder.size() > P2P_TX_REJECTED_FILTER_SIZE) {
+    m_rejectedTransactions.erase(m_rejectedTransactionsOrder.front());
+    m_rejectedTransactionsOrder.pop_front();
+  }
+}
+
+void CryptoNoteProtocolHandler::relayNewBlock(NOTIFY_NEW_BLOCK::request& arg, const std::vector<Crypto::Hash>& transactionHashes, const net_connection_id* excludeConnection) {
+  NOTIFY_NEW_COMPACT_BLOCK::request compactArg;
+  compactArg.block = arg.b.block;
+  compactArg.current_blockchain_height = arg.current_blockchain_height;
+  compactArg.hop = arg.hop;
+  BinaryArray compactBuffer = LevinProtocol::encode(compactArg);
+
+  BinaryArray fullBuffer;
+  bool fullEncoded = false;
+  m_p2p->for_each_connection([&](CryptoNoteConnectionContext& ctx, PeerIdType peerId) {
+    if (peerId == 0 || (excludeConnection != nullptr && ctx.m_connection_id == *excludeConnection) ||
+        (ctx.m_state != CryptoNoteConnectionContext::state_normal && ctx.m_state != CryptoNoteConnectionContext::state_synchronizing)) {
+      return;
+    }
+
+    if (ctx.version >= P2PProtocolVersion::V2) {
+      m_p2p->invoke_notify_to_peer(NOTIFY_NEW_COMPACT_BLOCK::ID, compactBuffer, ctx);
+      return;
+    }
+
+    if (!fullEncoded) {
+      fullEncoded = true;
+      if (arg.b.txs.size() < transactionHashes.size()) {
+        std::list<Transaction> txs;
+        std::list<Crypto::Hash> missedTxs;
+        m_core.getTransactions(transactionHashes, txs, missedTxs, true);
+        if (!missedTxs.empty()) {
+          logger(Logging::DEBUGGING) << "Block transactions are gone, the block isn't relayed to older peers";
+          return;
+        }
+
+        arg.b.txs.clear();
+        for (const auto& tx : txs) {
+          arg.b.txs.push_back(asString(toBinaryArray(tx)));
+        }
+      }
+
+      fullBuffer = LevinProtocol::encode(arg);
+    }
+
+    if (!fullBuffer.empty()) {
+      m_p2p->invoke_notify_to_peer(NOTIFY_NEW_BLOCK::ID, fullBuffer, ctx);
+    }
+  });
 }
 
 int CryptoNoteProtocolHandler::handle_notify_new_transactions(int command, NOTIFY_NEW_TRANSACTIONS::request& arg, CryptoNoteConnectionContext& context) {
@@ -275,30 +630,140 @@ int CryptoNoteProtocolHandler::handle_notify_new_transactions(int command, NOTIF
   if (context.m_state != CryptoNoteConnectionContext::state_normal)
     return 1;
 
-  for (auto tx_blob_it = arg.txs.begin(); tx_blob_it != arg.txs.end();) {
-    auto transactionBinary = asBinaryArray(*tx_blob_it);
-    Crypto::Hash transactionHash = Crypto::cn_fast_hash(transactionBinary.data(), transactionBinary.size());
+  std::vector<BinaryArray> transactionBinaries;
+  std::vector<Crypto::Hash> transactionHashes;
+  transactionBinaries.reserve(arg.txs.size());
+  transactionHashes.reserve(arg.txs.size());
+  for (const auto& tx_blob : arg.txs) {
+    transactionBinaries.push_back(asBinaryArray(tx_blob));
+    Crypto::Hash transactionHash = Crypto::cn_fast_hash(transactionBinaries.back().data(), transactionBinaries.back().size());
     logger(DEBUGGING) << "transaction " << transactionHash << " came in NOTIFY_NEW_TRANSACTIONS";
-    CryptoNote::tx_verification_context tvc = boost::value_initialized<decltype(tvc)>();
-    m_core.handle_incoming_tx(transactionBinary, tvc, false);
-    if (tvc.m_verification_failed) {
+    transactionHashes.push_back(transactionHash);
+    addKnownTransaction(context, transactionHash);
+    eraseTransactionRequest(transactionHash);
+  }
+
+  std::vector<tx_verification_context> tvcs;
+  m_core.handle_incoming_txs(transactionBinaries, tvcs);
+
+  std::vector<std::string> relayedTransactions;
+  std::vector<Crypto::Hash> relayedHashes;
+  for (size_t i = 0; i < tvcs.size(); ++i) {
+    if (tvcs[i].m_verification_failed) {
       logger(Logging::TRACE) << context << "Tx verification failed";
+      addRejectedTransaction(transactionHashes[i]);
     }
-    if (!tvc.m_verification_failed && tvc.m_should_be_relayed) {
-      ++tx_blob_it;
-    } else {
-      tx_blob_it = arg.txs.erase(tx_blob_it);
+    if (!tvcs[i].m_verification_failed && tvcs[i].m_should_be_relayed) {
+      relayedTransactions.push_back(std::move(arg.txs[i]));
+      relayedHashes.push_back(transactionHashes[i]);
     }
   }
 
+  arg.txs = std::move(relayedTransactions);
+
   if (arg.txs.size()) {
-    //TODO: add announce usage here
-    relay_post_notify<NOTIFY_NEW_TRANSACTIONS>(*m_p2p, arg, &context.m_connection_id);
+    relayTransactions(arg, relayedHashes, &context.m_connection_id);
   }
 
   return true;
 }
 
+int CryptoNoteProtocolHandler::handle_notify_tx_inventory(int command, NOTIFY_TX_INVENTORY::request& arg, CryptoNoteConnectionContext& context) {
+  logger(Logging::TRACE) << context << "NOTIFY_TX_INVENTORY: txs.size()=" << arg.txs.size();
+  if (context.m_state != CryptoNoteConnectionContext::state_normal) {
+    return 1;
+  }
+
+  if (arg.txs.size() > P2P_TX_INVENTORY_MAX_COUNT) {
+    logger(Logging::INFO) << context << "NOTIFY_TX_INVENTORY with " << arg.txs.size() << " transactions, dropping connection";
+    context.m_state = CryptoNoteConnectionContext::state_shutdown;
+    return 1;
+  }
+
+  for (const auto& transactionHash : arg.txs) {
+    addKnownTransaction(context, transactionHash);
+  }
+
+  std::vector<Crypto::Hash> missedTxs;
+  m_core.getTransactionsMissingFromPool(arg.txs, missedTxs);
+
+  NOTIFY_REQUEST_TXS::request request;
+  auto now = std::chrono::steady_clock::now();
+  TransactionAnnouncer& announcer = m_transactionAnnouncers[context.m_connection_id];
+  for (const auto& transactionHash : missedTxs) {
+    if (m_rejectedTransactions.count(transactionHash) != 0) {
+      continue;
+    }
+
+    // a peer announcing more than can be fetched from it has the rest ignored
+    if (announcer.pending >= P2P_TX_REQUEST_MAX_PENDING) {
+      logger(Logging::DEBUGGING) << context << "Too many announced transactions pending, ignoring the rest";
+      break;
+    }
+
+    auto it = m_transactionRequests.find(transactionHash);
+    if (it != m_transactionRequests.end()) {
+      // asked from another peer, this one is next if that fails
+      auto& announcers = it->second.announcers;
+      if (std::find(announcers.begin(), announcers.end(), context.m_connection_id) == announcers.end()) {
+        announcers.push_back(context.m_connection_id);
+        ++announcer.pending;
+      }
+
+      continue;
+    }
+
+    TransactionRequest& transactionRequest = m_transactionRequests[transactionHash];
+    transactionRequest.time = now;
+    transactionRequest.announcers.push_back(context.m_connection_id);
+    transactionRequest.requested = false;
+    ++announcer.pending;
+
+    // the rest is deferred to the retry pass, which asks for more as these are delivered
+    if (announcer.inFlight < P2P_TX_REQUEST_MAX_IN_FLIGHT) {
+      transactionRequest.requested = true;
+      ++announcer.inFlight;
+      request.txs.push_back(transactionHash);
+    }
+  }
+
+  if (!request.txs.empty()) {
+    logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_TXS: txs.size()=" << request.txs.size();
+    post_notify<NOTIFY_REQUEST_TXS>(*m_p2p, request, context);
+  }
+
+  return 1;
+}
+
+int CryptoNoteProtocolHandler::handle_request_txs(int command, NOTIFY_REQUEST_TXS::request& arg, CryptoNoteConnectionContext& context) {
+  logger(Logging::TRACE) << context << "NOTIFY_REQUEST_TXS: txs.size()=" << arg.txs.size();
+
+  if (arg.txs.size() > P2P_TX_INVENTORY_MAX_COUNT) {
+    logger(Logging::INFO) << context << "NOTIFY_REQUEST_TXS with " << arg.txs.size() << " transactions, dropping connection";
+    context.m_state = CryptoNoteConnectionContext::state_shutdown;
+    return 1;
+  }
+
+  std::list<Transaction> txs;
+  std::list<Crypto::Hash> missedTxs;
+  m_core.getTransactions(arg.txs, txs, missedTxs, true);
+
+  NOTIFY_NEW_TRANSACTIONS::request response;
+  for (const auto& tx : txs) {
+    response.txs.push_back(asString(toBinaryArray(tx)));
+  }
+
+  for (const auto& transactionHash : arg.txs) {
+    addKnownTransaction(context, transactionHash);
+  }
+
+  if (!response.txs.empty()) {
+    post_notify<NOTIFY_NEW_TRANSACTIONS>(*m_p2p, response, context);
+  }
+
+  return 1;
+}
+
 int CryptoNoteProtocolHandler::handle_request_get_objects(int command, NOTIFY_REQUEST_GET_OBJECTS::request& arg, CryptoNoteConnectionContext& context) {
   logger(Logging::TRACE) << context << "NOTIFY_REQUEST_GET_OBJECTS";
   NOTIFY_RESPONSE_GET_OBJECTS::request rsp;
@@ -398,22 +863,69 @@ int CryptoNoteProtocolHandler::handle_response_get_objects(int command, NOTIFY_R
 }
 
 int CryptoNoteProtocolHandler::processObjects(CryptoNoteConnectionContext& context, const std::vector<block_complete_entry>& blocks) {
+  struct ParsedTransaction {
+    Transaction tx;
+    Crypto::Hash hash;
+    size_t blobSize;
+    bool parsed;
+  };
+
+  struct ParsedBlock {
+    Block block;
+    bool parsed;
+    std::vector<ParsedTransaction> transactions;
+  };
+
+  // Parsing and hashing don't depend on chain state, so the whole batch goes through the worker pool first
+  // and only the checks against the chain are left for the sequential loop below.
+  std::vector<ParsedBlock> parsedBlocks(blocks.size());
+  m_workerPool.forEach(blocks.size(), [&](size_t i) {
+    const block_complete_entry& block_entry = blocks[i];
+    ParsedBlock& parsedBlock = parsedBlocks[i];
+    parsedBlock.transactions.resize(block_entry.txs.size());
+    for (size_t j = 0; j < block_entry.txs.size(); ++j) {
+      ParsedTransaction& parsedTransaction = parsedBlock.transactions[j];
+      BinaryArray transactionBinary = asBinaryArray(block_entry.txs[j]);
+      Crypto::Hash prefixHash;
+      parsedTransaction.blobSize = transactionBinary.size();
+      parsedTransaction.parsed = transactionBinary.size() <= m_currency.maxTxSize() &&
+        parseAndValidateTransactionFromBinaryArray(transactionBinary, parsedTransaction.tx, parsedTransaction.hash, prefixHash);
+    }
+
+    BinaryArray blockBinary = asBinaryArray(block_entry.block);
+    parsedBlock.parsed = blockBinary.size() <= m_currency.maxBlockBlobSize() && fromBinaryArray(parsedBlock.block, blockBinary);
+  });
 
-  for (const block_complete_entry& block_entry : blocks) {
+  // proof of work doesn't depend on chain state either, the core computes it for the whole batch up front
+  std::vector<const Block*> parsedBlockPointers;
+  for (const ParsedBlock& parsedBlock : parsedBlocks) {
+    if (parsedBlock.parsed) {
+      parsedBlockPointers.push_back(&parsedBlock.block);
+    }
+  }
+
+  m_core.precomputeProofOfWork(parsedBlockPointers);
+
+  for (size_t i = 0; i < blocks.size(); ++i) {
     if (m_stop) {
       break;
     }
 
     //process transactions
-    for (auto& tx_blob : block_entry.txs) {
-      auto transactionBinary = asBinaryArray(tx_blob);
-      Crypto::Hash transactionHash = Crypto::cn_fast_hash(transactionBinary.data(), transactionBinary.size());
-      logger(DEBUGGING) << "transaction " << transactionHash << " came in processObjects";
+    for (size_t j = 0; j < parsedBlocks[i].transactions.size(); ++j) {
+      const ParsedTransaction& parsedTransaction = parsedBlocks[i].transactions[j];
       tx_verification_context tvc = boost::value_initialized<decltype(tvc)>();
-      m_core.handle_incoming_tx(transactionBinary, tvc, true);
+      if (parsedTransaction.parsed) {
+        logger(DEBUGGING) << "transaction " << parsedTransaction.hash << " came in processObjects";
+        m_core.handle_incoming_tx(parsedTransaction.tx, parsedTransaction.hash, parsedTransaction.blobSize, tvc, true);
+      } else {
+        logger(INFO) << "WRONG TRANSACTION BLOB, Failed to parse, rejected";
+        tvc.m_verification_failed = true;
+      }
+
       if (tvc.m_verification_failed) {
         logger(Logging::ERROR) << context << "transaction verification failed on NOTIFY_RESPONSE_GET_OBJECTS, \r\ntx_id = "
-          << Common::podToHex(getBinaryArrayHash(asBinaryArray(tx_blob))) << ", dropping connection";
+          << Common::podToHex(getBinaryArrayHash(asBinaryArray(blocks[i].txs[j]))) << ", dropping connection";
         context.m_state = CryptoNoteConnectionContext::state_shutdown;
         return 1;
       }
@@ -421,7 +933,12 @@ int CryptoNoteProtocolHandler::processObjects(CryptoNoteConnectionContext& conte
 
     // process block
     block_verification_context bvc = boost::value_initialized<block_verification_context>();
-    m_core.handle_incoming_block_blob(asBinaryArray(block_entry.block), bvc, false, false);
+    if (parsedBlocks[i].parsed) {
+      m_core.handle_incoming_block(parsedBlocks[i].block, bvc, false, false);
+    } else {
+      logger(INFO) << "Failed to parse and validate new block";
+      bvc.m_verification_failed = true;
+    }
 
     if (bvc.m_verification_failed) {
       logger(Logging::DEBUGGING) << context << "Block verification failed, dropping connection";
@@ -448,6 +965,13 @@ int CryptoNoteProtocolHandler::processObjects(CryptoNoteConnectionContext& conte
 
 
 bool CryptoNoteProtocolHandler::on_idle() {
+  auto now = std::chrono::steady_clock::now();
+  if (now >= m_nextTxAnnouncement) {
+    m_nextTxAnnouncement = now + std::chrono::seconds(P2P_TX_ANNOUNCE_INTERVAL);
+    announceTransactions();
+    retryTransactionRequests(now);
+  }
+
   return m_core.on_idle();
 }
 
@@ -594,6 +1118,7 @@ int CryptoNoteProtocolHandler::handleRequestTxPool(int command, NOTIFY_REQUEST_T
     NOTIFY_NEW_TRANSACTIONS::request notification;
     for (auto& tx : addedTransactions) {
       notification.txs.push_back(asString(toBinaryArray(tx)));
+      addKnownTransaction(context, getObjectHash(tx));
     }
 
     bool ok = post_notify<NOTIFY_NEW_TRANSACTIONS>(*m_p2p, notification, context);
@@ -607,13 +1132,21 @@ int CryptoNoteProtocolHandler::handleRequestTxPool(int command, NOTIFY_REQUEST_T
 
 
 void CryptoNoteProtocolHandler::relay_block(NOTIFY_NEW_BLOCK::request& arg) {
-  auto buf = LevinProtocol::encode(arg);
-  m_p2p->externalRelayNotifyToAll(NOTIFY_NEW_BLOCK::ID, buf);
+  // called from the core's threads, the connections are only touched by the dispatcher
+  m_dispatcher.remoteSpawn([this, arg]() mutable {
+    relayNewBlock(arg, std::vector<Crypto::Hash>(), nullptr);
+  });
 }
 
 void CryptoNoteProtocolHandler::relay_transactions(NOTIFY_NEW_TRANSACTIONS::request& arg) {
-  auto buf = LevinProtocol::encode(arg);
-  m_p2p->externalRelayNotifyToAll(NOTIFY_NEW_TRANSACTIONS::ID, buf);
+  m_dispatcher.remoteSpawn([this, arg]() mutable {
+    std::vector<Crypto::Hash> transactionHashes;
+    for (const auto& txBlob : arg.txs) {
+      transactionHashes.push_back(Crypto::cn_fast_hash(txBlob.data(), txBlob.size()));
+    }
+
+    relayTransactions(arg, transactionHashes, nullptr);
+  });
 }
 
 void CryptoNoteProtocolHandler::requestMissingPoolTransactions(const CryptoNoteConnectionContext& context) {
@@ -1,8 +1,14 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <ObserverManager.h>
+#include "common/WorkerPool.h"
 
 #include "ICore.h"
 
@@ -31,7 +37,7 @@ namespace CryptoNote
   {
   public:
 
-    CryptoNoteProtocolHandler(const Currency& currency, System::Dispatcher& dispatcher, ICore& rcore, IP2pEndpoint* p_net_layout, Logging::ILogger& log);
+    CryptoNoteProtocolHandler(const Currency& currency, System::Dispatcher& dispatcher, ICore& rcore, Tools::WorkerPool& workerPool, IP2pEndpoint* p_net_layout, Logging::ILogger& log);
 
     virtual bool addObserver(ICryptoNoteProtocolObserver* observer) override;
     virtual bool removeObserver(ICryptoNoteProtocolObserver* observer) override;
@@ -64,6 +70,11 @@ namespace CryptoNote
     int handle_request_chain(int command, NOTIFY_REQUEST_CHAIN::request& arg, CryptoNoteConnectionContext& context);
     int handle_response_chain_entry(int command, NOTIFY_RESPONSE_CHAIN_ENTRY::request& arg, CryptoNoteConnectionContext& context);
     int handleRequestTxPool(int command, NOTIFY_REQUEST_TX_POOL::request& arg, CryptoNoteConnectionContext& context);
+    int handle_notify_new_compact_block(int command, NOTIFY_NEW_COMPACT_BLOCK::request& arg, CryptoNoteConnectionContext& context);
+    int handle_request_block_txs(int command, NOTIFY_REQUEST_BLOCK_TXS::request& arg, CryptoNoteConnectionContext& context);
+    int handle_response_block_txs(int command, NOTIFY_RESPONSE_BLOCK_TXS::request& arg, CryptoNoteConnectionContext& context);
+    int handle_notify_tx_inventory(int command, NOTIFY_TX_INVENTORY::request& arg, CryptoNoteConnectionContext& context);
+    int handle_request_txs(int command, NOTIFY_REQUEST_TXS::request& arg, CryptoNoteConnectionContext& context);
 
     //----------------- i_cryptonote_protocol ----------------------------------
     virtual void relay_block(NOTIFY_NEW_BLOCK::request& arg) override;
@@ -76,6 +87,18 @@ namespace CryptoNote
     void updateObservedHeight(uint32_t peerHeight, const CryptoNoteConnectionContext& context);
     void recalculateMaxObservedHeight(const CryptoNoteConnectionContext& context);
     int processObjects(CryptoNoteConnectionContext& context, const std::vector<block_complete_entry>& blocks);
+    void processNewBlock(NOTIFY_NEW_BLOCK::request& arg, const std::vector<Crypto::Hash>& transactionHashes, CryptoNoteConnectionContext& context);
+    // V2 peers get NOTIFY_NEW_COMPACT_BLOCK. arg.b.txs can be left empty if transactionHashes are given, the
+    // transactions are loaded only when an older peer needs them.
+    void relayNewBlock(NOTIFY_NEW_BLOCK::request& arg, const std::vector<Crypto::Hash>& transactionHashes, const net_connection_id* excludeConnection);
+    // V3 peers get the hashes with the next NOTIFY_TX_INVENTORY, older peers the transactions right away
+    void relayTransactions(NOTIFY_NEW_TRANSACTIONS::request& arg, const std::vector<Crypto::Hash>& transactionHashes, const net_connection_id* excludeConnection);
+    void announceTransactions();
+    // Asks timed out requests from the next announcer and deferred ones from announcers with room for them.
+    void retryTransactionRequests(std::chrono::steady_clock::time_point now);
+    void eraseTransactionRequest(const Crypto::Hash& transactionHash);
+    void removeTransactionAnnouncer(const net_connection_id& connectionId);
+    void addRejectedTransaction(const Crypto::Hash& transactionHash);
     Logging::LoggerRef logger;
 
   private:
@@ -93,5 +116,25 @@ namespace CryptoNote
 
     std::atomic<size_t> m_peersCount;
     Tools::ObserverManager<ICryptoNoteProtocolObserver> m_observerManager;
+    Tools::WorkerPool& m_workerPool; // parses downloaded block batches, shared with the core
+
+    struct TransactionRequest {
+      std::chrono::steady_clock::time_point time; // when the first announcer was asked
+      std::deque<net_connection_id> announcers; // the first one is asked next or has been asked
+      bool requested;
+    };
+
+    struct TransactionAnnouncer {
+      size_t pending; // requests the peer is an announcer of
+      size_t inFlight; // requests asked from the peer
+    };
+
+    // announced transactions being fetched and the peers they were announced by, the dispatcher's thread only
+    std::unordered_map<Crypto::Hash, TransactionRequest> m_transactionRequests;
+    std::map<net_connection_id, TransactionAnnouncer> m_transactionAnnouncers;
+    // recently rejected by the pool, announcements of them are ignored; the oldest are forgotten first
+    std::unordered_set<Crypto::Hash> m_rejectedTransactions;
+    std::deque<Crypto::Hash> m_rejectedTransactionsOrder;
+    std::chrono::steady_clock::time_point m_nextTxAnnouncement;
   };
 }
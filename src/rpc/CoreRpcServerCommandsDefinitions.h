@@ -256,6 +256,10 @@ struct COMMAND_RPC_GET_INFO {
     uint64_t difficulty;
     uint64_t tx_count;
     uint64_t tx_pool_size;
+    uint64_t tx_pool_bytes;
+    uint64_t tx_pool_max_bytes;
+    uint64_t tx_pool_min_fee_rate;
+    uint64_t tx_pool_evicted_count;
     uint64_t alt_blocks_count;
     uint64_t outgoing_connections_count;
     uint64_t incoming_connections_count;
@@ -273,6 +277,10 @@ struct COMMAND_RPC_GET_INFO {
       KV_MEMBER(difficulty)
       KV_MEMBER(tx_count)
       KV_MEMBER(tx_pool_size)
+      KV_MEMBER(tx_pool_bytes)
+      KV_MEMBER(tx_pool_max_bytes)
+      KV_MEMBER(tx_pool_min_fee_rate)
+      KV_MEMBER(tx_pool_evicted_count)
       KV_MEMBER(alt_blocks_count)
       KV_MEMBER(outgoing_connections_count)
       KV_MEMBER(incoming_connections_count)
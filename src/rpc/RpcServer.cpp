@@ -214,16 +214,18 @@ bool RpcServer::on_get_blocks(const COMMAND_RPC_GET_BLOCKS_FAST::request& req, C
   res.start_height = startBlockIndex;
 
   for (const auto& blockId : supplement) {
-    assert(m_core.have_block(blockId));
-    auto completeBlock = m_core.getBlock(blockId);
-    assert(completeBlock != nullptr);
+    RawBlock rawBlock;
+    if (!m_core.getRawBlock(blockId, rawBlock)) {
+      res.status = "Failed";
+      return false;
+    }
 
     res.blocks.resize(res.blocks.size() + 1);
-    res.blocks.back().block = asString(toBinaryArray(completeBlock->getBlock()));
+    res.blocks.back().block = asString(rawBlock.block);
 
-    res.blocks.back().txs.reserve(completeBlock->getTransactionCount());
-    for (size_t i = 0; i < completeBlock->getTransactionCount(); ++i) {
-      res.blocks.back().txs.push_back(asString(toBinaryArray(completeBlock->getTransaction(i))));
+    res.blocks.back().txs.reserve(rawBlock.transactions.size());
+    for (const auto& tx : rawBlock.transactions) {
+      res.blocks.back().txs.push_back(asString(tx));
     }
   }
 
@@ -338,7 +340,12 @@ bool RpcServer::on_get_info(const COMMAND_RPC_GET_INFO::request& req, COMMAND_RP
   res.height = m_core.get_current_blockchain_height();
   res.difficulty = m_core.getNextBlockDifficulty();
   res.tx_count = m_core.get_blockchain_total_transactions() - res.height; //without coinbase
-  res.tx_pool_size = m_core.get_pool_transactions_count();
+  tx_memory_pool::PoolStatistics poolStatistics = m_core.getPoolStatistics();
+  res.tx_pool_size = poolStatistics.transactionCount;
+  res.tx_pool_bytes = poolStatistics.bytes;
+  res.tx_pool_max_bytes = poolStatistics.maxBytes;
+  res.tx_pool_min_fee_rate = poolStatistics.minimumFeeRate;
+  res.tx_pool_evicted_count = poolStatistics.evictedTransactions;
   res.alt_blocks_count = m_core.get_alternative_blocks_count();
   uint64_t total_conn = m_p2p.get_connections_count();
   res.outgoing_connections_count = m_p2p.get_outgoing_connections_count();